@@ -0,0 +1,165 @@
+/*******************************
+ *  audit_log.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "audit_log.h"
+#include "external_eeprom.h"
+#include "systick.h"
+#include "link.h"
+#include <string.h>
+
+#define RECORDS_PER_PAGE   (EEPROM_PAGE_SIZE/AUDIT_RECORD_SIZE)
+#define RING_MASK          (AUDIT_LOG_RECORDS-1)
+
+/* Event byte of a record never written */
+#define EVENT_ERASED       0xFF
+
+/*
+ * Ring index I is staged in g_staging[I%AUDIT_STAGING_RECORDS]. The ring size
+ * is a multiple of the staging size, so the records of one EEPROM page are
+ * also next to each other in SRAM and can be written with one transaction.
+ */
+static AuditLog_RecordType g_staging[AUDIT_STAGING_RECORDS];
+static TWI_TransactionType g_transaction;
+
+static uint8 g_head=0;                 /* Ring index of the next record */
+static volatile uint8 g_flushed=0;     /* Ring index of the first record not in the EEPROM yet */
+static volatile uint8 g_writing=0;     /* Number of records in the running page write */
+static uint16 g_seq=0;
+static uint8 g_boot=0;
+static uint32 g_pending_since=0;
+static uint16 g_dropped=0;
+
+static uint16 AuditLog_address(uint8 index){
+	return EEPROM_AUDIT_LOG_ADDRESS+(uint16)index*AUDIT_RECORD_SIZE;
+}
+
+static uint8 AuditLog_pending(void){
+	return (uint8)(g_head-g_flushed)&RING_MASK;
+}
+
+/* Called from the TWI interrupt when the page write is done */
+static void AuditLog_flushDone(TWI_TransactionType *Transaction_Ptr){
+	if(Transaction_Ptr->status==TWI_DONE){
+		g_flushed=(g_flushed+g_writing)&RING_MASK;
+	}
+	/* On failure the same records are written again by the next AuditLog_service */
+	g_writing=0;
+}
+
+void AuditLog_init(void){
+	AuditLog_RecordType page[RECORDS_PER_PAGE];
+	uint16 newest_seq=0;
+	boolean found=FALSE;
+	uint8 i;
+	uint8 j;
+
+	g_head=0;
+	for(i=0;i<AUDIT_LOG_RECORDS;i+=RECORDS_PER_PAGE){
+		if(EEPROM_readBlock(AuditLog_address(i),(uint8*)page,EEPROM_PAGE_SIZE)==ERROR){
+			continue;
+		}
+		for(j=0;j<RECORDS_PER_PAGE;j++){
+			if(page[j].event==EVENT_ERASED){
+				continue;
+			}
+			/* Sequence numbers are compared as a distance so they may wrap around */
+			if(!found||(sint16)(page[j].seq-newest_seq)>0){
+				found=TRUE;
+				newest_seq=page[j].seq;
+				g_boot=page[j].boot+1;
+				g_head=(i+j+1)&RING_MASK;
+			}
+		}
+	}
+	g_seq=found?newest_seq+1:0;
+	g_flushed=g_head;
+
+	AuditLog_log(AUDIT_EVENT_BOOT,AUDIT_RESULT_GRANTED,AUDIT_SLOT_NONE);
+}
+
+void AuditLog_log(AuditLog_EventType event,AuditLog_ResultType result,uint8 slot){
+	AuditLog_RecordType *record;
+	uint32 now=SysTick_getMillis();
+	uint32 seconds=now/1000;
+	uint8 pending=AuditLog_pending();
+
+	if(pending==AUDIT_STAGING_RECORDS){
+		g_dropped++;
+		return;
+	}
+	if(pending==0){
+		g_pending_since=now;
+	}
+
+	record=&g_staging[g_head%AUDIT_STAGING_RECORDS];
+	record->seq=g_seq++;
+	record->boot=g_boot;
+	record->time[0]=(uint8)seconds;
+	record->time[1]=(uint8)(seconds>>8);
+	record->time[2]=(uint8)(seconds>>16);
+	record->event=(uint8)((event<<4)|result);
+	record->slot=slot;
+	g_head=(g_head+1)&RING_MASK;
+}
+
+void AuditLog_service(void){
+	uint8 first;
+	uint8 count;
+	uint8 room;
+
+	TWI_service();
+	if(g_writing!=0){
+		return;
+	}
+
+	first=g_flushed;
+	count=AuditLog_pending();
+	if(count==0){
+		return;
+	}
+
+	/* Only the records that fall in the page of the first pending one */
+	room=RECORDS_PER_PAGE-(first%RECORDS_PER_PAGE);
+	if(count>room){
+		count=room;
+	}
+	if(count<room&&SysTick_elapsedSince(g_pending_since)<AUDIT_FLUSH_DELAY_MS){
+		return;
+	}
+
+	g_writing=count;
+	if(EEPROM_writePageAsync(&g_transaction,AuditLog_address(first),
+			(const uint8*)&g_staging[first%AUDIT_STAGING_RECORDS],count*AUDIT_RECORD_SIZE,
+			&AuditLog_flushDone)==ERROR){
+		g_writing=0;
+		return;
+	}
+	/* Records left behind in the next page start their own delay */
+	g_pending_since=SysTick_getMillis();
+}
+
+void AuditLog_dump(void){
+	AuditLog_RecordType record;
+	uint8 index=g_head;
+	uint8 i;
+
+	/* The ring starts with the oldest record, the staged ones are the newest */
+	for(i=0;i<AUDIT_LOG_RECORDS;i++){
+		if(((uint8)(index-g_flushed)&RING_MASK)<AuditLog_pending()){
+			record=g_staging[index%AUDIT_STAGING_RECORDS];
+		}
+		else if(EEPROM_readBlock(AuditLog_address(index),(uint8*)&record,AUDIT_RECORD_SIZE)==ERROR){
+			record.event=EVENT_ERASED;
+		}
+		if(record.event!=EVENT_ERASED){
+			LINK_sendFrame(LINK_DIAG_AUDIT_LOG,(const uint8*)&record,AUDIT_RECORD_SIZE);
+		}
+		index=(index+1)&RING_MASK;
+	}
+	LINK_sendFrame(LINK_DIAG_AUDIT_LOG,(const uint8*)&g_dropped,sizeof(g_dropped));
+}
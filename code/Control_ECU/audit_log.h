@@ -0,0 +1,90 @@
+/*******************************
+ *  audit_log.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef AUDIT_LOG_H_
+#define AUDIT_LOG_H_
+
+#include "std_types.h"
+#include "eeprom_map.h"
+
+/* Size of one record in the EEPROM, two records fill a page */
+#define AUDIT_RECORD_SIZE          8
+
+/* Number of records in the EEPROM ring, the oldest one is overwritten first */
+#define AUDIT_LOG_RECORDS          (EEPROM_AUDIT_LOG_SIZE/AUDIT_RECORD_SIZE)
+
+/* Records kept in SRAM until written, two pages: one being written, one being filled */
+#define AUDIT_STAGING_RECORDS      4
+
+/* A page that is not full is written anyway once its first record is this old */
+#define AUDIT_FLUSH_DELAY_MS       5000
+
+/* User slot of an event not tied to a user table entry */
+#define AUDIT_SLOT_NONE            0xFF
+
+/* User slot of an event authenticated with the system password */
+#define AUDIT_SLOT_SYSTEM          0xFE
+
+typedef enum {
+	AUDIT_EVENT_BOOT,           /* CONTROL_ECU started */
+	AUDIT_EVENT_UNLOCK,         /* Password entered to open the door */
+	AUDIT_EVENT_ADMIN_AUTH,     /* Password entered to change the system password */
+	AUDIT_EVENT_PASSWORD_SET,   /* New system password entered twice */
+	AUDIT_EVENT_LOCKOUT,        /* Too many wrong passwords, alarm started */
+	AUDIT_EVENT_PROVISION       /* Maintenance tool changed the users or door profiles */
+}AuditLog_EventType;
+
+typedef enum {
+	AUDIT_RESULT_DENIED,
+	AUDIT_RESULT_GRANTED
+}AuditLog_ResultType;
+
+/*
+ * One logged event, stored as is in the EEPROM and in the dump frames
+ * (multi-byte fields little endian).
+ */
+typedef struct {
+	uint16 seq;        /* Increments with every record, finds the newest record at boot */
+	uint8 boot;        /* Increments with every boot, the time restarts at 0 */
+	uint8 time[3];     /* Seconds since boot */
+	uint8 event;       /* AuditLog_EventType in the high nibble, AuditLog_ResultType in the low nibble */
+	uint8 slot;        /* User table slot, AUDIT_SLOT_SYSTEM or AUDIT_SLOT_NONE */
+} AuditLog_RecordType;
+
+/*
+ * Description:
+ * Find the newest record in the EEPROM ring, continue after it and log
+ * an AUDIT_EVENT_BOOT record. Must run after SysTick_init and TWI_init.
+ */
+void AuditLog_init(void);
+
+/*
+ * Description:
+ * Add an event to the SRAM staging buffer. No bus traffic is started, so it
+ * can be called in the middle of time critical paths. The event is dropped
+ * (and counted) if the staging buffer is full.
+ */
+void AuditLog_log(AuditLog_EventType event,AuditLog_ResultType result,uint8 slot);
+
+/*
+ * Description:
+ * Start writing the staged page to the EEPROM if it is full or old enough.
+ * The write runs in the background on the TWI engine. Call it from the
+ * main loop at points where a busy bus does not delay anything.
+ */
+void AuditLog_service(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_AUDIT_LOG: send every record, oldest
+ * first, one frame each, then an end frame holding the number of dropped
+ * events (uint16).
+ */
+void AuditLog_dump(void);
+
+#endif /* AUDIT_LOG_H_ */
@@ -0,0 +1,146 @@
+/*******************************
+ *  blake2s.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "blake2s.h"
+#include <avr/pgmspace.h>
+#include <string.h>
+
+/*
+ * The AVR has no barrel shifter and avr-gcc rotates a 32-bit word one bit
+ * per loop pass, so the rotations of G are built from byte moves (free, the
+ * compiler just renames registers) plus at most four single-bit shifts.
+ * AVR is little endian like BLAKE2s, message words are loaded with memcpy.
+ */
+
+typedef union {
+	uint32 word;
+	uint8 bytes[4];
+} Blake2s_WordType;
+
+static const uint32 g_iv[8]={
+	0x6A09E667UL,0xBB67AE85UL,0x3C6EF372UL,0xA54FF53AUL,
+	0x510E527FUL,0x9B05688CUL,0x1F83D9ABUL,0x5BE0CD19UL
+};
+
+/* Message word schedule, kept in flash: 160 bytes are too many for the SRAM */
+static const uint8 g_sigma[10][16] PROGMEM={
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15},
+	{14,10, 4, 8, 9,15,13, 6, 1,12, 0, 2,11, 7, 5, 3},
+	{11, 8,12, 0, 5, 2,15,13,10,14, 3, 6, 7, 1, 9, 4},
+	{ 7, 9, 3, 1,13,12,11,14, 2, 6, 5,10, 4, 0,15, 8},
+	{ 9, 0, 5, 7, 2, 4,10,15,14, 1,11,12, 6, 8, 3,13},
+	{ 2,12, 6,10, 0,11, 8, 3, 4,13, 7, 5,15,14, 1, 9},
+	{12, 5, 1,15,14,13, 4,10, 0, 7, 6, 3, 9, 2, 8,11},
+	{13,11, 7,14,12, 1, 3, 9, 5, 0,15, 4, 8, 6, 2,10},
+	{ 6,15,14, 9,11, 3, 0, 8,12, 2,13, 7, 1, 4,10, 5},
+	{10, 2, 8, 4, 7, 6, 1, 5,15,11, 9,14, 3,12,13, 0}
+};
+
+static inline uint32 Blake2s_rotr16(uint32 x){
+	return (x>>16)|(x<<16);
+}
+
+static inline uint32 Blake2s_rotr8(uint32 x){
+	Blake2s_WordType in;
+	Blake2s_WordType out;
+	in.word=x;
+	out.bytes[0]=in.bytes[1];
+	out.bytes[1]=in.bytes[2];
+	out.bytes[2]=in.bytes[3];
+	out.bytes[3]=in.bytes[0];
+	return out.word;
+}
+
+/* Rotate right by 8, then 4 more single-bit steps */
+static inline uint32 Blake2s_rotr12(uint32 x){
+	x=Blake2s_rotr8(x);
+	return (x>>4)|(x<<28);
+}
+
+/* Rotate right by 8, then back left by one */
+static inline uint32 Blake2s_rotr7(uint32 x){
+	x=Blake2s_rotr8(x);
+	return (x<<1)|(x>>31);
+}
+
+#define BLAKE2S_G(A,B,C,D,X,Y) \
+	do{ \
+		v[A]+=v[B]+(X); v[D]=Blake2s_rotr16(v[D]^v[A]); \
+		v[C]+=v[D];     v[B]=Blake2s_rotr12(v[B]^v[C]); \
+		v[A]+=v[B]+(Y); v[D]=Blake2s_rotr8(v[D]^v[A]); \
+		v[C]+=v[D];     v[B]=Blake2s_rotr7(v[B]^v[C]); \
+	}while(0)
+
+static void Blake2s_compress(uint32 *h,const uint8 *block,uint32 counter,boolean last){
+	uint32 v[16];
+	uint32 m[16];
+	uint8 s[16];
+	uint8 round;
+	uint8 i;
+
+	memcpy(m,block,BLAKE2S_BLOCK_SIZE);
+	for(i=0;i<8;i++){
+		v[i]=h[i];
+		v[i+8]=g_iv[i];
+	}
+	v[12]^=counter;
+	if(last){
+		v[14]=~v[14];
+	}
+
+	/* The G steps of a round are unrolled, unrolling all ten rounds would not fit in the flash */
+	for(round=0;round<10;round++){
+		memcpy_P(s,g_sigma[round],sizeof(s));
+		BLAKE2S_G(0,4, 8,12,m[s[ 0]],m[s[ 1]]);
+		BLAKE2S_G(1,5, 9,13,m[s[ 2]],m[s[ 3]]);
+		BLAKE2S_G(2,6,10,14,m[s[ 4]],m[s[ 5]]);
+		BLAKE2S_G(3,7,11,15,m[s[ 6]],m[s[ 7]]);
+		BLAKE2S_G(0,5,10,15,m[s[ 8]],m[s[ 9]]);
+		BLAKE2S_G(1,6,11,12,m[s[10]],m[s[11]]);
+		BLAKE2S_G(2,7, 8,13,m[s[12]],m[s[13]]);
+		BLAKE2S_G(3,4, 9,14,m[s[14]],m[s[15]]);
+	}
+
+	for(i=0;i<8;i++){
+		h[i]^=v[i]^v[i+8];
+	}
+}
+
+void Blake2s_hash(uint8 *digest,uint8 digest_size,const uint8 *salt,uint8 salt_size,
+		const uint8 *data,uint16 length){
+	uint32 h[8];
+	uint8 block[BLAKE2S_BLOCK_SIZE];
+	uint32 counter=0;
+	uint8 i;
+
+	for(i=0;i<8;i++){
+		h[i]=g_iv[i];
+	}
+	/* Parameter block: digest length, key length 0, fanout 1, depth 1, salt */
+	h[0]^=0x01010000UL|digest_size;
+	if(salt_size!=0){
+		memset(block,0,BLAKE2S_SALT_SIZE);
+		memcpy(block,salt,salt_size>BLAKE2S_SALT_SIZE?BLAKE2S_SALT_SIZE:salt_size);
+		for(i=0;i<BLAKE2S_SALT_SIZE;i++){
+			((uint8*)&h[4])[i]^=block[i];
+		}
+	}
+
+	while(length>BLAKE2S_BLOCK_SIZE){
+		counter+=BLAKE2S_BLOCK_SIZE;
+		Blake2s_compress(h,data,counter,FALSE);
+		data+=BLAKE2S_BLOCK_SIZE;
+		length-=BLAKE2S_BLOCK_SIZE;
+	}
+	memset(block,0,BLAKE2S_BLOCK_SIZE);
+	memcpy(block,data,length);
+	counter+=length;
+	Blake2s_compress(h,block,counter,TRUE);
+
+	memcpy(digest,h,digest_size);
+}
@@ -0,0 +1,32 @@
+/*******************************
+ *  blake2s.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef BLAKE2S_H_
+#define BLAKE2S_H_
+
+#include "std_types.h"
+
+#define BLAKE2S_BLOCK_SIZE      64
+#define BLAKE2S_MAX_DIGEST_SIZE 32
+#define BLAKE2S_SALT_SIZE       8
+
+/*
+ * Description:
+ * Compute the BLAKE2s (RFC 7693) digest of a buffer, unkeyed, with the
+ * digest length and salt of the parameter block set as given.
+ *
+ * Parameters:
+ *  - digest: Receives digest_size bytes.
+ *  - digest_size: 1 to BLAKE2S_MAX_DIGEST_SIZE.
+ *  - salt: Up to BLAKE2S_SALT_SIZE bytes, padded with zeros. May be NULL_PTR if salt_size is 0.
+ *  - data, length: The message.
+ */
+void Blake2s_hash(uint8 *digest,uint8 digest_size,const uint8 *salt,uint8 salt_size,
+		const uint8 *data,uint16 length);
+
+#endif /* BLAKE2S_H_ */
@@ -0,0 +1,59 @@
+/*******************************
+ *  boot_profile.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef BOOT_PROFILE_H_
+#define BOOT_PROFILE_H_
+
+#include "std_types.h"
+
+/* Marks kept for one boot, later ones are dropped */
+#define BOOT_PROFILE_MAX_MARKS  8
+
+/* "No mark" value of the aborted mark field */
+#define BOOT_PROFILE_NONE       0xFF
+
+/* Points of the CONTROL_ECU boot, in order */
+typedef enum {
+	BOOT_MARK_MAIN,          /* SysTick running, top of main */
+	BOOT_MARK_STORE,         /* Key-value store scanned */
+	BOOT_MARK_CREDENTIALS,   /* Door profile, credential cache and user table loaded */
+	BOOT_MARK_AUDIT,         /* Audit log ring scanned */
+	BOOT_MARK_LINK,          /* UART up, reset sent to the HMI */
+	BOOT_MARK_READY          /* Handshake done, first step sent to the HMI */
+}BootProfile_MarkIdType;
+
+/*
+ * Description:
+ * Start recording the marks of this boot and record BOOT_MARK_MAIN.
+ * Must run right after SysTick_init. The buffer is in .noinit: if the
+ * previous boot was cut before BootProfile_end, its last mark is kept
+ * and reported by the dump.
+ */
+void BootProfile_start(void);
+
+/*
+ * Description:
+ * Record a mark with the current SysTick_getMicros() time.
+ */
+void BootProfile_mark(BootProfile_MarkIdType id);
+
+/*
+ * Description:
+ * Record the last mark of the boot, later calls do nothing.
+ */
+void BootProfile_end(BootProfile_MarkIdType id);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_BOOT_PROFILE: send one frame holding the
+ * last mark of an aborted previous boot (or BOOT_PROFILE_NONE), the number of
+ * marks, then every mark as its id and its time in microseconds (uint32).
+ */
+void BootProfile_dump(void);
+
+#endif /* BOOT_PROFILE_H_ */
@@ -0,0 +1,59 @@
+/*******************************
+ *  breadcrumb.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "breadcrumb.h"
+#include "crc.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/* Marks a record written by Breadcrumb_save, anything else is power-up garbage */
+#define BREADCRUMB_MAGIC  0xC4B5
+
+typedef struct {
+	uint16 magic;
+	Breadcrumb_StateType state;
+	uint16 crc;
+} Breadcrumb_RecordType;
+
+/* Not cleared by the C startup code, so it survives a reset */
+static Breadcrumb_RecordType g_record __attribute__((section(".noinit")));
+
+static uint8 g_reset_cause=0;
+
+/* CRC of the magic and the state, the CRC field itself excluded */
+static uint16 Breadcrumb_crc(void){
+	return CRC16_compute((const uint8*)&g_record,sizeof(g_record)-sizeof(g_record.crc));
+}
+
+uint8 Breadcrumb_init(Breadcrumb_StateType *State_Ptr){
+	g_reset_cause=MCUCSR&(BREADCRUMB_RESET_POWER_ON|BREADCRUMB_RESET_EXTERNAL
+			|BREADCRUMB_RESET_BROWN_OUT|BREADCRUMB_RESET_WATCHDOG|BREADCRUMB_RESET_JTAG);
+	MCUCSR&=~g_reset_cause;
+
+	/* The SRAM content is undefined after power-on, even if the CRC happens to match */
+	if((g_reset_cause&BREADCRUMB_RESET_POWER_ON)
+			||g_record.magic!=BREADCRUMB_MAGIC||g_record.crc!=Breadcrumb_crc()){
+		return ERROR;
+	}
+	*State_Ptr=g_record.state;
+	return SUCCESS;
+}
+
+void Breadcrumb_save(const Breadcrumb_StateType *State_Ptr){
+	uint8 sreg=SREG;
+
+	cli();
+	g_record.magic=BREADCRUMB_MAGIC;
+	g_record.state=*State_Ptr;
+	g_record.crc=Breadcrumb_crc();
+	SREG=sreg;
+}
+
+uint8 Breadcrumb_getResetCause(void){
+	return g_reset_cause;
+}
@@ -0,0 +1,60 @@
+/*******************************
+ *  breadcrumb.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef BREADCRUMB_H_
+#define BREADCRUMB_H_
+
+#include "std_types.h"
+
+/* Operation running when the breadcrumb was saved */
+typedef enum {
+	BREADCRUMB_PHASE_IDLE,       /* Waiting for the HMI, nothing to resume */
+	BREADCRUMB_PHASE_DOOR,       /* Door cycle: segment index and ticks left in it */
+	BREADCRUMB_PHASE_LOCKOUT     /* Alarm: ticks left */
+}Breadcrumb_PhaseType;
+
+typedef struct {
+	uint8 step;          /* Step of the main state machine */
+	uint8 phase;         /* Breadcrumb_PhaseType */
+	uint8 segment;       /* Door segment, 0 for the other phases */
+	uint8 remaining;     /* Ticks left in the segment or in the alarm */
+} Breadcrumb_StateType;
+
+/* Reset cause bits, as found in MCUCSR */
+#define BREADCRUMB_RESET_POWER_ON   0x01
+#define BREADCRUMB_RESET_EXTERNAL   0x02
+#define BREADCRUMB_RESET_BROWN_OUT  0x04
+#define BREADCRUMB_RESET_WATCHDOG   0x08
+#define BREADCRUMB_RESET_JTAG       0x10
+
+/*
+ * Description:
+ * Capture and clear the reset cause flags of MCUCSR, then check the
+ * breadcrumb left in .noinit by the previous run. Must run first in main.
+ *
+ * Returns:
+ *  - SUCCESS with the previous state copied to State_Ptr, or ERROR after a
+ *    power-on reset or if the magic or the CRC do not match.
+ */
+uint8 Breadcrumb_init(Breadcrumb_StateType *State_Ptr);
+
+/*
+ * Description:
+ * Save the state so that it survives a reset. Safe from an ISR, interrupts
+ * are held off so a reset can only hit a half written record, which the
+ * CRC then rejects.
+ */
+void Breadcrumb_save(const Breadcrumb_StateType *State_Ptr);
+
+/*
+ * Description:
+ * Return the reset cause bits captured by Breadcrumb_init.
+ */
+uint8 Breadcrumb_getResetCause(void);
+
+#endif /* BREADCRUMB_H_ */
@@ -12,69 +12,323 @@
 #include"twi.h"
 #include"external_eeprom.h"
 #include<avr/io.h>
+#include<avr/interrupt.h>
 #include<util/delay.h>
 #include"timer1.h"
+#include"door_sequencer.h"
+#include"eeprom_map.h"
+#include"systick.h"
+#include"credential_cache.h"
+#include"credential_store.h"
+#include"kv_store.h"
+#include"link.h"
+#include"audit_log.h"
+#include"seclink.h"
+#include"boot_profile.h"
+#include"breadcrumb.h"
+#include"supervisor.h"
+#include"power.h"
+#include"profiler.h"
+#include"trace.h"
+#include"log.h"
+#include"ram_usage.h"
+#include"latency.h"
+#include"metrics.h"
 
 #define CONTROL_ECU_READY 0x10
-#define PASSWORD_LENGTH 5
+#define PASSWORD_LENGTH CRED_PASSWORD_LENGTH
 #define HMI_ECU_READY 0x11
 #define OPEN_GATE 0x15
+#define DOOR_SEGMENT 0x16
+
+/* door_reported when no door cycle started from the HMI is being followed */
+#define DOOR_NOT_REPORTED 0xFF
 
 uint8 tick=0;
+uint8 lockout_ticks=CRED_DEFAULT_LOCKOUT_TICKS;
 uint8 step=1;
 
+/* Last segment of the door cycle reported to the HMI */
+uint8 door_reported=DOOR_NOT_REPORTED;
+
+/* Wrong system passwords in provisioning requests since reset */
+uint8 provision_failures=0;
+
+/* Time from reset to the first step sent to the HMI, 0 until then */
+uint32 ready_millis=0;
+uint8 ready_step;
+
+/* State left by the run before the last reset, phase IDLE if none */
+Breadcrumb_StateType resumed={1,BREADCRUMB_PHASE_IDLE,0,0};
+
+/* Keep the current step and operation in the reset breadcrumb */
+void remember(uint8 phase,uint8 segment,uint8 remaining){
+	Breadcrumb_StateType crumb;
+	crumb.step=step;
+	crumb.phase=phase;
+	crumb.segment=segment;
+	crumb.remaining=remaining;
+	Breadcrumb_save(&crumb);
+	TRACE(TRACE_STEP,((uint16)step<<8)|phase);
+}
 
 
-uint8 read_password(){
+/*
+ * Receive a password from the HMI and check it. The system password is
+ * accepted for any role, otherwise the user table is searched and the user
+ * must have at least required_role. The slot of the user (AUDIT_SLOT_SYSTEM
+ * for the system password, AUDIT_SLOT_NONE if unknown) goes to slot.
+ */
+uint8 read_password(CredStore_RoleType required_role,uint8 *slot){
 	uint8 i;
 	uint8 password_retrival[PASSWORD_LENGTH];
-	uint8 val;
-	uint8 password_correct=1;
 //	while(UART_receiveByte()!=HMI_ECU_READY);
 	for(i=0;i<PASSWORD_LENGTH;i++){
-		password_retrival[i]=UART_receiveByte();
+		password_retrival[i]=SecLink_receiveByte();
 		}
+	Latency_mark(LATENCY_PASSWORD_RECEIVED);
+	Latency_setKey((uint16)SecLink_getReceivedCount());
 //	UART_sendByte(CONTROL_ECU_READY);
 
-	for(i=0;i<PASSWORD_LENGTH;i++){
-	EEPROM_readByte(0x0310+i,&val);
-	if(val!=password_retrival[i]){
-	password_correct=0;
-	break;
+	/* Hashed and compared against the SRAM copy of the credential record, no bus traffic */
+	if(CredCache_verify(password_retrival)){
+		*slot=AUDIT_SLOT_SYSTEM;
+		return 1;
 	}
+	return CredStore_verify(password_retrival,required_role,slot);
 }
 
-	return password_correct;
+/*
+ * Send the timing of the active door profile to the HMI right after OPEN_GATE:
+ * the segment count, then the direction and duration (in ticks) of every segment.
+ */
+void send_door_profile(void){
+	uint8 i;
+	uint8 message[1+2*DOOR_MAX_SEGMENTS];
+	const DoorSeq_ProfileType* profile=DoorSeq_getActiveProfile();
+	message[0]=profile->segment_count;
+	for(i=0;i<profile->segment_count;i++){
+		message[1+2*i]=profile->segments[i].direction;
+		message[2+2*i]=profile->segments[i].duration;
+	}
+	/* One secure link frame for the whole profile */
+	SecLink_send(message,1+2*profile->segment_count);
 }
 
-void rotate_motor_open_door(){
-	tick++;
-	if(tick==15){
-		TCNT1=0;
-		DcMotor_Rotate(STOP);
+/*
+ * Tell the HMI when the door cycle it shows moves on to another segment:
+ * DOOR_SEGMENT and the index of the new segment, the segment count once
+ * the cycle is over. A segment ended early by its end pin is reported as
+ * soon as the main loop sees it, the HMI does not count the ticks itself.
+ */
+void report_door_progress(void){
+	uint8 message[2];
+	uint8 remaining;
+	if(door_reported==DOOR_NOT_REPORTED){
+		return;
 	}
-	else if(tick==18){
-		TCNT1=0;
-		DcMotor_Rotate(A_CW);
+	/* The segment index reaches the segment count when the cycle ends */
+	DoorSeq_getProgress(&message[1],&remaining);
+	if(message[1]!=door_reported){
+		message[0]=DOOR_SEGMENT;
+		SecLink_send(message,sizeof(message));
+		door_reported=(message[1]<DoorSeq_getActiveProfile()->segment_count)?message[1]:DOOR_NOT_REPORTED;
+	}
+}
 
+/* Called by the sequencer once the last segment of the door cycle is done */
+void door_cycle_done(void){
+	step=2;
+	Timer1_deInit();
+	Supervisor_stop(SUPERVISOR_TASK_MOTION);
+	remember(BREADCRUMB_PHASE_IDLE,0,0);
+}
+
+/* Timer1 callback of the door cycle, the progress is saved every tick */
+void door_tick(void){
+	uint8 segment;
+	uint8 remaining;
+	Supervisor_checkIn(SUPERVISOR_TASK_MOTION);
+	DoorSeq_tick();
+	if(DoorSeq_isRunning()){
+		DoorSeq_getProgress(&segment,&remaining);
+		remember(BREADCRUMB_PHASE_DOOR,segment,remaining);
 	}
-	else if(tick==33){
-		step=2;
-		DcMotor_Rotate(STOP);
-		tick=0;
-		Timer1_deInit();
+}
+
+/*
+ * End pin check of the door cycle between two ticks, so a limit switch
+ * stops its segment within a main loop pass instead of a Timer1 period.
+ * Interrupts are off: door_tick changes the same state.
+ */
+void door_poll(void){
+	uint8 segment;
+	uint8 remaining;
+	uint8 sreg=SREG;
+	cli();
+	if(DoorSeq_poll()&&DoorSeq_isRunning()){
+		DoorSeq_getProgress(&segment,&remaining);
+		remember(BREADCRUMB_PHASE_DOOR,segment,remaining);
+	}
+	SREG=sreg;
+}
+
+/*
+ * Idle work while waiting for the HMI. Audit records are only written from
+ * the menu, so a page write never holds the bus while a password is checked.
+ * Then sleep until the next byte or the next interrupt.
+ */
+void link_idle(void){
+	Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+	if(step==2){
+		AuditLog_service();
+	}
+	UART_wakeOnReceive();
+	Power_idle();
+}
 
+/*
+ * Called after every handshake with the HMI: tell it which step to show.
+ * A door cycle or alarm still running ends in step 2, so the HMI starts
+ * there and its first request is served once it is over.
+ */
+void session_started(void){
+	uint8 start_step=(step<=4)?step:2;
+	SecLink_sendByte(start_step);
+	LOG_INFO(LOG_SESSION,start_step);
+	BootProfile_end(BOOT_MARK_READY);
+	if(ready_millis==0){
+		ready_millis=SysTick_getMillis();
+		ready_step=start_step;
 	}
+}
 
+/* Diagnostic handler for LINK_DIAG_BOOT_TIME */
+void report_boot_time(void){
+	uint8 frame[5];
+	frame[0]=(uint8)ready_millis;
+	frame[1]=(uint8)(ready_millis>>8);
+	frame[2]=(uint8)(ready_millis>>16);
+	frame[3]=(uint8)(ready_millis>>24);
+	frame[4]=ready_step;
+	LINK_sendFrame(LINK_DIAG_BOOT_TIME,frame,sizeof(frame));
+}
+
+/* Diagnostic handler for LINK_DIAG_RESET_CAUSE */
+void report_reset_cause(void){
+	uint8 frame[5];
+	frame[0]=Breadcrumb_getResetCause();
+	frame[1]=resumed.step;
+	frame[2]=resumed.phase;
+	frame[3]=resumed.segment;
+	frame[4]=resumed.remaining;
+	LINK_sendFrame(LINK_DIAG_RESET_CAUSE,frame,sizeof(frame));
+}
+
+/*
+ * Provisioning requests start with the system password. A wrong one is
+ * audited and the request refused. After CredCache_getMaxAttempts() wrong
+ * ones provisioning stays locked until the next reset: the lockout is
+ * audited once, so guesses cannot push the older records out of the log.
+ */
+boolean check_provisioning_password(const uint8 *password){
+	if(provision_failures>=CredCache_getMaxAttempts()){
+		return FALSE;
+	}
+	if(CredCache_verify(password)){
+		provision_failures=0;
+		return TRUE;
+	}
+	METRIC_INC(METRIC_WRONG_PASSWORDS);
+	provision_failures++;
+	if(provision_failures==CredCache_getMaxAttempts()){
+		METRIC_INC(METRIC_LOCKOUTS);
+		AuditLog_log(AUDIT_EVENT_LOCKOUT,AUDIT_RESULT_DENIED,AUDIT_SLOT_NONE);
+	}
+	else{
+		AuditLog_log(AUDIT_EVENT_PROVISION,AUDIT_RESULT_DENIED,AUDIT_SLOT_NONE);
+	}
+	return FALSE;
+}
+
+/* Provisioning handler for LINK_PROVISION_USER_ADD: password, PIN and role in, slot out */
+void provision_user_add(const uint8 *args,uint8 length){
+	uint8 i;
+	uint8 result=ERROR;
+	uint8 slot=CRED_STORE_NO_SLOT;
+	CredStore_UserType user;
+	if(length==PASSWORD_LENGTH+CRED_STORE_PIN_LENGTH+1&&check_provisioning_password(args)){
+		for(i=0;i<CRED_STORE_PIN_LENGTH;i++){
+			user.pin[i]=args[PASSWORD_LENGTH+i];
+		}
+		user.role=(CredStore_RoleType)args[PASSWORD_LENGTH+CRED_STORE_PIN_LENGTH];
+		result=CredStore_addUser(&user,&slot);
+		AuditLog_log(AUDIT_EVENT_PROVISION,(result==SUCCESS)?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,slot);
+	}
+	LINK_sendProvisionAnswer(LINK_PROVISION_USER_ADD,result,&slot,1);
+}
+
+/* Provisioning handler for LINK_PROVISION_USER_REVOKE: password and slot in */
+void provision_user_revoke(const uint8 *args,uint8 length){
+	uint8 result=ERROR;
+	if(length==PASSWORD_LENGTH+1&&check_provisioning_password(args)){
+		result=CredStore_revokeUser(args[PASSWORD_LENGTH]);
+		AuditLog_log(AUDIT_EVENT_PROVISION,(result==SUCCESS)?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,args[PASSWORD_LENGTH]);
+	}
+	LINK_sendProvisionAnswer(LINK_PROVISION_USER_REVOKE,result,NULL_PTR,0);
+}
+
+/*
+ * Provisioning handler for LINK_PROVISION_PROFILE_SAVE: password, slot,
+ * segment count and the segments as stored (direction, duty, duration, end
+ * condition) in. A segment count above DOOR_MAX_SEGMENTS, or one the
+ * length of the request does not match, is refused before any segment is
+ * copied; the profile itself is checked by DoorSeq_saveProfile.
+ */
+void provision_profile_save(const uint8 *args,uint8 length){
+	uint8 i;
+	uint8 result=ERROR;
+	DoorSeq_ProfileType profile;
+	const uint8 *segment=&args[PASSWORD_LENGTH+2];
+	profile.segment_count=(length>=PASSWORD_LENGTH+2)?args[PASSWORD_LENGTH+1]:0;
+	if(profile.segment_count<=DOOR_MAX_SEGMENTS&&length==PASSWORD_LENGTH+2+4*profile.segment_count
+			&&check_provisioning_password(args)){
+		for(i=0;i<profile.segment_count;i++){
+			profile.segments[i].direction=segment[0];
+			profile.segments[i].duty=segment[1];
+			profile.segments[i].duration=segment[2];
+			profile.segments[i].end_condition=segment[3];
+			segment+=4;
+		}
+		result=DoorSeq_saveProfile(args[PASSWORD_LENGTH],&profile);
+		AuditLog_log(AUDIT_EVENT_PROVISION,(result==SUCCESS)?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,args[PASSWORD_LENGTH]);
+	}
+	LINK_sendProvisionAnswer(LINK_PROVISION_PROFILE_SAVE,result,NULL_PTR,0);
+}
+
+/* Provisioning handler for LINK_PROVISION_PROFILE_SELECT: password and slot in */
+void provision_profile_select(const uint8 *args,uint8 length){
+	uint8 result=ERROR;
+	if(length==PASSWORD_LENGTH+1&&check_provisioning_password(args)){
+		result=DoorSeq_selectProfile(args[PASSWORD_LENGTH]);
+		AuditLog_log(AUDIT_EVENT_PROVISION,(result==SUCCESS)?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,args[PASSWORD_LENGTH]);
+	}
+	LINK_sendProvisionAnswer(LINK_PROVISION_PROFILE_SELECT,result,NULL_PTR,0);
 }
 
 void system_locked(void){
+	Supervisor_checkIn(SUPERVISOR_TASK_MOTION);
 	tick++;
-	if(tick==30){
+	if(tick==lockout_ticks){
 		tick=0;
 		step=2;
 		Timer1_deInit();
+		Supervisor_stop(SUPERVISOR_TASK_MOTION);
 		Buzzer_off();
+		remember(BREADCRUMB_PHASE_IDLE,0,0);
+	}
+	else{
+		remember(BREADCRUMB_PHASE_LOCKOUT,0,lockout_ticks-tick);
 	}
 }
 
@@ -86,6 +340,7 @@ int main(void){
 	uint8 state1;
 	uint8 num_wrong=0;
 	uint8 num_wrong1=0;
+	uint8 slot;
 
 
 
@@ -104,28 +359,107 @@ int main(void){
 			F_CPU_256,
 			COMPARE_MODE
 	};
+	Breadcrumb_init(&resumed);
+	SysTick_init();
+	BootProfile_start();
+	LOG_INFO(LOG_BOOT,Breadcrumb_getResetCause(),resumed.step,resumed.phase);
+	Supervisor_init();
+	Power_init();
 	TWI_init(&twi);
 	DcMotor_init();
+	KV_init();
+	BootProfile_mark(BOOT_MARK_STORE);
+	DoorSeq_init();
+
+	/*
+	 * Reset in the middle of a door cycle or an alarm (watchdog, brown-out,
+	 * reset pin): finish it from where it stopped. The door is not left
+	 * half open and a reset does not cut an alarm short.
+	 */
+	if(resumed.phase==BREADCRUMB_PHASE_DOOR
+			&&DoorSeq_resume(resumed.segment,resumed.remaining,&door_cycle_done)==SUCCESS){
+		step=6;
+		LOG_WARN(LOG_DOOR_RESUMED,resumed.segment,resumed.remaining);
+		Supervisor_start(SUPERVISOR_TASK_MOTION,SUPERVISOR_MOTION_DEADLINE_MS);
+		Timer1_init(&timer1);
+		Timer1_setCallBack(&door_tick);
+	}
+	else if(resumed.phase==BREADCRUMB_PHASE_LOCKOUT&&resumed.remaining!=0){
+		step=6;
+		lockout_ticks=resumed.remaining;
+		LOG_WARN(LOG_LOCKOUT_RESUMED,resumed.remaining);
+		Buzzer_on();
+		Supervisor_start(SUPERVISOR_TASK_MOTION,SUPERVISOR_MOTION_DEADLINE_MS);
+		Timer1_init(&timer1);
+		Timer1_setCallBack(&system_locked);
+	}
+	CredCache_init();
+	CredStore_init();
+	BootProfile_mark(BOOT_MARK_CREDENTIALS);
+
+	/* Warm boot: a stored credential record (magic and journal CRC checked) skips password setup */
+	if(step==1&&CredCache_hasPassword()){
+		step=2;
+	}
+	AuditLog_init();
+	BootProfile_mark(BOOT_MARK_AUDIT);
+	LINK_registerDiag(LINK_DIAG_AUDIT_LOG,&AuditLog_dump);
+	LINK_registerDiag(LINK_DIAG_HASH_BENCH,&CredCache_benchmark);
+	LINK_registerDiag(LINK_DIAG_LINK_BENCH,&SecLink_benchmark);
+	LINK_registerDiag(LINK_DIAG_BOOT_TIME,&report_boot_time);
+	LINK_registerDiag(LINK_DIAG_BOOT_PROFILE,&BootProfile_dump);
+	LINK_registerDiag(LINK_DIAG_RESET_CAUSE,&report_reset_cause);
+	LINK_registerDiag(LINK_DIAG_SUPERVISOR,&Supervisor_dump);
+	LINK_registerDiag(LINK_DIAG_POWER,&Power_dump);
+	LINK_registerDiag(LINK_DIAG_RAM,&RamUsage_dump);
+	LINK_registerDiag(LINK_DIAG_LATENCY,&Latency_dump);
+	LINK_registerDiag(LINK_DIAG_METRICS,&Metrics_dump);
+	LINK_registerProvision(LINK_PROVISION_USER_ADD,&provision_user_add);
+	LINK_registerProvision(LINK_PROVISION_USER_REVOKE,&provision_user_revoke);
+	LINK_registerProvision(LINK_PROVISION_PROFILE_SAVE,&provision_profile_save);
+	LINK_registerProvision(LINK_PROVISION_PROFILE_SELECT,&provision_profile_select);
+#if PROFILER_ENABLED
+	Profiler_init();
+	LINK_registerDiag(LINK_DIAG_PROFILE,&Profiler_dump);
+#endif
+#if TRACE_ENABLED
+	LINK_registerDiag(LINK_DIAG_TRACE,&Trace_dump);
+#endif
+#if LOG_LEVEL>LOG_LEVEL_NONE
+	LINK_registerDiag(LINK_DIAG_LOG,&Log_dump);
+#endif
+	SecLink_setSessionCallBack(&session_started);
+	LINK_setIdleCallBack(&link_idle);
 
 	UART_init(&uart);
+	SecLink_init();
+	LINK_init();
+	BootProfile_mark(BOOT_MARK_LINK);
 
 	while(1){
+		Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+		report_door_progress();
+
+		/* Steps 5 and 6 keep their own phase in the breadcrumb */
+		if(step<=4){
+			remember(BREADCRUMB_PHASE_IDLE,0,0);
+		}
 
 		if(step==1){
 			uint8 password_match=1;
 			uint8 password[PASSWORD_LENGTH];
 			uint8 password_confirmation[PASSWORD_LENGTH];
-			while(UART_receiveByte()!=HMI_ECU_READY);
+			LINK_waitFor(HMI_ECU_READY);
 
 			for(i=0;i<PASSWORD_LENGTH;i++){
-				password[i]=UART_receiveByte();
+				password[i]=SecLink_receiveByte();
 			}
 
 
-			while(UART_receiveByte()!=HMI_ECU_READY);
+			LINK_waitFor(HMI_ECU_READY);
 
 			for(i=0;i<PASSWORD_LENGTH;i++){
-				password_confirmation[i]=UART_receiveByte();
+				password_confirmation[i]=SecLink_receiveByte();
 			}
 
 
@@ -135,89 +469,116 @@ int main(void){
 					break;
 				}
 			}
-			UART_sendByte(CONTROL_ECU_READY);
+			SecLink_sendByte(CONTROL_ECU_READY);
 
 			if(password_match){
 				step=2;
-				UART_sendByte(step);
-				for(i=0;i<PASSWORD_LENGTH;i++){
-					EEPROM_writeByte(0x0310+i,password[i]);
-					_delay_ms(10);
-					}
+				SecLink_sendByte(step);
+				CredCache_setPassword(password);
+				AuditLog_log(AUDIT_EVENT_PASSWORD_SET,AUDIT_RESULT_GRANTED,AUDIT_SLOT_SYSTEM);
 			}
 			else{
-				UART_sendByte(step);
+				SecLink_sendByte(step);
+				AuditLog_log(AUDIT_EVENT_PASSWORD_SET,AUDIT_RESULT_DENIED,AUDIT_SLOT_SYSTEM);
 			}
 		}
 
 		else if(step==2){
 			uint8 choice;
-			while(UART_receiveByte()!=HMI_ECU_READY);
-			choice=UART_receiveByte();
+			LINK_waitFor(HMI_ECU_READY);
+			choice=SecLink_receiveByte();
 			if(choice=='+'){
 				step=3;
-				UART_sendByte(CONTROL_ECU_READY);
-				UART_sendByte(step);
+				SecLink_sendByte(CONTROL_ECU_READY);
+				SecLink_sendByte(step);
 			}
 			else{
 				step=4;
-				UART_sendByte(CONTROL_ECU_READY);
-				UART_sendByte(step);
+				SecLink_sendByte(CONTROL_ECU_READY);
+				SecLink_sendByte(step);
 			}
 		}
 		else if(step==3){
-			while(UART_receiveByte()!=HMI_ECU_READY);
+			LINK_waitFor(HMI_ECU_READY);
 
-			state1=read_password();
-			UART_sendByte(CONTROL_ECU_READY);
+			state1=read_password(CRED_ROLE_USER,&slot);
+			Latency_mark(LATENCY_PASSWORD_CHECKED);
+			SecLink_sendByte(CONTROL_ECU_READY);
+			Latency_mark(LATENCY_REPLY_SENT);
+			AuditLog_log(AUDIT_EVENT_UNLOCK,state1?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,slot);
 			if(state1){
+				METRIC_INC(METRIC_UNLOCKS);
 				num_wrong1=0;
-				UART_sendByte(OPEN_GATE);
+				LOG_INFO(LOG_UNLOCK,slot);
+				SecLink_sendByte(OPEN_GATE);
+				send_door_profile();
 
+				/* Saved before the first tick, which then keeps it up to date */
+				remember(BREADCRUMB_PHASE_DOOR,0,DoorSeq_getActiveProfile()->segments[0].duration);
+				Supervisor_start(SUPERVISOR_TASK_MOTION,SUPERVISOR_MOTION_DEADLINE_MS);
 				Timer1_init(&timer1);
-				DcMotor_Rotate(CW);
-				Timer1_setCallBack(&rotate_motor_open_door);
+				DoorSeq_start(&door_cycle_done);
+				Latency_mark(LATENCY_MOTOR_STARTED);
+				Timer1_setCallBack(&door_tick);
+				door_reported=0;
 				step=6;
 			}
-			else if(state1==0&&num_wrong1<2){
+			else if(state1==0&&num_wrong1<CredCache_getMaxAttempts()-1){
+				METRIC_INC(METRIC_WRONG_PASSWORDS);
 				num_wrong1++;
+				LOG_WARN(LOG_WRONG_PASSWORD,CRED_ROLE_USER,num_wrong1);
 				step=3;
-				UART_sendByte(step);
+				SecLink_sendByte(step);
 			}
-			else if(state1==0&&num_wrong1==2){
+			else if(state1==0){
+				METRIC_INC(METRIC_WRONG_PASSWORDS);
 				num_wrong1=0;
 				step=5;
-				UART_sendByte(step);
+				SecLink_sendByte(step);
 
 			}
 
 		}
 		else if(step==4){
 
-			while(UART_receiveByte()!=HMI_ECU_READY);
+			LINK_waitFor(HMI_ECU_READY);
 
-			state=read_password();
-			UART_sendByte(CONTROL_ECU_READY);
+			state=read_password(CRED_ROLE_ADMIN,&slot);
+			Latency_mark(LATENCY_PASSWORD_CHECKED);
+			SecLink_sendByte(CONTROL_ECU_READY);
+			Latency_mark(LATENCY_REPLY_SENT);
+			AuditLog_log(AUDIT_EVENT_ADMIN_AUTH,state?AUDIT_RESULT_GRANTED:AUDIT_RESULT_DENIED,slot);
 
 			if(state){
 				num_wrong=0;
 				step=1;
-				UART_sendByte(step);
+				SecLink_sendByte(step);
 			}
-			else if(state==0&&num_wrong<2){
+			else if(state==0&&num_wrong<CredCache_getMaxAttempts()-1){
+				METRIC_INC(METRIC_WRONG_PASSWORDS);
 				num_wrong++;
+				LOG_WARN(LOG_WRONG_PASSWORD,CRED_ROLE_ADMIN,num_wrong);
 				step=4;
-				UART_sendByte(step);
+				SecLink_sendByte(step);
 			}
-			else if(state==0&&num_wrong==2){
+			else if(state==0){
+				METRIC_INC(METRIC_WRONG_PASSWORDS);
 				num_wrong=0;
 				step=5;
-				UART_sendByte(step);
+				SecLink_sendByte(step);
 
 			}
 		}
 		else if(step==5){
+			/* The HMI shows the error for the same number of ticks */
+			lockout_ticks=CredCache_getLockoutTicks();
+			SecLink_sendByte(lockout_ticks);
+			LOG_WARN(LOG_LOCKOUT,lockout_ticks);
+			METRIC_INC(METRIC_LOCKOUTS);
 			Buzzer_on();
+			AuditLog_log(AUDIT_EVENT_LOCKOUT,AUDIT_RESULT_DENIED,AUDIT_SLOT_NONE);
+			remember(BREADCRUMB_PHASE_LOCKOUT,0,lockout_ticks);
+			Supervisor_start(SUPERVISOR_TASK_MOTION,SUPERVISOR_MOTION_DEADLINE_MS);
 			Timer1_init(&timer1);
 			Timer1_setCallBack(&system_locked);
 			step=6;
@@ -225,6 +586,10 @@ int main(void){
 
 		}
 		else if(step==6){
+			/* Door moving or alarm running, the bus is free for the audit log */
+			door_poll();
+			AuditLog_service();
+			Power_idle();
 		}
 }
 }
@@ -0,0 +1,34 @@
+/*******************************
+ *  crc.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "crc.h"
+
+uint16 CRC16_update(uint16 crc,uint8 data){
+	uint8 i;
+
+	crc^=(uint16)data<<8;
+	for(i=0;i<8;i++){
+		if(crc&0x8000){
+			crc=(crc<<1)^0x1021;
+		}
+		else{
+			crc<<=1;
+		}
+	}
+	return crc;
+}
+
+uint16 CRC16_compute(const uint8 *data,uint16 length){
+	uint16 crc=CRC16_INIT;
+
+	while(length>0){
+		crc=CRC16_update(crc,*data++);
+		length--;
+	}
+	return crc;
+}
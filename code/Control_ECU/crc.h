@@ -0,0 +1,29 @@
+/*******************************
+ *  crc.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include "std_types.h"
+
+/* Start value of a CRC-16/CCITT-FALSE computation */
+#define CRC16_INIT 0xFFFF
+
+/*
+ * Description:
+ * Add one byte to a running CRC-16/CCITT (polynomial 0x1021) and return the new value.
+ */
+uint16 CRC16_update(uint16 crc,uint8 data);
+
+/*
+ * Description:
+ * Return the CRC-16/CCITT of a buffer, starting from CRC16_INIT.
+ */
+uint16 CRC16_compute(const uint8 *data,uint16 length);
+
+#endif /* CRC_H_ */
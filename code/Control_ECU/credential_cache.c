@@ -0,0 +1,174 @@
+/*******************************
+ *  credential_cache.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "credential_cache.h"
+#include "kv_store.h"
+#include "blake2s.h"
+#include "systick.h"
+#include "link.h"
+#include <avr/io.h>
+
+static CredCache_RecordType g_record;
+static CredCache_SettingsType g_settings;
+
+/* FALSE when the SRAM copy may differ from the EEPROM */
+static volatile boolean g_loaded=FALSE;
+
+/* TRUE when g_record holds a stored password */
+static boolean g_valid=FALSE;
+
+/* Set while the cache writes its own records, so the write is not seen as external */
+static volatile boolean g_self_write=FALSE;
+
+static uint8 CredCache_load(void){
+	g_loaded=TRUE;
+	if(KV_get(KV_KEY_SETTINGS,(uint8*)&g_settings,sizeof(g_settings))==ERROR
+			||g_settings.max_attempts==0){
+		g_settings.max_attempts=CRED_DEFAULT_MAX_ATTEMPTS;
+		g_settings.lockout_ticks=CRED_DEFAULT_LOCKOUT_TICKS;
+	}
+	if(KV_get(KV_KEY_CREDENTIALS,(uint8*)&g_record,sizeof(g_record))==SUCCESS
+			&&g_record.magic==CRED_RECORD_MAGIC){
+		g_valid=TRUE;
+		return SUCCESS;
+	}
+	g_valid=FALSE;
+	return ERROR;
+}
+
+/* Reload after an invalidation, otherwise serve from SRAM */
+static void CredCache_ensureLoaded(void){
+	if(!g_loaded){
+		CredCache_load();
+	}
+}
+
+/* Store write notification, invalidate if a record is written by someone else */
+static void CredCache_onStoreWrite(KV_KeyType key){
+	if(!g_self_write&&(key==KV_KEY_CREDENTIALS||key==KV_KEY_SETTINGS)){
+		g_loaded=FALSE;
+	}
+}
+
+static void CredCache_digest(uint8 *digest,const uint8 *salt,const uint8 *password){
+	Blake2s_hash(digest,CRED_DIGEST_LENGTH,salt,CRED_SALT_LENGTH,password,CRED_PASSWORD_LENGTH);
+}
+
+static uint8 CredCache_put(KV_KeyType key,const uint8 *value,uint8 length){
+	uint8 result;
+	g_self_write=TRUE;
+	result=KV_put(key,value,length);
+	g_self_write=FALSE;
+	if(result==ERROR){
+		/* Reload the last committed records on the next access */
+		g_loaded=FALSE;
+	}
+	return result;
+}
+
+uint8 CredCache_init(void){
+	KV_setWriteCallBack(&CredCache_onStoreWrite);
+	return CredCache_load();
+}
+
+boolean CredCache_hasPassword(void){
+	CredCache_ensureLoaded();
+	return g_valid;
+}
+
+boolean CredCache_verify(const uint8 *password){
+	uint8 digest[CRED_DIGEST_LENGTH];
+
+	CredCache_ensureLoaded();
+	CredCache_digest(digest,g_record.salt,password);
+	return (boolean)(g_valid&CredCache_isEqual(digest,g_record.digest,CRED_DIGEST_LENGTH));
+}
+
+boolean CredCache_isEqual(const uint8 *a,const uint8 *b,uint8 length){
+	uint8 diff=0;
+	uint8 i;
+
+	/* No early exit: every byte is compared whatever the first difference */
+	for(i=0;i<length;i++){
+		diff|=(uint8)(a[i]^b[i]);
+	}
+	return (boolean)(diff==0);
+}
+
+uint8 CredCache_setPassword(const uint8 *password){
+	CredCache_RecordType record;
+	uint32 seed;
+
+	/*
+	 * The salt only has to differ between devices and passwords. The time
+	 * since boot in microseconds, mixed with the motor PWM counter, depends on
+	 * when the user finished typing, which is unpredictable to 8 us.
+	 */
+	seed=SysTick_getMicros()^((uint32)TCNT0<<8);
+	record.magic=CRED_RECORD_MAGIC;
+	record.salt[0]=(uint8)(seed>>3);
+	record.salt[1]=(uint8)(seed>>11);
+	CredCache_digest(record.digest,record.salt,password);
+
+	/* Write-through, appended to the journal as one atomic record */
+	if(CredCache_put(KV_KEY_CREDENTIALS,(const uint8*)&record,sizeof(record))==ERROR){
+		return ERROR;
+	}
+	g_record=record;
+	g_valid=TRUE;
+	return SUCCESS;
+}
+
+uint8 CredCache_getMaxAttempts(void){
+	CredCache_ensureLoaded();
+	return g_settings.max_attempts;
+}
+
+uint8 CredCache_getLockoutTicks(void){
+	CredCache_ensureLoaded();
+	return g_settings.lockout_ticks;
+}
+
+uint8 CredCache_setSettings(uint8 max_attempts,uint8 lockout_ticks){
+	CredCache_SettingsType settings;
+
+	if(max_attempts==0){
+		return ERROR;
+	}
+	CredCache_ensureLoaded();
+	settings.max_attempts=max_attempts;
+	settings.lockout_ticks=lockout_ticks;
+	if(CredCache_put(KV_KEY_SETTINGS,(const uint8*)&settings,sizeof(settings))==ERROR){
+		return ERROR;
+	}
+	g_settings=settings;
+	return SUCCESS;
+}
+
+void CredCache_benchmark(void){
+	uint8 password[CRED_PASSWORD_LENGTH]={1,2,3,4,5};
+	uint8 frame[5];
+	uint32 start;
+	uint32 cycles;
+	uint8 i;
+
+	CredCache_ensureLoaded();
+	start=SysTick_getMicros();
+	for(i=0;i<CRED_BENCHMARK_RUNS;i++){
+		CredCache_verify(password);
+	}
+	/* Includes the SysTick interrupts taken meanwhile, as a real check would */
+	cycles=(SysTick_getMicros()-start)*(F_CPU/1000000UL)/CRED_BENCHMARK_RUNS;
+
+	frame[0]=(uint8)cycles;
+	frame[1]=(uint8)(cycles>>8);
+	frame[2]=(uint8)(cycles>>16);
+	frame[3]=(uint8)(cycles>>24);
+	frame[4]=(cycles<=CRED_VERIFY_BUDGET_CYCLES);
+	LINK_sendFrame(LINK_DIAG_HASH_BENCH,frame,sizeof(frame));
+}
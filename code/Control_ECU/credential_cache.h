@@ -0,0 +1,125 @@
+/*******************************
+ *  credential_cache.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef CREDENTIAL_CACHE_H_
+#define CREDENTIAL_CACHE_H_
+
+#include "std_types.h"
+
+#define CRED_PASSWORD_LENGTH        5
+
+/* First byte of a valid credential record */
+#define CRED_RECORD_MAGIC           0xC5
+
+/* Configuration used until settings are stored */
+#define CRED_DEFAULT_MAX_ATTEMPTS   3
+#define CRED_DEFAULT_LOCKOUT_TICKS  30
+
+/*
+ * The password is kept as a BLAKE2s digest of the keypad digits, with a random
+ * salt in the BLAKE2s parameter block. Salt and digest fill the rest of a
+ * key-value store record.
+ */
+#define CRED_SALT_LENGTH            2
+#define CRED_DIGEST_LENGTH          7
+
+/* Password checks timed by CredCache_benchmark() */
+#define CRED_BENCHMARK_RUNS         16
+
+/* Cycles a password check may take before it shows in the unlock latency (5 ms) */
+#define CRED_VERIFY_BUDGET_CYCLES   (F_CPU/200UL)
+
+/*
+ * The credential record as stored in the key-value store and kept in SRAM.
+ * Its integrity is checked by the CRC of the store record.
+ */
+typedef struct {
+	uint8 magic;
+	uint8 salt[CRED_SALT_LENGTH];
+	uint8 digest[CRED_DIGEST_LENGTH];
+} CredCache_RecordType;
+
+/* Lockout policy, stored under its own key */
+typedef struct {
+	uint8 max_attempts;     /* Wrong passwords before the alarm */
+	uint8 lockout_ticks;    /* Alarm duration in Timer1 ticks */
+} CredCache_SettingsType;
+
+/*
+ * Description:
+ * Load the credential record and the settings from the key-value store into
+ * SRAM. Also registers for store write notifications: a write of the
+ * record made by anyone else invalidates the cache and the next access
+ * reloads it. KV_init() must have been called.
+ *
+ * Returns:
+ *  - SUCCESS if a valid record was found, ERROR if the defaults are used.
+ */
+uint8 CredCache_init(void);
+
+/*
+ * Description:
+ * Return TRUE if a password has been stored.
+ */
+boolean CredCache_hasPassword(void);
+
+/*
+ * Description:
+ * Hash the given password with the stored salt and compare it with the
+ * stored digest, served from SRAM. The time taken does not depend on
+ * where the password differs.
+ */
+boolean CredCache_verify(const uint8 *password);
+
+/*
+ * Description:
+ * Store a new password with a new salt: the SRAM copy is updated and written
+ * through to the EEPROM.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the EEPROM write failed (the cache is then invalid).
+ */
+uint8 CredCache_setPassword(const uint8 *password);
+
+/*
+ * Description:
+ * Compare two digests in constant time: every byte is compared whatever the
+ * first difference, so the time taken tells nothing of the digest.
+ */
+boolean CredCache_isEqual(const uint8 *a,const uint8 *b,uint8 length);
+
+/*
+ * Description:
+ * Return the configured number of wrong attempts before the alarm.
+ */
+uint8 CredCache_getMaxAttempts(void);
+
+/*
+ * Description:
+ * Return the configured alarm duration in Timer1 ticks.
+ */
+uint8 CredCache_getLockoutTicks(void);
+
+/*
+ * Description:
+ * Store a new wrong attempt limit and alarm duration.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the EEPROM write failed.
+ */
+uint8 CredCache_setSettings(uint8 max_attempts,uint8 lockout_ticks);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_HASH_BENCH: run CRED_BENCHMARK_RUNS
+ * password checks and send one frame holding the average cycles of a check
+ * (uint32) and TRUE if it is within CRED_VERIFY_BUDGET_CYCLES.
+ */
+void CredCache_benchmark(void);
+
+#endif /* CREDENTIAL_CACHE_H_ */
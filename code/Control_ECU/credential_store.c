@@ -0,0 +1,260 @@
+/*******************************
+ *  credential_store.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "credential_store.h"
+#include "credential_cache.h"
+#include "external_eeprom.h"
+#include "eeprom_map.h"
+#include "blake2s.h"
+#include "seclink.h"
+#include "speck.h"
+#include <string.h>
+
+/*
+ * Slot layout: state, digest of the PIN (7 bytes). The board has no clock,
+ * the slots carry no validity window.
+ */
+#define SLOT_STATE_OFFSET   0
+#define SLOT_DIGEST_OFFSET  1
+#define PIN_DIGEST_SIZE     (CRED_STORE_SLOT_SIZE-SLOT_DIGEST_OFFSET)
+
+/* BLAKE2s salt of the PIN digests, it keeps them apart from any other use of the key */
+#define PIN_DIGEST_SALT     "UserPIN"
+
+/* Slot states besides the role of a live user */
+#define SLOT_EMPTY          0xFF    /* Erased EEPROM, never used: ends a probe sequence */
+#define SLOT_REVOKED        0x00    /* Tombstone: skipped by lookups, reused by adds */
+
+/* Slots read per transaction while building the summary */
+#define SCAN_SLOTS          4
+
+#define SLOT_ADDRESS(SLOT)  (EEPROM_USERS_ADDRESS+(uint16)(SLOT)*CRED_STORE_SLOT_SIZE)
+#define NEXT_SLOT(SLOT)     (((SLOT)+1)&(CRED_STORE_SLOTS-1))
+#define BLOOM_MASK          (CRED_STORE_BLOOM_SIZE*8-1)
+
+/* RAM summary of the table */
+static uint8 g_bloom[CRED_STORE_BLOOM_SIZE];
+static uint8 g_used[CRED_STORE_SLOTS/8];
+static uint8 g_user_count=0;
+
+static boolean CredStore_isUsed(uint8 slot){
+	return (g_used[slot>>3]>>(slot&7))&1;
+}
+
+static void CredStore_markUsed(uint8 slot){
+	g_used[slot>>3]|=(uint8)(1<<(slot&7));
+}
+
+/*
+ * Digest of a PIN, keyed with the pairing key: it is in the flash of the
+ * MCU, not in the external EEPROM, so the 100000 possible PINs cannot be
+ * tried against a dump of the table alone. A per-slot random salt would
+ * not work here, the digest must be found again from the PIN to index the
+ * table. FALSE if a key is not a digit.
+ */
+static boolean CredStore_digest(const uint8 *pin,uint8 *digest){
+	uint8 message[SPECK_KEY_SIZE+CRED_STORE_PIN_LENGTH]=SECLINK_PAIRING_KEY;
+	uint8 i;
+	for(i=0;i<CRED_STORE_PIN_LENGTH;i++){
+		if(pin[i]>9){
+			return FALSE;
+		}
+		message[SPECK_KEY_SIZE+i]=pin[i];
+	}
+	Blake2s_hash(digest,PIN_DIGEST_SIZE,(const uint8*)PIN_DIGEST_SALT,sizeof(PIN_DIGEST_SALT)-1,message,sizeof(message));
+	return TRUE;
+}
+
+/* The digest is uniform already: high bits select the home slot, low bits the Bloom bits */
+static uint32 CredStore_hash(const uint8 *digest){
+	uint32 h;
+	memcpy(&h,digest,sizeof(h));
+	return h;
+}
+
+static uint8 CredStore_homeSlot(uint32 h){
+	return (uint8)(h>>24)&(CRED_STORE_SLOTS-1);
+}
+
+static void CredStore_bloomAdd(uint32 h){
+	uint16 bit1=(uint16)h&BLOOM_MASK;
+	uint16 bit2=(uint16)(h>>9)&BLOOM_MASK;
+	g_bloom[bit1>>3]|=(uint8)(1<<(bit1&7));
+	g_bloom[bit2>>3]|=(uint8)(1<<(bit2&7));
+}
+
+static boolean CredStore_bloomMayContain(uint32 h){
+	uint16 bit1=(uint16)h&BLOOM_MASK;
+	uint16 bit2=(uint16)(h>>9)&BLOOM_MASK;
+	return ((g_bloom[bit1>>3]>>(bit1&7))&1)&&((g_bloom[bit2>>3]>>(bit2&7))&1);
+}
+
+static boolean CredStore_isLive(uint8 state){
+	return (state!=SLOT_EMPTY&&state!=SLOT_REVOKED);
+}
+
+/*
+ * Follow the probe sequence of a PIN. Slots never used end it without an
+ * EEPROM read, so a lookup reads only the occupied slots of its cluster.
+ */
+static uint8 CredStore_find(const uint8 *digest,uint32 h,uint8 *record){
+	uint8 slot=CredStore_homeSlot(h);
+	uint8 probes;
+
+	for(probes=0;probes<CRED_STORE_SLOTS&&CredStore_isUsed(slot);probes++){
+		if(EEPROM_readBlock(SLOT_ADDRESS(slot),record,CRED_STORE_SLOT_SIZE)==ERROR){
+			return CRED_STORE_NO_SLOT;
+		}
+		if(CredStore_isLive(record[SLOT_STATE_OFFSET])
+				&CredCache_isEqual(&record[SLOT_DIGEST_OFFSET],digest,PIN_DIGEST_SIZE)){
+			return slot;
+		}
+		slot=NEXT_SLOT(slot);
+	}
+	return CRED_STORE_NO_SLOT;
+}
+
+uint8 CredStore_init(void){
+	uint8 buffer[SCAN_SLOTS*CRED_STORE_SLOT_SIZE];
+	uint8 slot,i;
+	uint8 *record;
+
+	for(i=0;i<CRED_STORE_BLOOM_SIZE;i++){
+		g_bloom[i]=0;
+	}
+	for(i=0;i<CRED_STORE_SLOTS/8;i++){
+		g_used[i]=0;
+	}
+	g_user_count=0;
+
+	for(slot=0;slot<CRED_STORE_SLOTS;slot+=SCAN_SLOTS){
+		if(EEPROM_readBlock(SLOT_ADDRESS(slot),buffer,sizeof(buffer))==ERROR){
+			return ERROR;
+		}
+		for(i=0;i<SCAN_SLOTS;i++){
+			record=&buffer[i*CRED_STORE_SLOT_SIZE];
+			if(record[SLOT_STATE_OFFSET]==SLOT_EMPTY){
+				continue;
+			}
+			CredStore_markUsed(slot+i);
+			if(CredStore_isLive(record[SLOT_STATE_OFFSET])){
+				CredStore_bloomAdd(CredStore_hash(&record[SLOT_DIGEST_OFFSET]));
+				g_user_count++;
+			}
+		}
+	}
+	return SUCCESS;
+}
+
+boolean CredStore_verify(const uint8 *pin,CredStore_RoleType required_role,uint8 *Slot_Ptr){
+	uint8 digest[PIN_DIGEST_SIZE];
+	uint8 record[CRED_STORE_SLOT_SIZE];
+	uint32 h;
+	uint8 slot;
+
+	if(Slot_Ptr!=NULL_PTR){
+		*Slot_Ptr=CRED_STORE_NO_SLOT;
+	}
+
+	/* Most wrong PINs stop at the Bloom filter without touching the bus */
+	if(!CredStore_digest(pin,digest)){
+		return FALSE;
+	}
+	h=CredStore_hash(digest);
+	if(!CredStore_bloomMayContain(h)){
+		return FALSE;
+	}
+
+	slot=CredStore_find(digest,h,record);
+	if(slot==CRED_STORE_NO_SLOT){
+		return FALSE;
+	}
+	if(Slot_Ptr!=NULL_PTR){
+		*Slot_Ptr=slot;
+	}
+
+	return (boolean)(record[SLOT_STATE_OFFSET]>=required_role);
+}
+
+uint8 CredStore_addUser(const CredStore_UserType *User_Ptr,uint8 *Slot_Ptr){
+	uint8 record[CRED_STORE_SLOT_SIZE];
+	uint8 state;
+	uint32 h;
+	uint8 slot;
+	uint8 probes;
+
+	if(!CredStore_digest(User_Ptr->pin,&record[SLOT_DIGEST_OFFSET])
+			||User_Ptr->role<CRED_ROLE_USER||User_Ptr->role>CRED_ROLE_ADMIN){
+		return ERROR;
+	}
+	h=CredStore_hash(&record[SLOT_DIGEST_OFFSET]);
+
+	/* A PIN identifies its user, it must be unique */
+	if(CredStore_bloomMayContain(h)){
+		uint8 existing[CRED_STORE_SLOT_SIZE];
+		if(CredStore_find(&record[SLOT_DIGEST_OFFSET],h,existing)!=CRED_STORE_NO_SLOT){
+			return ERROR;
+		}
+	}
+
+	/* First never used slot or tombstone of the probe sequence */
+	slot=CredStore_homeSlot(h);
+	for(probes=0;probes<CRED_STORE_SLOTS;probes++){
+		if(!CredStore_isUsed(slot)){
+			break;
+		}
+		if(EEPROM_readByte(SLOT_ADDRESS(slot)+SLOT_STATE_OFFSET,&state)==ERROR){
+			return ERROR;
+		}
+		if(state==SLOT_REVOKED){
+			break;
+		}
+		slot=NEXT_SLOT(slot);
+	}
+	if(probes==CRED_STORE_SLOTS){
+		return ERROR;
+	}
+
+	record[SLOT_STATE_OFFSET]=(uint8)User_Ptr->role;
+
+	/* Slots are 8-byte aligned, one slot is always a single page write */
+	if(EEPROM_writeBlock(SLOT_ADDRESS(slot),record,CRED_STORE_SLOT_SIZE)==ERROR){
+		return ERROR;
+	}
+
+	CredStore_markUsed(slot);
+	CredStore_bloomAdd(h);
+	g_user_count++;
+	if(Slot_Ptr!=NULL_PTR){
+		*Slot_Ptr=slot;
+	}
+	return SUCCESS;
+}
+
+uint8 CredStore_revokeUser(uint8 slot){
+	uint8 state;
+
+	if(slot>=CRED_STORE_SLOTS||!CredStore_isUsed(slot)){
+		return ERROR;
+	}
+	if(EEPROM_readByte(SLOT_ADDRESS(slot)+SLOT_STATE_OFFSET,&state)==ERROR||!CredStore_isLive(state)){
+		return ERROR;
+	}
+
+	/* The slot stays used so the probe sequences through it are not cut */
+	state=SLOT_REVOKED;
+	if(EEPROM_writeBlock(SLOT_ADDRESS(slot)+SLOT_STATE_OFFSET,&state,1)==ERROR){
+		return ERROR;
+	}
+	g_user_count--;
+	return SUCCESS;
+}
+
+uint8 CredStore_getUserCount(void){
+	return g_user_count;
+}
@@ -0,0 +1,86 @@
+/*******************************
+ *  credential_store.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef CREDENTIAL_STORE_H_
+#define CREDENTIAL_STORE_H_
+
+#include "std_types.h"
+
+/* Number of PIN digits of a user */
+#define CRED_STORE_PIN_LENGTH   5
+
+/*
+ * Table geometry: an open-addressing hash table of fixed 8-byte slots.
+ * 128 slots fill the upper kilobyte of the 24C16, a bigger 24Cxx only
+ * needs a bigger CRED_STORE_SLOTS (power of two). A slot holds the role and
+ * a BLAKE2s digest of the PIN keyed with the pairing key, never the PIN;
+ * the digest also places the slot and is compared in constant time.
+ */
+#define CRED_STORE_SLOTS        128
+#define CRED_STORE_SLOT_SIZE    8
+
+/* Size of the in-RAM Bloom filter in bytes (512 bits) */
+#define CRED_STORE_BLOOM_SIZE   64
+
+/* Slot returned by a lookup that did not find the PIN */
+#define CRED_STORE_NO_SLOT      0xFF
+
+typedef enum {
+	CRED_ROLE_USER=1,       /* May open the door */
+	CRED_ROLE_ADMIN=2       /* May also change the system password */
+} CredStore_RoleType;
+
+typedef struct {
+	uint8 pin[CRED_STORE_PIN_LENGTH];   /* Keypad digits 0..9 */
+	CredStore_RoleType role;
+} CredStore_UserType;
+
+/*
+ * Description:
+ * Scan the table once to build the RAM summary: a Bloom filter of the stored
+ * PINs and a bitmap of the slots that were ever used. With them a wrong PIN
+ * usually costs no EEPROM read and a right one a single 8-byte read.
+ */
+uint8 CredStore_init(void);
+
+/*
+ * Description:
+ * Look up a PIN and check its role.
+ *
+ * Parameters:
+ *  - pin: CRED_STORE_PIN_LENGTH keypad digits.
+ *  - required_role: Minimum role needed.
+ *  - Slot_Ptr: Receives the slot of the user, CRED_STORE_NO_SLOT if not found. May be NULL_PTR.
+ *
+ * Returns:
+ *  - TRUE if access is granted.
+ */
+boolean CredStore_verify(const uint8 *pin,CredStore_RoleType required_role,uint8 *Slot_Ptr);
+
+/*
+ * Description:
+ * Add a user, writing only its own slot.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the PIN is invalid, already used or the table is full.
+ */
+uint8 CredStore_addUser(const CredStore_UserType *User_Ptr,uint8 *Slot_Ptr);
+
+/*
+ * Description:
+ * Revoke a user by turning its slot into a tombstone (a single byte write).
+ */
+uint8 CredStore_revokeUser(uint8 slot);
+
+/*
+ * Description:
+ * Return the number of active users.
+ */
+uint8 CredStore_getUserCount(void);
+
+#endif /* CREDENTIAL_STORE_H_ */
@@ -25,9 +25,11 @@ void DcMotor_init(void){
 }
 
 
-void DcMotor_Rotate(DcMotor_State state){
-	uint8 speed=100;
-	speed=(speed*(DUTY_CYCLE-1))/100;
+void DcMotor_Rotate(DcMotor_State state,uint8 speed){
+	if(speed>100){
+		speed=100;
+	}
+	speed=((uint16)speed*(DUTY_CYCLE-1))/100;
 
 
 	PWM_TIMER0_start(speed);
@@ -31,7 +31,12 @@ typedef enum{
 
 void DcMotor_init(void);
 
-void DcMotor_Rotate(DcMotor_State state);
+/*
+ * Description:
+ * Rotate the motor in the required direction with the required speed.
+ * speed is the PWM duty cycle in percent (0 --> 100).
+ */
+void DcMotor_Rotate(DcMotor_State state,uint8 speed);
 
 
 
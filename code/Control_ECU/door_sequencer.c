@@ -0,0 +1,269 @@
+/*******************************
+ *  door_sequencer.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "door_sequencer.h"
+#include "external_eeprom.h"
+#include "eeprom_map.h"
+#include "kv_store.h"
+#include "gpio.h"
+#include "buzzer.h"
+#include "twi.h"
+#include <string.h>
+
+/* Byte offsets inside a profile slot */
+#define PROFILE_MAGIC_OFFSET      0
+#define PROFILE_COUNT_OFFSET      1
+#define PROFILE_CHECKSUM_OFFSET   2
+#define PROFILE_SEGMENTS_OFFSET   4
+#define SEGMENT_SIZE              4
+
+/* Fields of a DOOR_END_ON_PIN() code */
+#define END_PIN(CODE)    ((CODE)&0x07)
+#define END_PORT(CODE)   (((CODE)>>3)&0x07)
+#define END_LEVEL(CODE)  (((CODE)>>6)&0x01)
+#define END_SPARE(CODE)  ((CODE)&0x80)
+
+/* USART pins, uart.h leaves them to the hardware */
+#define UART_PORT_ID     PORTD_ID
+#define UART_RXD_PIN_ID  PIN0_ID
+#define UART_TXD_PIN_ID  PIN1_ID
+
+/*
+ * Pins the drivers of CONTROL_ECU own. An end condition on one of them
+ * would turn it into an input when the cycle starts, e.g. stop the motor
+ * or cut the link, so a profile using one is invalid.
+ */
+static const uint8 g_reserved_pins[][2]={
+	{UART_PORT_ID,UART_RXD_PIN_ID},
+	{UART_PORT_ID,UART_TXD_PIN_ID},
+	{TWI_SCL_PORT_ID,TWI_SCL_PIN_ID},
+	{TWI_SDA_PORT_ID,TWI_SDA_PIN_ID},
+	{INPUT_ONE_PORT_ID,INPUT_ONE_PIN_ID},
+	{INPUT_TWO_PORT_ID,INPUT_TWO_PIN_ID},
+	{ENABLE_PORT_ID,ENABLE_PIN_ID},
+	{BUZZER_PORT,BUZZER_PIN},
+};
+
+/* Profile used when the EEPROM holds nothing valid, same timing as the original firmware */
+static const DoorSeq_ProfileType g_default_profile={
+	3,
+	{
+		{CW,100,15,DOOR_END_NONE},
+		{STOP,0,3,DOOR_END_NONE},
+		{A_CW,100,15,DOOR_END_NONE},
+	}
+};
+
+static DoorSeq_ProfileType g_profile;
+
+static volatile uint8 g_segment=0;
+static volatile uint8 g_remaining=0;
+static volatile boolean g_running=FALSE;
+static void(*volatile g_done_ptr)(void)=NULL_PTR;
+
+/*
+ * Checksum of the count and segment bytes, chosen so that the sum of
+ * all of them plus the checksum is zero.
+ */
+static uint8 DoorSeq_checksum(const DoorSeq_ProfileType* Profile_Ptr){
+	uint8 i;
+	uint8 sum=Profile_Ptr->segment_count;
+	for(i=0;i<Profile_Ptr->segment_count;i++){
+		sum+=Profile_Ptr->segments[i].direction;
+		sum+=Profile_Ptr->segments[i].duty;
+		sum+=Profile_Ptr->segments[i].duration;
+		sum+=Profile_Ptr->segments[i].end_condition;
+	}
+	return (uint8)(0-sum);
+}
+
+/* TRUE if the end condition is DOOR_END_NONE or a free pin of an existing port */
+static boolean DoorSeq_isEndValid(uint8 code){
+	uint8 i;
+	if(code==DOOR_END_NONE){
+		return TRUE;
+	}
+	if(END_SPARE(code)||END_PORT(code)>=NUM_OF_PORTS){
+		return FALSE;
+	}
+	for(i=0;i<sizeof(g_reserved_pins)/sizeof(g_reserved_pins[0]);i++){
+		if(END_PORT(code)==g_reserved_pins[i][0]&&END_PIN(code)==g_reserved_pins[i][1]){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static boolean DoorSeq_isValid(const DoorSeq_ProfileType* Profile_Ptr){
+	uint8 i;
+	if(Profile_Ptr->segment_count==0||Profile_Ptr->segment_count>DOOR_MAX_SEGMENTS){
+		return FALSE;
+	}
+	for(i=0;i<Profile_Ptr->segment_count;i++){
+		if(Profile_Ptr->segments[i].direction>A_CW||Profile_Ptr->segments[i].duty>100
+				||Profile_Ptr->segments[i].duration==0
+				||!DoorSeq_isEndValid(Profile_Ptr->segments[i].end_condition)){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static uint8 DoorSeq_loadProfile(uint8 index,DoorSeq_ProfileType* Profile_Ptr){
+	uint8 record[DOOR_PROFILE_SLOT_SIZE];
+
+	if(index>=DOOR_MAX_PROFILES){
+		return ERROR;
+	}
+	if(EEPROM_readBlock(EEPROM_DOOR_PROFILES_ADDRESS+(uint16)index*DOOR_PROFILE_SLOT_SIZE,
+			record,DOOR_PROFILE_SLOT_SIZE)==ERROR){
+		return ERROR;
+	}
+	if(record[PROFILE_MAGIC_OFFSET]!=DOOR_PROFILE_MAGIC||record[PROFILE_COUNT_OFFSET]>DOOR_MAX_SEGMENTS){
+		return ERROR;
+	}
+	Profile_Ptr->segment_count=record[PROFILE_COUNT_OFFSET];
+	memcpy(Profile_Ptr->segments,&record[PROFILE_SEGMENTS_OFFSET],Profile_Ptr->segment_count*SEGMENT_SIZE);
+	if(record[PROFILE_CHECKSUM_OFFSET]!=DoorSeq_checksum(Profile_Ptr)||!DoorSeq_isValid(Profile_Ptr)){
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+uint8 DoorSeq_init(void){
+	uint8 index;
+	if(KV_get(KV_KEY_DOOR_PROFILE,&index,1)==SUCCESS
+			&&DoorSeq_loadProfile(index,&g_profile)==SUCCESS){
+		return SUCCESS;
+	}
+	g_profile=g_default_profile;
+	return ERROR;
+}
+
+const DoorSeq_ProfileType* DoorSeq_getActiveProfile(void){
+	return &g_profile;
+}
+
+uint8 DoorSeq_saveProfile(uint8 index,const DoorSeq_ProfileType* Profile_Ptr){
+	uint16 address=EEPROM_DOOR_PROFILES_ADDRESS+(uint16)index*DOOR_PROFILE_SLOT_SIZE;
+	uint8 record[DOOR_PROFILE_SLOT_SIZE];
+
+	if(index>=DOOR_MAX_PROFILES||!DoorSeq_isValid(Profile_Ptr)){
+		return ERROR;
+	}
+
+	memset(record,0xFF,DOOR_PROFILE_SLOT_SIZE);
+	record[PROFILE_COUNT_OFFSET]=Profile_Ptr->segment_count;
+	record[PROFILE_CHECKSUM_OFFSET]=DoorSeq_checksum(Profile_Ptr);
+	memcpy(&record[PROFILE_SEGMENTS_OFFSET],Profile_Ptr->segments,Profile_Ptr->segment_count*SEGMENT_SIZE);
+
+	/* Everything but the magic first, so a reset mid-write leaves an invalid slot */
+	if(EEPROM_writeBlock(address+1,&record[1],DOOR_PROFILE_SLOT_SIZE-1)==ERROR){
+		return ERROR;
+	}
+	record[PROFILE_MAGIC_OFFSET]=DOOR_PROFILE_MAGIC;
+	return EEPROM_writeBlock(address+PROFILE_MAGIC_OFFSET,&record[PROFILE_MAGIC_OFFSET],1);
+}
+
+uint8 DoorSeq_selectProfile(uint8 index){
+	DoorSeq_ProfileType profile;
+	/* The running cycle reads g_profile from the Timer1 ISR */
+	if(g_running||DoorSeq_loadProfile(index,&profile)==ERROR){
+		return ERROR;
+	}
+	if(KV_put(KV_KEY_DOOR_PROFILE,&index,1)==ERROR){
+		return ERROR;
+	}
+	g_profile=profile;
+	return SUCCESS;
+}
+
+/* Drive the motor as the current segment requires and reload its duration */
+static void DoorSeq_applySegment(void){
+	const DoorSeq_SegmentType* segment=&g_profile.segments[g_segment];
+	DcMotor_Rotate((DcMotor_State)segment->direction,segment->duty);
+	g_remaining=segment->duration;
+}
+
+void DoorSeq_start(void(*a_ptr)(void)){
+	DoorSeq_resume(0,g_profile.segments[0].duration,a_ptr);
+}
+
+uint8 DoorSeq_resume(uint8 segment,uint8 remaining,void(*a_ptr)(void)){
+	uint8 i;
+	uint8 code;
+
+	if(segment>=g_profile.segment_count||remaining==0
+			||remaining>g_profile.segments[segment].duration){
+		return ERROR;
+	}
+
+	/* Pins used as end conditions are inputs */
+	for(i=0;i<g_profile.segment_count;i++){
+		code=g_profile.segments[i].end_condition;
+		if(code!=DOOR_END_NONE){
+			GPIO_setupPinDirection(END_PORT(code),END_PIN(code),PIN_INPUT);
+		}
+	}
+
+	g_done_ptr=a_ptr;
+	g_segment=segment;
+	g_running=TRUE;
+	DoorSeq_applySegment();
+	g_remaining=remaining;
+	return SUCCESS;
+}
+
+void DoorSeq_getProgress(uint8 *segment,uint8 *remaining){
+	*segment=g_segment;
+	*remaining=g_remaining;
+}
+
+/* TRUE once the end pin of the running segment reads its level */
+static boolean DoorSeq_isEndReached(void){
+	uint8 code=g_profile.segments[g_segment].end_condition;
+	return (boolean)(code!=DOOR_END_NONE&&GPIO_readPin(END_PORT(code),END_PIN(code))==END_LEVEL(code));
+}
+
+/* Go on with the next segment, or stop the motor after the last one */
+static void DoorSeq_nextSegment(void){
+	g_segment++;
+	if(g_segment<g_profile.segment_count){
+		DoorSeq_applySegment();
+	}
+	else{
+		DcMotor_Rotate(STOP,0);
+		g_running=FALSE;
+		if(g_done_ptr!=NULL_PTR){
+			(*g_done_ptr)();
+		}
+	}
+}
+
+void DoorSeq_tick(void){
+	if(!g_running){
+		return;
+	}
+
+	g_remaining--;
+	if(g_remaining==0||DoorSeq_isEndReached()){
+		DoorSeq_nextSegment();
+	}
+}
+
+boolean DoorSeq_poll(void){
+	if(!g_running||!DoorSeq_isEndReached()){
+		return FALSE;
+	}
+	DoorSeq_nextSegment();
+	return TRUE;
+}
+
+boolean DoorSeq_isRunning(void){
+	return g_running;
+}
@@ -0,0 +1,141 @@
+/*******************************
+ *  door_sequencer.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef DOOR_SEQUENCER_H_
+#define DOOR_SEQUENCER_H_
+
+#include "std_types.h"
+#include "dc_motor.h"
+
+/* Number of profile slots kept in the external EEPROM */
+#define DOOR_MAX_PROFILES       4
+
+/* Maximum number of motion segments in one profile */
+#define DOOR_MAX_SEGMENTS       6
+
+/* First byte of a valid profile record in the EEPROM */
+#define DOOR_PROFILE_MAGIC      0xD5
+
+/* Segment end condition meaning "run for the whole duration" */
+#define DOOR_END_NONE           0xFF
+
+/*
+ * Build a segment end condition that stops the segment early once the
+ * given pin reads the given level (e.g. a limit switch). The segment
+ * duration is then used as a timeout. Pins of the UART, the TWI bus, the
+ * motor and the buzzer cannot be used, a profile naming one is invalid.
+ */
+#define DOOR_END_ON_PIN(PORT,PIN,LEVEL) ((uint8)(((LEVEL)<<6)|((PORT)<<3)|(PIN)))
+
+/* One step of the door motion, 4 bytes in the EEPROM */
+typedef struct {
+	uint8 direction;       /* DcMotor_State of the motor during this segment */
+	uint8 duty;            /* Motor speed in percent */
+	uint8 duration;        /* Length of the segment in sequencer ticks (Timer1 periods) */
+	uint8 end_condition;   /* DOOR_END_NONE or a DOOR_END_ON_PIN() code */
+} DoorSeq_SegmentType;
+
+/* A complete door cycle, executed from the first segment to the last */
+typedef struct {
+	uint8 segment_count;
+	DoorSeq_SegmentType segments[DOOR_MAX_SEGMENTS];
+} DoorSeq_ProfileType;
+
+/*
+ * Description:
+ * Load the active profile from the external EEPROM, the index of the active
+ * profile is kept in the key-value store. If the selector or
+ * the record is invalid the built-in default profile is used instead
+ * (15 ticks opening, 3 ticks hold, 15 ticks closing).
+ *
+ * Returns:
+ *  - SUCCESS if the profile came from the EEPROM, ERROR if the default is used.
+ */
+uint8 DoorSeq_init(void);
+
+/*
+ * Description:
+ * Return the profile that the next door cycle will run.
+ */
+const DoorSeq_ProfileType* DoorSeq_getActiveProfile(void);
+
+/*
+ * Description:
+ * Store a profile in the given EEPROM slot. A profile needs 1 to
+ * DOOR_MAX_SEGMENTS segments, each with a known direction, a duty of at most
+ * 100, a duration and a valid end condition.
+ *
+ * Returns:
+ *  - SUCCESS or ERROR (bad slot, bad profile or bus failure).
+ */
+uint8 DoorSeq_saveProfile(uint8 index,const DoorSeq_ProfileType* Profile_Ptr);
+
+/*
+ * Description:
+ * Make the given slot the active one and load it.
+ *
+ * Returns:
+ *  - SUCCESS or ERROR if the slot does not hold a valid profile or a door
+ *    cycle is running.
+ */
+uint8 DoorSeq_selectProfile(uint8 index);
+
+/*
+ * Description:
+ * Start running the active profile. The first segment is applied at once,
+ * the following ones are advanced by DoorSeq_tick().
+ *
+ * Parameters:
+ *  - a_ptr: Called (from DoorSeq_tick) after the last segment has finished.
+ */
+void DoorSeq_start(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Start running the active profile from the given segment, with the given
+ * number of ticks left in it, e.g. to finish a cycle cut by a reset.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR (nothing started) if the segment or the tick count
+ *    do not fit the active profile.
+ */
+uint8 DoorSeq_resume(uint8 segment,uint8 remaining,void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Give the index of the running segment and the ticks left in it. Once
+ * the cycle is over the index is the segment count.
+ */
+void DoorSeq_getProgress(uint8 *segment,uint8 *remaining);
+
+/*
+ * Description:
+ * Advance the running profile by one tick. Meant to be installed as the
+ * Timer1 callback while the door is moving.
+ */
+void DoorSeq_tick(void);
+
+/*
+ * Description:
+ * Check the end pin of the running segment between ticks, and go on with
+ * the next segment once it reads its level. Meant to be called from the
+ * main loop as often as it runs, with interrupts off: it changes the same
+ * state as DoorSeq_tick.
+ *
+ * Returns:
+ *  - TRUE if the segment ended.
+ */
+boolean DoorSeq_poll(void);
+
+/*
+ * Description:
+ * Return TRUE while a door cycle is running.
+ */
+boolean DoorSeq_isRunning(void);
+
+#endif /* DOOR_SEQUENCER_H_ */
@@ -0,0 +1,32 @@
+/*******************************
+ *  eeprom_map.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef EEPROM_MAP_H_
+#define EEPROM_MAP_H_
+
+/*
+ * Layout of the external 24C16 EEPROM (2 KB, 16-byte pages).
+ * Every region starts on a page boundary so it can be rewritten without
+ * touching its neighbours.
+ */
+
+/* Journaled key-value store, KV_PAGES pages written in rotation (0x0000-0x00FF) */
+#define EEPROM_KV_ADDRESS                   0x0000
+
+/* Door motion profiles, DOOR_MAX_PROFILES slots of DOOR_PROFILE_SLOT_SIZE bytes */
+#define EEPROM_DOOR_PROFILES_ADDRESS        0x0100
+#define DOOR_PROFILE_SLOT_SIZE              32
+
+/* Access audit log, a ring of AUDIT_LOG_RECORDS records (0x0200-0x03FF) */
+#define EEPROM_AUDIT_LOG_ADDRESS            0x0200
+#define EEPROM_AUDIT_LOG_SIZE               0x0200
+
+/* User PIN hash table, CRED_STORE_SLOTS slots of CRED_STORE_SLOT_SIZE bytes (0x0400-0x07FF) */
+#define EEPROM_USERS_ADDRESS                0x0400
+
+#endif /* EEPROM_MAP_H_ */
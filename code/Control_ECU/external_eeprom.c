@@ -6,71 +6,173 @@
  *  Author: Muhannad Abdallah
  ******************************/
 #include"external_eeprom.h"
-#include"twi.h"
+#include"systick.h"
 
-uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data){
-	TWI_start();
-	if(TWI_getStatus()!=TWI_START){
-		return ERROR;
+/* 7-bit bus address of the 24C16, the low 3 bits carry the block bits A8..A10 */
+#define EEPROM_DEVICE_ADDRESS 0x50
+
+/*
+ * SLA+W restarts allowed while the device is busy with a write cycle.
+ * One START + SLA+W + STOP round takes about 40 us at 400 kHz.
+ */
+#define EEPROM_ACK_POLL_RETRIES ((EEPROM_WRITE_TIMEOUT_MS*1000UL)/40)
+
+/* Set when a write is submitted until the device ACKs its address again */
+static boolean g_write_pending=FALSE;
+static uint32 g_write_start=0;
+
+/*
+ * Fill a transaction for the memory location u16addr: the block bits go in the
+ * device address and the low byte is sent as the register byte. A NACK on
+ * SLA+W is retried, so a transaction queued behind a write simply waits for
+ * the write cycle to end (ACK polling done by the TWI interrupt).
+ */
+static void EEPROM_prepare(TWI_TransactionType *Transaction_Ptr,uint16 u16addr,TWI_DirectionType direction,
+		uint8 *u8data,uint16 u16len,void(*a_ptr)(TWI_TransactionType*)){
+	Transaction_Ptr->address=EEPROM_DEVICE_ADDRESS|((u16addr>>8)&0x07);
+	Transaction_Ptr->reg[0]=(uint8)u16addr;
+	Transaction_Ptr->reg_len=1;
+	Transaction_Ptr->direction=direction;
+	Transaction_Ptr->data=u8data;
+	Transaction_Ptr->length=u16len;
+	Transaction_Ptr->nack_retries=EEPROM_ACK_POLL_RETRIES;
+	Transaction_Ptr->probe=FALSE;
+	Transaction_Ptr->callback=a_ptr;
+}
+
+/* Wait for a submitted transaction, a stuck bus fails it after TWI_TIMEOUT_MS */
+static uint8 EEPROM_wait(TWI_TransactionType *Transaction_Ptr){
+	while(Transaction_Ptr->status==TWI_QUEUED||Transaction_Ptr->status==TWI_BUSY)
+	{
+		TWI_service();
 	}
 
-	/*Send the device address, we need to get A8 A9 A10 address bits from the memory location address
-	 * and R/W=0 (write) */
-	TWI_writeByte((uint8)(0xA0|((u16addr&0x0700)>>7)));
-	if(TWI_getStatus()!=TWI_MT_SLA_W_ACK)
-		return ERROR;
+	return (Transaction_Ptr->status==TWI_DONE)?SUCCESS:ERROR;
+}
 
-	/* Send the required memory location address*/
-	TWI_writeByte((uint8)(u16addr));
-	if(TWI_getStatus()!=TWI_MT_DATA_ACK)
+/* Submit a transaction and wait for it, for the blocking API */
+static uint8 EEPROM_run(TWI_TransactionType *Transaction_Ptr){
+	if(TWI_submit(Transaction_Ptr)==ERROR)
 		return ERROR;
 
-	TWI_writeByte(u8data);
-	if(TWI_getStatus()!=TWI_MT_DATA_ACK)
+	return EEPROM_wait(Transaction_Ptr);
+}
+
+static uint8 EEPROM_submitWrite(TWI_TransactionType *Transaction_Ptr){
+	if(TWI_submit(Transaction_Ptr)==ERROR)
 		return ERROR;
 
-	TWI_stop();
+	/* The STOP at the end of the transaction starts the internal write cycle */
+	g_write_pending=TRUE;
+	g_write_start=SysTick_getMillis();
 
 	return SUCCESS;
 }
 
+boolean EEPROM_isWriteInProgress(void){
+	TWI_TransactionType poll;
+
+	if(!g_write_pending)
+		return FALSE;
+
+	/* Writes still queued on the bus */
+	if(!TWI_isIdle())
+		return TRUE;
+
+	/* A single START + SLA+W, the device only ACKs once the cycle is over: a NACK is no error */
+	poll.address=EEPROM_DEVICE_ADDRESS;
+	poll.reg_len=0;
+	poll.direction=TWI_WRITE;
+	poll.length=0;
+	poll.nack_retries=0;
+	poll.probe=TRUE;
+	poll.callback=NULL_PTR;
+	if(EEPROM_run(&poll)==SUCCESS)
+		g_write_pending=FALSE;
+
+	return g_write_pending;
+}
+
+uint8 EEPROM_waitWriteComplete(void){
+	while(EEPROM_isWriteInProgress())
+	{
+		if(SysTick_elapsedSince(g_write_start)>EEPROM_WRITE_TIMEOUT_MS)
+		{
+			g_write_pending=FALSE;
+			return ERROR;
+		}
+	}
+	return SUCCESS;
+}
+
+uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data){
+	return EEPROM_writeBlock(u16addr,&u8data,1);
+}
+
 uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 {
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TWI_START)
-        return ERROR;
-
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR;
-
-    /* Send the required memory location address */
-    TWI_writeByte((uint8)(u16addr));
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
-        return ERROR;
-
-    /* Send the Repeated Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TWI_REP_START)
-        return ERROR;
-
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=1 (Read) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
-    if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
-        return ERROR;
-
-    /* Read Byte from Memory without send ACK */
-    *u8data = TWI_readByteWithNACK();
-    if (TWI_getStatus() != TWI_MR_DATA_NACK)
-        return ERROR;
-
-    /* Send the Stop Bit */
-    TWI_stop();
-
-    return SUCCESS;
+	/* A single byte is a sequential read of length one */
+	return EEPROM_readBlock(u16addr,u8data,1);
+}
+
+uint8 EEPROM_writeBlock(uint16 u16addr,const uint8 *u8data,uint16 u16len)
+{
+	TWI_TransactionType transaction;
+	uint8 chunk;
+
+	if((uint32)u16addr+u16len>EEPROM_SIZE)
+		return ERROR;
+
+	while(u16len>0)
+	{
+		/* Never cross a page boundary, the device would wrap to the start of the page */
+		chunk=EEPROM_PAGE_SIZE-(u16addr&(EEPROM_PAGE_SIZE-1));
+		if(chunk>u16len)
+			chunk=(uint8)u16len;
+
+		/* One transaction per page, each one waits for the previous page by ACK polling */
+		EEPROM_prepare(&transaction,u16addr,TWI_WRITE,(uint8*)u8data,chunk,NULL_PTR);
+		if(EEPROM_submitWrite(&transaction)==ERROR||EEPROM_wait(&transaction)==ERROR)
+			return ERROR;
+
+		u16addr+=chunk;
+		u8data+=chunk;
+		u16len-=chunk;
+	}
+
+	return SUCCESS;
 }
 
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *u8data,uint16 u16len)
+{
+	TWI_TransactionType transaction;
+
+	if(u16len==0)
+		return SUCCESS;
+	if((uint32)u16addr+u16len>EEPROM_SIZE)
+		return ERROR;
+
+	/* Address write, repeated START and a sequential read ACKing all but the last byte */
+	EEPROM_prepare(&transaction,u16addr,TWI_READ,u8data,u16len,NULL_PTR);
+	return EEPROM_run(&transaction);
+}
+
+uint8 EEPROM_readBlockAsync(TWI_TransactionType *Transaction_Ptr,uint16 u16addr,uint8 *u8data,uint16 u16len,
+		void(*a_ptr)(TWI_TransactionType*))
+{
+	if(u16len==0||(uint32)u16addr+u16len>EEPROM_SIZE)
+		return ERROR;
+
+	EEPROM_prepare(Transaction_Ptr,u16addr,TWI_READ,u8data,u16len,a_ptr);
+	return TWI_submit(Transaction_Ptr);
+}
+
+uint8 EEPROM_writePageAsync(TWI_TransactionType *Transaction_Ptr,uint16 u16addr,const uint8 *u8data,uint8 u8len,
+		void(*a_ptr)(TWI_TransactionType*))
+{
+	if(u8len==0||(u16addr&(EEPROM_PAGE_SIZE-1))+u8len>EEPROM_PAGE_SIZE||(uint32)u16addr+u8len>EEPROM_SIZE)
+		return ERROR;
+
+	EEPROM_prepare(Transaction_Ptr,u16addr,TWI_WRITE,(uint8*)u8data,u8len,a_ptr);
+	return EEPROM_submitWrite(Transaction_Ptr);
+}
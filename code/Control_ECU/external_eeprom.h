@@ -9,12 +9,73 @@
 #define EXTERNAL_EEPROM_H_
 
 #include"std_types.h"
+#include"twi.h"
 
-#define ERROR 0
-#define SUCCESS 1
+/* 24C16: 2 KB organised in 16-byte write pages */
+#define EEPROM_SIZE 2048
+#define EEPROM_PAGE_SIZE 16
+
+/* Give up on a write cycle that is not finished after this time (datasheet max is 10 ms) */
+#define EEPROM_WRITE_TIMEOUT_MS 20
 
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
 
 uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
 
+/*
+ * Description:
+ * Write u16len bytes starting at u16addr. The data is split on page
+ * boundaries so every page is programmed in a single bus transaction.
+ * The function returns as soon as the last page is sent, its write cycle
+ * then runs in the background (see EEPROM_isWriteInProgress).
+ */
+uint8 EEPROM_writeBlock(uint16 u16addr,const uint8 *u8data,uint16 u16len);
+
+/*
+ * Description:
+ * Read u16len bytes starting at u16addr in one sequential-read transaction.
+ */
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *u8data,uint16 u16len);
+
+/*
+ * Description:
+ * Return TRUE while the device is still busy with the last write cycle.
+ * Costs a single START + SLA+W poll, so it can be called from a main loop
+ * to do other work while the chip programs its page.
+ */
+boolean EEPROM_isWriteInProgress(void);
+
+/*
+ * Description:
+ * Wait for the last write cycle by acknowledge polling: repeat START + SLA+W
+ * until the device ACKs, which is usually 3-5 ms instead of the 10 ms worst case.
+ * The driver never calls it itself: a transaction queued behind a write
+ * retries its NACKed address until the write cycle ends. A caller must call
+ * it after a write whose data has to be programmed before it goes on, e.g.
+ * a record that must survive a reset (KV_put does), or before sleeping or
+ * resetting on purpose.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the device did not answer within EEPROM_WRITE_TIMEOUT_MS.
+ */
+uint8 EEPROM_waitWriteComplete(void);
+
+/*
+ * Description:
+ * Queue a sequential read on the TWI engine and return at once. The transaction
+ * structure and the buffer must stay valid until a_ptr is called (from the TWI
+ * interrupt) or the transaction status leaves TWI_QUEUED/TWI_BUSY.
+ */
+uint8 EEPROM_readBlockAsync(TWI_TransactionType *Transaction_Ptr,uint16 u16addr,uint8 *u8data,uint16 u16len,
+		void(*a_ptr)(TWI_TransactionType*));
+
+/*
+ * Description:
+ * Queue a write of up to one page on the TWI engine and return at once.
+ * The data must not cross a page boundary. Same lifetime rules as
+ * EEPROM_readBlockAsync.
+ */
+uint8 EEPROM_writePageAsync(TWI_TransactionType *Transaction_Ptr,uint16 u16addr,const uint8 *u8data,uint8 u8len,
+		void(*a_ptr)(TWI_TransactionType*));
+
 #endif /* EXTERNAL_EEPROM_H_ */
@@ -0,0 +1,184 @@
+/*******************************
+ *  kv_store.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "kv_store.h"
+#include "external_eeprom.h"
+#include "eeprom_map.h"
+#include "crc.h"
+
+/* Record layout, one record fills one EEPROM page */
+#define RECORD_SEQ_OFFSET     0
+#define RECORD_KEY_OFFSET     2
+#define RECORD_LENGTH_OFFSET  3
+#define RECORD_VALUE_OFFSET   4
+#define RECORD_CRC_OFFSET     (RECORD_VALUE_OFFSET+KV_VALUE_SIZE)
+#define RECORD_SIZE           EEPROM_PAGE_SIZE
+
+#define NO_PAGE               0xFF
+
+/*
+ * A value older than this many writes is copied forward, so all the records
+ * of the log stay within half the sequence space and compare correctly.
+ */
+#define KV_REFRESH_AGE        0x4000
+
+#define PAGE_ADDRESS(PAGE)    (EEPROM_KV_ADDRESS+(uint16)(PAGE)*RECORD_SIZE)
+#define NEXT_PAGE(PAGE)       (((PAGE)+1)%KV_PAGES)
+
+/* Newest record of every key */
+static uint8 g_page[KV_MAX_KEYS];
+static uint16 g_seq[KV_MAX_KEYS];
+
+/* Page after the newest record of the whole log and the sequence number to use next */
+static uint8 g_next_page=0;
+static uint16 g_next_seq=1;
+
+static void(*g_write_callback_ptr)(KV_KeyType key)=NULL_PTR;
+
+/* Serial number comparison, correct across the 16-bit wrap around */
+static boolean KV_isNewer(uint16 a,uint16 b){
+	return (sint16)(a-b)>0;
+}
+
+static boolean KV_isValid(const uint8 *record){
+	uint16 crc=record[RECORD_CRC_OFFSET]|((uint16)record[RECORD_CRC_OFFSET+1]<<8);
+	return (record[RECORD_KEY_OFFSET]<KV_MAX_KEYS
+			&&record[RECORD_LENGTH_OFFSET]<=KV_VALUE_SIZE
+			&&crc==CRC16_compute(record,RECORD_CRC_OFFSET));
+}
+
+static boolean KV_isLivePage(uint8 page){
+	uint8 key;
+	for(key=0;key<KV_MAX_KEYS;key++){
+		if(g_page[key]==page){
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+uint8 KV_init(void){
+	uint8 record[RECORD_SIZE];
+	uint8 page,key;
+	uint16 seq;
+	boolean found=FALSE;
+	uint16 newest_seq=0;
+
+	for(key=0;key<KV_MAX_KEYS;key++){
+		g_page[key]=NO_PAGE;
+	}
+	g_next_page=0;
+	g_next_seq=1;
+
+	for(page=0;page<KV_PAGES;page++){
+		if(EEPROM_readBlock(PAGE_ADDRESS(page),record,RECORD_SIZE)==ERROR){
+			return ERROR;
+		}
+		if(!KV_isValid(record)){
+			continue;
+		}
+		key=record[RECORD_KEY_OFFSET];
+		seq=record[RECORD_SEQ_OFFSET]|((uint16)record[RECORD_SEQ_OFFSET+1]<<8);
+		if(g_page[key]==NO_PAGE||KV_isNewer(seq,g_seq[key])){
+			g_page[key]=page;
+			g_seq[key]=seq;
+		}
+		if(!found||KV_isNewer(seq,newest_seq)){
+			found=TRUE;
+			newest_seq=seq;
+			g_next_page=NEXT_PAGE(page);
+			g_next_seq=seq+1;
+		}
+	}
+	return SUCCESS;
+}
+
+/* Read and check the newest record of a key */
+static uint8 KV_readRecord(KV_KeyType key,uint8 *record){
+	if(key>=KV_MAX_KEYS||g_page[key]==NO_PAGE){
+		return ERROR;
+	}
+	if(EEPROM_readBlock(PAGE_ADDRESS(g_page[key]),record,RECORD_SIZE)==ERROR||!KV_isValid(record)){
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+uint8 KV_get(KV_KeyType key,uint8 *value,uint8 length){
+	uint8 record[RECORD_SIZE];
+	uint8 i;
+
+	if(KV_readRecord(key,record)==ERROR){
+		return ERROR;
+	}
+	if(length>record[RECORD_LENGTH_OFFSET]){
+		length=record[RECORD_LENGTH_OFFSET];
+	}
+	for(i=0;i<length;i++){
+		value[i]=record[RECORD_VALUE_OFFSET+i];
+	}
+	return SUCCESS;
+}
+
+uint8 KV_put(KV_KeyType key,const uint8 *value,uint8 length){
+	uint8 record[RECORD_SIZE];
+	uint16 crc;
+	uint8 page;
+	uint8 i;
+
+	if(key>=KV_MAX_KEYS||length>KV_VALUE_SIZE){
+		return ERROR;
+	}
+
+	/* Next page that does not hold the newest value of a key, there is always one */
+	page=g_next_page;
+	while(KV_isLivePage(page)){
+		page=NEXT_PAGE(page);
+	}
+
+	record[RECORD_SEQ_OFFSET]=(uint8)g_next_seq;
+	record[RECORD_SEQ_OFFSET+1]=(uint8)(g_next_seq>>8);
+	record[RECORD_KEY_OFFSET]=key;
+	record[RECORD_LENGTH_OFFSET]=length;
+	for(i=0;i<KV_VALUE_SIZE;i++){
+		record[RECORD_VALUE_OFFSET+i]=(i<length)?value[i]:0xFF;
+	}
+	crc=CRC16_compute(record,RECORD_CRC_OFFSET);
+	record[RECORD_CRC_OFFSET]=(uint8)crc;
+	record[RECORD_CRC_OFFSET+1]=(uint8)(crc>>8);
+
+	/* The whole record is one page program: it is either all there or fails its CRC */
+	if(EEPROM_writeBlock(PAGE_ADDRESS(page),record,RECORD_SIZE)==ERROR
+			||EEPROM_waitWriteComplete()==ERROR){
+		return ERROR;
+	}
+
+	g_page[key]=page;
+	g_seq[key]=g_next_seq;
+	g_next_seq++;
+	g_next_page=NEXT_PAGE(page);
+
+	if(g_write_callback_ptr!=NULL_PTR){
+		(*g_write_callback_ptr)(key);
+	}
+
+	/* Copy forward values that were not written for a long time */
+	for(i=0;i<KV_MAX_KEYS;i++){
+		if(g_page[i]!=NO_PAGE&&(uint16)(g_next_seq-g_seq[i])>=KV_REFRESH_AGE){
+			if(KV_readRecord((KV_KeyType)i,record)==ERROR
+					||KV_put((KV_KeyType)i,&record[RECORD_VALUE_OFFSET],record[RECORD_LENGTH_OFFSET])==ERROR){
+				return ERROR;
+			}
+		}
+	}
+	return SUCCESS;
+}
+
+void KV_setWriteCallBack(void(*a_ptr)(KV_KeyType key)){
+	g_write_callback_ptr=a_ptr;
+}
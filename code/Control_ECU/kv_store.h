@@ -0,0 +1,75 @@
+/*******************************
+ *  kv_store.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef KV_STORE_H_
+#define KV_STORE_H_
+
+#include "std_types.h"
+
+/*
+ * Log-structured key-value store: every KV_put() appends a complete record
+ * (sequence number, key, value, CRC) as one page program on the next free
+ * page of the region. Pages holding the latest value of a key are skipped,
+ * so writes rotate over the other pages and no cell is rewritten in place.
+ * A reset mid-write leaves a record with a bad CRC, the previous value of
+ * the key is still the latest valid one.
+ */
+
+/* Number of pages of the log, one record per page */
+#define KV_PAGES        16
+
+/* Largest value of a record: page size minus sequence, key, length and CRC */
+#define KV_VALUE_SIZE   10
+
+/* Keys of the values kept in the store */
+typedef enum {
+	KV_KEY_CREDENTIALS,     /* Credential record of the credential cache */
+	KV_KEY_DOOR_PROFILE,    /* Index of the active door profile */
+	KV_KEY_SETTINGS,        /* Wrong attempt limit and alarm duration */
+	KV_KEY_LINK_COUNTER,    /* Handshake counter of the secure link nonces */
+	KV_MAX_KEYS
+} KV_KeyType;
+
+/*
+ * Description:
+ * Scan the log once, keeping the page of the newest valid record of every key
+ * and the position of the next write.
+ */
+uint8 KV_init(void);
+
+/*
+ * Description:
+ * Read the latest value of a key.
+ *
+ * Parameters:
+ *  - key: Key to read.
+ *  - value: Buffer receiving up to length bytes.
+ *  - length: Size of the buffer.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the key has never been written or the read failed.
+ */
+uint8 KV_get(KV_KeyType key,uint8 *value,uint8 length);
+
+/*
+ * Description:
+ * Append a new value of a key as a single page program.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the value is too long or the write failed.
+ */
+uint8 KV_put(KV_KeyType key,const uint8 *value,uint8 length);
+
+/*
+ * Description:
+ * Set a function called after every successful KV_put(), e.g. so a cache
+ * of a key can be invalidated when someone else writes it.
+ */
+void KV_setWriteCallBack(void(*a_ptr)(KV_KeyType key));
+
+#endif /* KV_STORE_H_ */
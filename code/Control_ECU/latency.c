@@ -0,0 +1,52 @@
+/*******************************
+ *  latency.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "latency.h"
+#include "systick.h"
+#include "link.h"
+#include <string.h>
+
+typedef struct {
+	uint16 key;
+	uint32 micros[LATENCY_STAGES];
+} Latency_RecordType;
+
+static Latency_RecordType g_records[LATENCY_RECORDS];
+static uint8 g_current=0;
+static uint8 g_count=0;
+
+void Latency_mark(Latency_StageType stage){
+	if(stage==0){
+		g_current=(g_current+1)%LATENCY_RECORDS;
+		if(g_count<LATENCY_RECORDS){
+			g_count++;
+		}
+		memset(&g_records[g_current],0,sizeof(Latency_RecordType));
+	}
+	else if(g_count==0){
+		return;
+	}
+	g_records[g_current].micros[stage]=SysTick_getMicros();
+}
+
+void Latency_setKey(uint16 key){
+	g_records[g_current].key=key;
+}
+
+void Latency_dump(void){
+	uint8 header[2]={LATENCY_STAGES,g_count};
+	uint8 i;
+	uint8 index=(uint8)(g_current+LATENCY_RECORDS+1-g_count)%LATENCY_RECORDS;
+
+	LINK_sendFrame(LINK_DIAG_LATENCY,header,sizeof(header));
+	for(i=0;i<g_count;i++){
+		LINK_sendFrame(LINK_DIAG_LATENCY,(const uint8*)&g_records[index],sizeof(Latency_RecordType));
+		index=(index+1)%LATENCY_RECORDS;
+	}
+	LINK_sendFrame(LINK_DIAG_LATENCY,header,0);
+}
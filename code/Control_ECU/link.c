@@ -0,0 +1,136 @@
+/*******************************
+ *  link.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "link.h"
+#include "uart.h"
+#include "seclink.h"
+#include "crc.h"
+
+typedef struct {
+	uint8 command;
+	void (*handler)(void);
+} LINK_DiagEntryType;
+
+typedef struct {
+	uint8 command;
+	void (*handler)(const uint8 *args,uint8 length);
+} LINK_ProvisionEntryType;
+
+static LINK_DiagEntryType g_diag[LINK_MAX_DIAG_COMMANDS];
+static uint8 g_diag_count=0;
+
+static LINK_ProvisionEntryType g_provision[LINK_MAX_PROVISION_COMMANDS];
+static uint8 g_provision_count=0;
+
+static void LINK_serveDiag(uint8 command){
+	uint8 i;
+	for(i=0;i<g_diag_count;i++){
+		if(g_diag[i].command==command){
+			(*g_diag[i].handler)();
+			return;
+		}
+	}
+	LINK_sendFrame(LINK_DIAG_UNKNOWN,&command,1);
+}
+
+/* LINK_PROVISION_REQUEST received, the rest of the request is the rest of its message */
+static void LINK_serveProvision(void){
+	uint8 request[SECLINK_MAX_PAYLOAD];
+	uint8 length=SecLink_getPendingCount();
+	uint8 i;
+
+	for(i=0;i<length;i++){
+		request[i]=SecLink_receiveByte();
+	}
+	if(length==0){
+		return;
+	}
+	for(i=0;i<g_provision_count;i++){
+		if(g_provision[i].command==request[0]){
+			(*g_provision[i].handler)(&request[1],length-1);
+			return;
+		}
+	}
+	LINK_sendProvisionAnswer(request[0],ERROR,NULL_PTR,0);
+}
+
+/* Byte received outside the secure link frames, a request cut short is dropped */
+static void LINK_onRawByte(uint8 data){
+	uint8 command;
+	if(data==LINK_DIAG_REQUEST&&SecLink_receiveRaw(&command)){
+		LINK_serveDiag(command);
+	}
+}
+
+void LINK_init(void){
+	SecLink_setRawHandler(&LINK_onRawByte);
+}
+
+void LINK_waitFor(uint8 token){
+	uint8 data;
+	while((data=SecLink_receiveByte())!=token){
+		if(data==LINK_PROVISION_REQUEST){
+			LINK_serveProvision();
+		}
+	}
+}
+
+uint8 LINK_registerDiag(uint8 command,void(*a_ptr)(void)){
+	if(g_diag_count==LINK_MAX_DIAG_COMMANDS||a_ptr==NULL_PTR){
+		return ERROR;
+	}
+	g_diag[g_diag_count].command=command;
+	g_diag[g_diag_count].handler=a_ptr;
+	g_diag_count++;
+	return SUCCESS;
+}
+
+uint8 LINK_registerProvision(uint8 command,void(*a_ptr)(const uint8 *args,uint8 length)){
+	if(g_provision_count==LINK_MAX_PROVISION_COMMANDS||a_ptr==NULL_PTR){
+		return ERROR;
+	}
+	g_provision[g_provision_count].command=command;
+	g_provision[g_provision_count].handler=a_ptr;
+	g_provision_count++;
+	return SUCCESS;
+}
+
+void LINK_setIdleCallBack(void(*a_ptr)(void)){
+	SecLink_setIdleCallBack(a_ptr);
+}
+
+void LINK_sendFrame(uint8 command,const uint8 *data,uint8 length){
+	uint8 i;
+	uint16 crc=CRC16_update(CRC16_update(CRC16_INIT,command),length);
+
+	UART_sendByte(LINK_FRAME_START);
+	UART_sendByte(command);
+	UART_sendByte(length);
+	for(i=0;i<length;i++){
+		UART_sendByte(data[i]);
+		crc=CRC16_update(crc,data[i]);
+	}
+	UART_sendByte((uint8)crc);
+	UART_sendByte((uint8)(crc>>8));
+}
+
+void LINK_sendProvisionAnswer(uint8 command,uint8 result,const uint8 *data,uint8 length){
+	uint8 message[SECLINK_MAX_PAYLOAD];
+	uint8 i;
+
+	if(length>SECLINK_MAX_PAYLOAD-3){
+		return;
+	}
+	message[0]=LINK_PROVISION_REQUEST;
+	message[1]=command;
+	message[2]=result;
+	for(i=0;i<length;i++){
+		message[3+i]=data[i];
+	}
+	SecLink_send(message,length+3);
+}
@@ -0,0 +1,127 @@
+/*******************************
+ *  link.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include "std_types.h"
+
+/*
+ * The HMI messages travel over the secure link (seclink.h). A maintenance
+ * tool plugged in place of the HMI sends LINK_DIAG_REQUEST followed by a
+ * command byte in clear, between secure link frames. The answer, also in
+ * clear, is one or more frames:
+ *
+ *   LINK_FRAME_START, command, length, length data bytes, CRC-16 (low byte first)
+ *
+ * The CRC covers the command, the length and the data. A stream of frames
+ * is ended by a frame of the same command with no data bytes, unless the
+ * command documents an end frame payload.
+ *
+ * Requests that change stored data (provisioning) carry the system password
+ * and PINs, so they never travel in clear: the maintenance tool runs the
+ * secure link handshake in place of the HMI (tools/seclink.py) and sends
+ * the request as one message:
+ *
+ *   LINK_PROVISION_REQUEST, command, system password, arguments
+ *
+ * It is served while CONTROL_ECU waits for the HMI (LINK_waitFor). The
+ * answer is one message: LINK_PROVISION_REQUEST, command, SUCCESS or ERROR,
+ * then the command's own data. A request of the wrong length is refused.
+ */
+#define LINK_DIAG_REQUEST       0xD1
+#define LINK_FRAME_START        0xD2
+#define LINK_PROVISION_REQUEST  0xD3
+
+/* Maximum number of diagnostic commands that can be registered */
+#define LINK_MAX_DIAG_COMMANDS  20
+
+/* Diagnostic commands */
+#define LINK_DIAG_AUDIT_LOG     0x01   /* Stream the access audit log, oldest record first */
+#define LINK_DIAG_HASH_BENCH    0x02   /* Time the password check, see CredCache_benchmark */
+#define LINK_DIAG_LINK_BENCH    0x03   /* Time the secure link, see SecLink_benchmark */
+#define LINK_DIAG_BOOT_TIME     0x04   /* Milliseconds from reset to the first step sent to the HMI (uint32), then that step */
+#define LINK_DIAG_BOOT_PROFILE  0x05   /* Boot phase timestamps, see BootProfile_dump */
+#define LINK_DIAG_RESET_CAUSE   0x06   /* MCUCSR reset cause bits, then the step, phase, segment and ticks left found in the breadcrumb */
+#define LINK_DIAG_SUPERVISOR    0x07   /* Task that missed its deadline and maximum task latencies, see Supervisor_dump */
+#define LINK_DIAG_POWER         0x08   /* Time spent asleep, see Power_dump */
+#define LINK_DIAG_PROFILE       0x09   /* Sampling profiler histogram, profiling builds only, see Profiler_dump */
+#define LINK_DIAG_TRACE         0x0A   /* Event trace ring, tracing builds only, see Trace_dump */
+#define LINK_DIAG_LOG           0x0B   /* Deferred-format log messages, logging builds only, see Log_dump */
+#define LINK_DIAG_RAM           0x0C   /* Section sizes, stack high-water mark and free SRAM, see RamUsage_dump */
+#define LINK_DIAG_LATENCY       0x0D   /* Stage timestamps of the last password checks, see Latency_dump */
+#define LINK_DIAG_METRICS       0x0E   /* Snapshot of the counters and gauges, see Metrics_dump */
+
+/* Command byte of the frame sent back for an unknown command, its data is the command */
+#define LINK_DIAG_UNKNOWN       0xFF
+
+/* Maximum number of provisioning commands that can be registered */
+#define LINK_MAX_PROVISION_COMMANDS  4
+
+/* Provisioning commands, the arguments follow the system password */
+#define LINK_PROVISION_USER_ADD       0x0F   /* PIN (5 digits) and role of a new user, answers its slot */
+#define LINK_PROVISION_USER_REVOKE    0x10   /* Slot of the user to revoke */
+#define LINK_PROVISION_PROFILE_SAVE   0x11   /* Door profile slot, segment count and segments (4 bytes each) */
+#define LINK_PROVISION_PROFILE_SELECT 0x12   /* Door profile slot the next cycles run */
+
+/*
+ * Description:
+ * Take the bytes received outside the secure link frames, to serve the
+ * diagnostic requests.
+ */
+void LINK_init(void);
+
+/*
+ * Description:
+ * Wait until the given byte is received from the HMI. Diagnostic and
+ * provisioning requests received meanwhile are served, other bytes are
+ * dropped. The idle callback is called while no byte is waiting.
+ */
+void LINK_waitFor(uint8 token);
+
+/*
+ * Description:
+ * Set the function called when the given diagnostic command is received.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the table is full.
+ */
+uint8 LINK_registerDiag(uint8 command,void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Set the function called with the arguments (system password first) when
+ * the given provisioning command is received. It must answer with
+ * LINK_sendProvisionAnswer.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the table is full.
+ */
+uint8 LINK_registerProvision(uint8 command,void(*a_ptr)(const uint8 *args,uint8 length));
+
+/*
+ * Description:
+ * Set a function called repeatedly while waiting for a message from the
+ * HMI, in LINK_waitFor or SecLink_receiveByte.
+ */
+void LINK_setIdleCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Send one diagnostic frame.
+ */
+void LINK_sendFrame(uint8 command,const uint8 *data,uint8 length);
+
+/*
+ * Description:
+ * Send the answer to a provisioning request over the secure link, length
+ * data bytes after the result.
+ */
+void LINK_sendProvisionAnswer(uint8 command,uint8 result,const uint8 *data,uint8 length);
+
+#endif /* LINK_H_ */
@@ -0,0 +1,118 @@
+/*******************************
+ *  log.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "log.h"
+
+#if LOG_LEVEL>LOG_LEVEL_NONE
+
+#include "systick.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/* Bytes of a message before its arguments: id, level and count, milliseconds */
+#define LOG_HEADER_SIZE  4
+
+/* Messages are never overwritten, a full buffer drops the new ones */
+static uint8 g_buffer[LOG_BUFFER_SIZE];
+static uint8 g_head=0;          /* First byte of the oldest message */
+static uint8 g_used=0;
+static uint16 g_dropped=0;
+
+/* Append one byte, interrupts must be off and the space checked */
+static void Log_put(uint8 data){
+	uint16 index=(uint16)g_head+g_used;
+	if(index>=LOG_BUFFER_SIZE){
+		index-=LOG_BUFFER_SIZE;
+	}
+	g_buffer[index]=data;
+	g_used++;
+}
+
+/* Remove the oldest byte, interrupts must be off */
+static uint8 Log_get(void){
+	uint8 data=g_buffer[g_head];
+	g_head=(g_head+1==LOG_BUFFER_SIZE)?0:g_head+1;
+	g_used--;
+	return data;
+}
+
+void Log_write(uint8 level,uint8 id,const uint16 *args,uint8 count){
+	uint16 millis;
+	uint8 i;
+	uint8 sreg=SREG;
+
+	if(count>LOG_MAX_ARGS){
+		count=LOG_MAX_ARGS;
+	}
+	cli();
+	if((uint16)g_used+LOG_HEADER_SIZE+2*count>LOG_BUFFER_SIZE){
+		g_dropped++;
+	}
+	else{
+		millis=(uint16)SysTick_getMillis();
+		Log_put(id);
+		Log_put((uint8)((level<<4)|count));
+		Log_put((uint8)millis);
+		Log_put((uint8)(millis>>8));
+		for(i=0;i<count;i++){
+			Log_put((uint8)args[i]);
+			Log_put((uint8)(args[i]>>8));
+		}
+	}
+	SREG=sreg;
+}
+
+void Log_dump(void){
+	uint8 frame[LOG_FRAME_SIZE];
+	uint32 millis;
+	uint16 dropped;
+	uint8 pending;
+	uint8 length;
+	uint8 size;
+	uint8 i;
+	uint8 sreg=SREG;
+
+	cli();
+	millis=SysTick_getMillis();
+	dropped=g_dropped;
+	g_dropped=0;
+	pending=g_used;
+	SREG=sreg;
+	frame[0]=(uint8)millis;
+	frame[1]=(uint8)(millis>>8);
+	frame[2]=(uint8)(millis>>16);
+	frame[3]=(uint8)(millis>>24);
+	frame[4]=(uint8)dropped;
+	frame[5]=(uint8)(dropped>>8);
+	LINK_sendFrame(LINK_DIAG_LOG,frame,6);
+
+	/* Only the messages present now, the ones logged meanwhile go to the next dump */
+	length=0;
+	while(pending!=0){
+		sreg=SREG;
+		cli();
+		size=LOG_HEADER_SIZE+2*(g_buffer[(g_head+1==LOG_BUFFER_SIZE)?0:g_head+1]&0x0F);
+		if(length+size<=LOG_FRAME_SIZE){
+			for(i=0;i<size;i++){
+				frame[length++]=Log_get();
+			}
+			pending-=size;
+			size=0;
+		}
+		SREG=sreg;
+		/* The next message does not fit, or it was the last one */
+		if(size!=0||pending==0){
+			LINK_sendFrame(LINK_DIAG_LOG,frame,length);
+			length=0;
+		}
+	}
+	LINK_sendFrame(LINK_DIAG_LOG,frame,0);
+}
+
+#endif /* LOG_LEVEL>LOG_LEVEL_NONE */
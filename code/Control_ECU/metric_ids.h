@@ -0,0 +1,39 @@
+/*******************************
+ *  metric_ids.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef METRIC_IDS_H_
+#define METRIC_IDS_H_
+
+/*
+ * Metrics of both ECUs: X(id, kind, "name"), kind is COUNTER (counts
+ * events, wraps at 65535) or GAUGE (a level or a high-water mark). A
+ * metric not updated by an ECU stays 0 there. tools/metrics.py reads this
+ * list to name the values, keep one metric per line and add new ones at
+ * the end.
+ */
+#define METRIC_ID_LIST(X) \
+	X(METRIC_UNLOCKS,           COUNTER, "unlocks")                 /* Door opened (CONTROL) */ \
+	X(METRIC_WRONG_PASSWORDS,   COUNTER, "wrong passwords")         /* User or admin password refused (CONTROL) */ \
+	X(METRIC_LOCKOUTS,          COUNTER, "lockouts")                /* Alarms started (CONTROL) */ \
+	X(METRIC_UART_ERRORS,       COUNTER, "uart errors")             /* Bytes received with a framing, overrun or parity error */ \
+	X(METRIC_LINK_REJECTED,     COUNTER, "link frames rejected")    /* Secure link frames failing the tag or too long */ \
+	X(METRIC_HANDSHAKES,        COUNTER, "handshakes")              /* Secure link sessions started */ \
+	X(METRIC_EEPROM_RETRIES,    COUNTER, "eeprom retries")          /* Addressing NACKs retried while the EEPROM writes (CONTROL) */ \
+	X(METRIC_TWI_FAILURES,      COUNTER, "i2c failures")            /* I2C transactions ended with TWI_FAILED (CONTROL) */ \
+	X(METRIC_TWI_QUEUE_MAX,     GAUGE,   "i2c queue high-water")    /* Most I2C transactions queued at once (CONTROL) */ \
+	X(METRIC_TIMER1_ISR_MAX_US, GAUGE,   "timer1 isr max us")       /* Longest Timer1 interrupt, callback included; SysTick stalls in an ISR, values past 1000 read low */ \
+	X(METRIC_WAKEUPS,           COUNTER, "standby wake-ups")        /* Power-down left for a key or the link (HMI) */
+
+#define METRIC_ID_ENUM(ID,KIND,NAME) ID,
+
+typedef enum {
+	METRIC_ID_LIST(METRIC_ID_ENUM)
+	METRIC_COUNT
+}Metrics_IdType;
+
+#endif /* METRIC_IDS_H_ */
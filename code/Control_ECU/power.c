@@ -0,0 +1,63 @@
+/*******************************
+ *  power.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "power.h"
+#include "systick.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/* Time asleep, whole milliseconds plus the microseconds not yet folded in */
+static uint32 g_asleep_ms=0;
+static uint16 g_asleep_us=0;
+
+/* Counters at the previous Power_dump */
+static uint32 g_last_millis=0;
+static uint32 g_last_asleep_ms=0;
+
+/* asleep*100/total, without the 32-bit overflow of asleep*100 after 12 hours */
+static uint8 Power_percent(uint32 asleep,uint32 total){
+	total/=100;
+	if(total==0||asleep>=total*100){
+		return (total==0)?0:100;
+	}
+	return (uint8)(asleep/total);
+}
+
+void Power_init(void){
+	ACSR|=(1<<ACD);
+	set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void Power_idle(void){
+	uint32 start=SysTick_getMicros();
+
+	sleep_mode();
+
+	g_asleep_us+=(uint16)(SysTick_getMicros()-start);
+	while(g_asleep_us>=1000){
+		g_asleep_us-=1000;
+		g_asleep_ms++;
+	}
+}
+
+void Power_dump(void){
+	uint8 frame[6];
+	uint32 millis=SysTick_getMillis();
+
+	frame[0]=Power_percent(g_asleep_ms,millis);
+	frame[1]=Power_percent(g_asleep_ms-g_last_asleep_ms,millis-g_last_millis);
+	frame[2]=(uint8)g_asleep_ms;
+	frame[3]=(uint8)(g_asleep_ms>>8);
+	frame[4]=(uint8)(g_asleep_ms>>16);
+	frame[5]=(uint8)(g_asleep_ms>>24);
+	g_last_millis=millis;
+	g_last_asleep_ms=g_asleep_ms;
+	LINK_sendFrame(LINK_DIAG_POWER,frame,sizeof(frame));
+}
@@ -0,0 +1,39 @@
+/*******************************
+ *  power.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "std_types.h"
+
+/*
+ * Description:
+ * Select the idle sleep mode and switch off the analog comparator, which
+ * is not used. Idle is the only mode that keeps the Timer0 PWM, the Timer1
+ * ticks and SysTick running, the deeper modes stop the I/O clock.
+ */
+void Power_init(void);
+
+/*
+ * Description:
+ * Sleep until the next interrupt, at most one SysTick period (1 ms), and
+ * add the time asleep to the duty cycle counter. Meant to be called from
+ * a loop that has nothing else to do.
+ */
+void Power_idle(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_POWER: send one frame holding the
+ * percentage of time spent asleep since boot and since the previous
+ * request (uint8, uint8), then the total time asleep in milliseconds
+ * (uint32).
+ */
+void Power_dump(void);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,64 @@
+/*******************************
+ *  profiler.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "std_types.h"
+
+/*
+ * Sampling profiler, for profiling builds only: build with
+ * -DPROFILER_ENABLED=1, the module is empty otherwise.
+ *
+ * The Timer0 overflow interrupt (F_CPU/8/256, about 3.9 kHz, Timer0 also
+ * drives a PWM output) reads the interrupted program address from the
+ * stack and counts it in a histogram of PROFILER_BUCKETS buckets of
+ * 2^PROFILER_BUCKET_SHIFT bytes, starting at PROFILER_BASE. Samples outside
+ * the range are only counted. ISRs are not interrupted, a sample falling
+ * due in one is taken when it returns and charged to the code it
+ * interrupted.
+ *
+ * tools/profile.py reads the histogram and maps the buckets to functions
+ * with the .elf or .map of the same build.
+ */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED        0
+#endif
+
+/* Whole flash by default, narrow the range to zoom into one module */
+#ifndef PROFILER_BASE
+#define PROFILER_BASE           0x0000
+#endif
+#ifndef PROFILER_BUCKET_SHIFT
+#define PROFILER_BUCKET_SHIFT   8
+#endif
+#define PROFILER_BUCKETS        128
+
+/* Buckets sent in one diagnostic frame */
+#define PROFILER_FRAME_BUCKETS  24
+
+/*
+ * Description:
+ * Clear the histogram and start sampling. Timer0 is started in normal
+ * mode if it is not running yet, a later PWM start keeps its clock.
+ */
+void Profiler_init(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_PROFILE: send the histogram and clear it,
+ * sampling is paused meanwhile. Frames:
+ *  - header: base address (uint16), bucket shift (uint8), bucket count
+ *    (uint8), samples taken (uint32), samples outside the range (uint32)
+ *  - buckets: index of the first bucket (uint8), then up to
+ *    PROFILER_FRAME_BUCKETS counts (uint16 each)
+ *  - end: no data
+ */
+void Profiler_dump(void);
+
+#endif /* PROFILER_H_ */
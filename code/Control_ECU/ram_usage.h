@@ -0,0 +1,47 @@
+/*******************************
+ *  ram_usage.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef RAM_USAGE_H_
+#define RAM_USAGE_H_
+
+#include "std_types.h"
+
+/*
+ * SRAM layout (avr-libc linker script), from the bottom up: .data, .bss,
+ * .noinit, then free RAM up to RAMEND where the stack starts and grows
+ * down. There is no heap, malloc is not used.
+ *
+ * Before main, even before the stack pointer is set, the code in .init1
+ * fills the free RAM with RAM_USAGE_CANARY. The deepest stack byte still
+ * holding another value marks the high-water mark. A stack byte that
+ * happens to be written with the canary value is missed, the mark may be
+ * a few bytes short.
+ */
+#define RAM_USAGE_CANARY    0xC5
+
+/*
+ * Description:
+ * Return the most stack used since reset, in bytes.
+ */
+uint16 RamUsage_getStackHighWater(void);
+
+/*
+ * Description:
+ * Return the bytes between the end of .noinit and the stack pointer.
+ */
+uint16 RamUsage_getFree(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_RAM: send one frame holding the sizes
+ * of .data, .bss and .noinit, the stack high-water mark, the free RAM the
+ * stack never reached and the free RAM now (uint16 each, bytes).
+ */
+void RamUsage_dump(void);
+
+#endif /* RAM_USAGE_H_ */
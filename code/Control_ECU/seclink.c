@@ -0,0 +1,392 @@
+/*******************************
+ *  seclink.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "seclink.h"
+#include "speck.h"
+#include "uart.h"
+#include "trace.h"
+#include "metrics.h"
+#include "kv_store.h"
+#include "systick.h"
+#include "link.h"
+#include <util/delay.h>
+#include <string.h>
+
+#define SECLINK_ROLE        SECLINK_ROLE_CONTROL
+#define SECLINK_PEER_ROLE   SECLINK_ROLE_HMI
+
+typedef struct {
+	Speck_KeyType enc_key;
+	Speck_KeyType mac_key;
+	uint32 tx_counter;
+	uint32 rx_counter;
+	boolean established;
+} SecLink_SessionType;
+
+static const uint8 g_pairing_key[SPECK_KEY_SIZE]=SECLINK_PAIRING_KEY;
+
+static SecLink_SessionType g_session;
+
+/* Payload of the last authenticated frame, handed out byte by byte */
+static uint8 g_rx_buffer[SECLINK_MAX_PAYLOAD];
+static uint8 g_rx_length=0;
+static uint8 g_rx_position=0;
+
+/* Nonce of the last HELLO answered, a repeated HELLO is not answered again */
+static uint8 g_hello_nonce[SECLINK_NONCE_SIZE];
+
+/* Frames in a row failing the tag */
+static uint8 g_rejected=0;
+
+/* Last counter handed out, and the last one reserved in the key-value store */
+static uint32 g_counter=0;
+static uint32 g_counter_end=0;
+
+static void(*g_raw_ptr)(uint8 data)=NULL_PTR;
+static void(*g_session_ptr)(void)=NULL_PTR;
+static void(*g_idle_ptr)(void)=NULL_PTR;
+
+/* Block holding a message counter, the sender and one byte of context */
+static void SecLink_header(uint8 *block,uint32 counter,uint8 sender,uint8 context){
+	memcpy(block,&counter,4);
+	block[4]=sender;
+	block[5]=context;
+	block[6]=0;
+	block[7]=0;
+}
+
+/* Counter mode, keystream block i is the encrypted header with context i */
+static void SecLink_crypt(uint32 counter,uint8 sender,uint8 *data,uint8 length){
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	for(i=0;i<length;i++){
+		if((i&(SPECK_BLOCK_SIZE-1))==0){
+			SecLink_header(block,counter,sender,i/SPECK_BLOCK_SIZE);
+			Speck_encrypt(&g_session.enc_key,block);
+		}
+		data[i]^=block[i&(SPECK_BLOCK_SIZE-1)];
+	}
+}
+
+/* CBC-MAC of the header (context = length) and the zero padded ciphertext */
+static void SecLink_mac(uint32 counter,uint8 sender,const uint8 *data,uint8 length,uint8 *tag){
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	SecLink_header(block,counter,sender,length);
+	Speck_encrypt(&g_session.mac_key,block);
+	for(i=0;i<length;i++){
+		block[i&(SPECK_BLOCK_SIZE-1)]^=data[i];
+		if((i&(SPECK_BLOCK_SIZE-1))==SPECK_BLOCK_SIZE-1||i==length-1){
+			Speck_encrypt(&g_session.mac_key,block);
+		}
+	}
+	memcpy(tag,block,SECLINK_TAG_SIZE);
+}
+
+static void SecLink_deriveKeys(const uint8 *hmi_nonce,const uint8 *control_nonce){
+	uint8 key[SPECK_KEY_SIZE];
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	uint8 j;
+
+	/* The pairing key is expanded where the MAC key goes, it is overwritten last */
+	Speck_expandKey(&g_session.mac_key,g_pairing_key);
+
+	/* Output i = CBC-MAC(i, HMI nonce, CONTROL nonce), 0-1 form the encryption key, 2-3 the MAC key */
+	for(i=0;i<4;i++){
+		memset(block,0,SPECK_BLOCK_SIZE);
+		block[0]=i;
+		Speck_encrypt(&g_session.mac_key,block);
+		for(j=0;j<SECLINK_NONCE_SIZE;j++){
+			block[j]^=hmi_nonce[j];
+		}
+		Speck_encrypt(&g_session.mac_key,block);
+		for(j=0;j<SECLINK_NONCE_SIZE;j++){
+			block[j]^=control_nonce[j];
+		}
+		Speck_encrypt(&g_session.mac_key,block);
+		memcpy(&key[(i&1)*SPECK_BLOCK_SIZE],block,SPECK_BLOCK_SIZE);
+		if(i==1){
+			Speck_expandKey(&g_session.enc_key,key);
+		}
+	}
+	Speck_expandKey(&g_session.mac_key,key);
+
+	g_session.tx_counter=0;
+	g_session.rx_counter=0;
+	g_session.established=TRUE;
+	g_rejected=0;
+	g_rx_length=0;
+	g_rx_position=0;
+}
+
+/*
+ * Counters never repeat: each one is reserved in the key-value store before
+ * use, SECLINK_COUNTER_BLOCK at a time. A block is reserved again once its
+ * last counter is used, so the next handshake answers without an EEPROM write.
+ */
+static void SecLink_reserveCounters(void){
+	if(g_counter==g_counter_end){
+		g_counter_end=g_counter+SECLINK_COUNTER_BLOCK;
+		KV_put(KV_KEY_LINK_COUNTER,(const uint8*)&g_counter_end,sizeof(g_counter_end));
+	}
+}
+
+static uint32 SecLink_nextCounter(void){
+	g_counter++;
+	return g_counter;
+}
+
+/* The nonce must never repeat for the pairing key: the counter plus the time since boot */
+static void SecLink_makeNonce(uint8 *nonce){
+	uint32 counter=SecLink_nextCounter();
+	uint32 micros=SysTick_getMicros();
+
+	memcpy(nonce,&counter,4);
+	memcpy(nonce+4,&micros,4);
+}
+
+/*
+ * Drop the session and ask the HMI for a new handshake. The RESET is tagged
+ * with the pairing key, expanded where the MAC key goes since the session
+ * ends anyway, and carries a new counter so a recorded one is refused.
+ */
+static void SecLink_restart(void){
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint32 counter;
+	uint8 i;
+
+	g_session.established=FALSE;
+	g_rejected=0;
+	g_rx_length=0;
+	g_rx_position=0;
+	counter=SecLink_nextCounter();
+	Speck_expandKey(&g_session.mac_key,g_pairing_key);
+	SecLink_header(block,counter,SECLINK_ROLE,SECLINK_RESET);
+	Speck_encrypt(&g_session.mac_key,block);
+
+	UART_sendByte(SECLINK_WAKE);
+	_delay_ms(SECLINK_WAKE_TIME_MS);
+	UART_sendByte(SECLINK_RESET);
+	for(i=0;i<4;i++){
+		UART_sendByte(((uint8*)&counter)[i]);
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		UART_sendByte(block[i]);
+	}
+	SecLink_reserveCounters();
+}
+
+/* Next byte of a message, FALSE if the line stays quiet for SECLINK_BYTE_TIMEOUT_MS */
+static boolean SecLink_receiveTimed(uint8 *data){
+	uint32 start=SysTick_getMillis();
+	while(!UART_isByteAvailable()){
+		if(SysTick_elapsedSince(start)>=SECLINK_BYTE_TIMEOUT_MS){
+			return FALSE;
+		}
+	}
+	*data=UART_receiveByte();
+	return TRUE;
+}
+
+/* HELLO received, answer it and start a new session */
+static void SecLink_accept(void){
+	uint8 hmi_nonce[SECLINK_NONCE_SIZE];
+	uint8 control_nonce[SECLINK_NONCE_SIZE];
+	uint8 i;
+
+	for(i=0;i<SECLINK_NONCE_SIZE;i++){
+		if(!SecLink_receiveTimed(&hmi_nonce[i])){
+			return;
+		}
+	}
+	/* Sent again by an HMI that missed the REPLY, or a recorded one: the session stays */
+	if(memcmp(hmi_nonce,g_hello_nonce,SECLINK_NONCE_SIZE)==0){
+		return;
+	}
+	memcpy(g_hello_nonce,hmi_nonce,SECLINK_NONCE_SIZE);
+	SecLink_makeNonce(control_nonce);
+
+	UART_sendByte(SECLINK_REPLY);
+	for(i=0;i<SECLINK_NONCE_SIZE;i++){
+		UART_sendByte(control_nonce[i]);
+	}
+	SecLink_deriveKeys(hmi_nonce,control_nonce);
+	SecLink_sendByte(SECLINK_CONFIRM);
+	SecLink_reserveCounters();
+	METRIC_INC(METRIC_HANDSHAKES);
+	if(g_session_ptr!=NULL_PTR){
+		(*g_session_ptr)();
+	}
+}
+
+/* Read the rest of a frame, keep its payload if the tag is right. A frame cut short is dropped. */
+static void SecLink_receiveFrame(void){
+	uint8 length;
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint8 expected[SECLINK_TAG_SIZE];
+	uint8 diff=0;
+	uint8 i;
+
+	if(!SecLink_receiveTimed(&length)||length>SECLINK_MAX_PAYLOAD){
+		METRIC_INC(METRIC_LINK_REJECTED);
+		return;
+	}
+	for(i=0;i<length;i++){
+		if(!SecLink_receiveTimed(&g_rx_buffer[i])){
+			METRIC_INC(METRIC_LINK_REJECTED);
+			return;
+		}
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		if(!SecLink_receiveTimed(&tag[i])){
+			METRIC_INC(METRIC_LINK_REJECTED);
+			return;
+		}
+	}
+	if(!g_session.established){
+		/* The HMI still has the session from before the reset of CONTROL_ECU */
+		SecLink_restart();
+		return;
+	}
+
+	SecLink_mac(g_session.rx_counter,SECLINK_PEER_ROLE,g_rx_buffer,length,expected);
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		diff|=(uint8)(tag[i]^expected[i]);
+	}
+	if(diff!=0){
+		METRIC_INC(METRIC_LINK_REJECTED);
+		g_rejected++;
+		if(g_rejected==SECLINK_MAX_REJECTED){
+			SecLink_restart();
+		}
+		return;
+	}
+	g_rejected=0;
+
+	SecLink_crypt(g_session.rx_counter,SECLINK_PEER_ROLE,g_rx_buffer,length);
+	g_session.rx_counter++;
+	TRACE(TRACE_LINK_RECEIVE,length);
+	g_rx_length=length;
+	g_rx_position=0;
+}
+
+void SecLink_init(void){
+	KV_get(KV_KEY_LINK_COUNTER,(uint8*)&g_counter,sizeof(g_counter));
+	g_counter_end=g_counter;
+	SecLink_reserveCounters();
+	SecLink_restart();
+}
+
+void SecLink_setSessionCallBack(void(*a_ptr)(void)){
+	g_session_ptr=a_ptr;
+}
+
+void SecLink_setRawHandler(void(*a_ptr)(uint8 data)){
+	g_raw_ptr=a_ptr;
+}
+
+boolean SecLink_receiveRaw(uint8 *data){
+	return SecLink_receiveTimed(data);
+}
+
+void SecLink_setIdleCallBack(void(*a_ptr)(void)){
+	g_idle_ptr=a_ptr;
+}
+
+uint8 SecLink_send(const uint8 *data,uint8 length){
+	uint8 buffer[SECLINK_MAX_PAYLOAD];
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint8 i;
+
+	if(!g_session.established||length>SECLINK_MAX_PAYLOAD){
+		return ERROR;
+	}
+
+	TRACE(TRACE_LINK_SEND,length);
+	memcpy(buffer,data,length);
+	SecLink_crypt(g_session.tx_counter,SECLINK_ROLE,buffer,length);
+	SecLink_mac(g_session.tx_counter,SECLINK_ROLE,buffer,length,tag);
+	g_session.tx_counter++;
+
+	UART_sendByte(SECLINK_FRAME_START);
+	UART_sendByte(length);
+	for(i=0;i<length;i++){
+		UART_sendByte(buffer[i]);
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		UART_sendByte(tag[i]);
+	}
+	return SUCCESS;
+}
+
+void SecLink_sendByte(uint8 data){
+	SecLink_send(&data,1);
+}
+
+uint8 SecLink_receiveByte(void){
+	uint8 data;
+	while(g_rx_position==g_rx_length){
+		while(g_idle_ptr!=NULL_PTR&&!UART_isByteAvailable()){
+			(*g_idle_ptr)();
+		}
+		data=UART_receiveByte();
+		if(data==SECLINK_FRAME_START){
+			SecLink_receiveFrame();
+		}
+		else if(data==SECLINK_HELLO){
+			SecLink_accept();
+		}
+		else if(g_raw_ptr!=NULL_PTR){
+			(*g_raw_ptr)(data);
+		}
+	}
+	return g_rx_buffer[g_rx_position++];
+}
+
+uint8 SecLink_getPendingCount(void){
+	return g_rx_length-g_rx_position;
+}
+
+boolean SecLink_isDataAvailable(void){
+	return (boolean)(g_rx_position<g_rx_length||UART_isByteAvailable());
+}
+
+uint32 SecLink_getSentCount(void){
+	return g_session.tx_counter;
+}
+
+uint32 SecLink_getReceivedCount(void){
+	return g_session.rx_counter;
+}
+
+void SecLink_benchmark(void){
+	uint8 buffer[SECLINK_MAX_PAYLOAD];
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint8 frame[10];
+	uint32 cycles[2];
+	uint32 start;
+	uint16 ram=sizeof(g_session)+sizeof(g_rx_buffer)+sizeof(g_pairing_key);
+	uint8 sizes[2]={1,SECLINK_MAX_PAYLOAD};
+	uint8 i;
+	uint8 j;
+
+	memset(buffer,0x55,sizeof(buffer));
+	for(i=0;i<2;i++){
+		start=SysTick_getMicros();
+		for(j=0;j<SECLINK_BENCHMARK_RUNS;j++){
+			SecLink_crypt(j,SECLINK_ROLE,buffer,sizes[i]);
+			SecLink_mac(j,SECLINK_ROLE,buffer,sizes[i],tag);
+		}
+		cycles[i]=(SysTick_getMicros()-start)*(F_CPU/1000000UL)/SECLINK_BENCHMARK_RUNS;
+	}
+
+	memcpy(frame,cycles,sizeof(cycles));
+	memcpy(&frame[8],&ram,sizeof(ram));
+	LINK_sendFrame(LINK_DIAG_LINK_BENCH,frame,sizeof(frame));
+}
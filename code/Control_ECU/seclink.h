@@ -0,0 +1,188 @@
+/*******************************
+ *  seclink.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SECLINK_H_
+#define SECLINK_H_
+
+#include "std_types.h"
+
+/*
+ * Authenticated and encrypted UART link between the two ECUs.
+ *
+ * Handshake, started by the HMI at boot:
+ *   HMI     -> CONTROL: SECLINK_HELLO, 8-byte HMI nonce
+ *   CONTROL -> HMI:     SECLINK_REPLY, 8-byte CONTROL nonce
+ * Both sides then derive an encryption key and a MAC key from the pairing
+ * key and the two nonces (Speck64/128 CBC-MAC as the derivation function).
+ * The first frame of CONTROL_ECU holds SECLINK_CONFIRM: the HMI only takes
+ * the session once it opens, so a late REPLY to an earlier HELLO cannot
+ * leave the two ECUs with different keys. Every HELLO has a new nonce, a
+ * HELLO repeating the nonce just answered is ignored.
+ *
+ * CONTROL_ECU asks for a new handshake after its reset, on a frame while it
+ * has no session and after SECLINK_MAX_REJECTED frames in a row failing the
+ * tag (the HMI starts one itself in the last case):
+ *   CONTROL -> HMI:     SECLINK_WAKE, SECLINK_WAKE_TIME_MS later
+ *                       SECLINK_RESET, 4-byte counter, tag
+ * The counter is the one of the CONTROL nonces, the tag the first bytes of
+ * the header block (counter, sender, SECLINK_RESET) encrypted with the
+ * pairing key. The HMI drops a RESET whose counter is not above the one of
+ * its session, a recorded RESET cannot force a new handshake.
+ *
+ * Every message then travels as a frame:
+ *   SECLINK_FRAME_START, length, ciphertext, tag (SECLINK_TAG_SIZE bytes)
+ * The ciphertext is Speck64/128 in counter mode, the tag a truncated
+ * CBC-MAC over a block holding the message counter, the sender and the
+ * length, followed by the ciphertext (encrypt then MAC). Each direction has
+ * its own message counter, implicit since UART delivers in order, so a
+ * replayed, reordered or reflected frame fails the tag and is dropped.
+ */
+#define SECLINK_HELLO           0xA0
+#define SECLINK_REPLY           0xA1
+#define SECLINK_RESET           0xA2   /* CONTROL_ECU asks for a new handshake */
+#define SECLINK_WAKE            0xA3   /* Sent before SECLINK_RESET for an HMI in power-down, ignored otherwise */
+#define SECLINK_FRAME_START     0xA5
+
+/* Payload of the first frame of a session, sent by CONTROL_ECU */
+#define SECLINK_CONFIRM         0xA4
+
+#define SECLINK_NONCE_SIZE      8
+#define SECLINK_TAG_SIZE        4
+/* Room for a provisioning request with a full door profile (link.h), the HMI messages are shorter */
+#define SECLINK_MAX_PAYLOAD     40
+
+/* Frames in a row failing the tag before a new handshake */
+#define SECLINK_MAX_REJECTED    3
+
+/* Sender identifiers mixed into the keystream and the MAC */
+#define SECLINK_ROLE_HMI        'H'
+#define SECLINK_ROLE_CONTROL    'C'
+
+/* Shared by the two ECUs of one installation, change it for every installation */
+#define SECLINK_PAIRING_KEY     {0x3A,0x91,0x5C,0xE7,0x08,0xB2,0x6D,0xF4,0x1E,0x87,0xC9,0x20,0x5B,0xA6,0x73,0xDD}
+
+/*
+ * Gap between SECLINK_WAKE and SECLINK_RESET. An HMI in power-down loses
+ * the byte that wakes it, the RESET that follows is received.
+ */
+#define SECLINK_WAKE_TIME_MS    5
+
+/*
+ * Longest gap between two bytes of a HELLO, a frame or a raw request. A
+ * message cut short is dropped after it instead of blocking the main loop
+ * until the watchdog resets it.
+ */
+#define SECLINK_BYTE_TIMEOUT_MS 40
+
+/*
+ * Counters reserved per write of KV_KEY_LINK_COUNTER. The store holds the
+ * end of the reserved block, a reset skips what was left of it; the next
+ * block is written once a handshake is answered, never before a REPLY.
+ */
+#define SECLINK_COUNTER_BLOCK   16
+
+/* Messages sealed by SecLink_benchmark() for each size */
+#define SECLINK_BENCHMARK_RUNS  16
+
+/*
+ * Description:
+ * Send SECLINK_RESET so that an HMI already running starts a new session,
+ * after SECLINK_WAKE for an HMI in standby. Must run after UART_init and
+ * KV_init, the RESET counter is kept in the key-value store.
+ */
+void SecLink_init(void);
+
+/*
+ * Description:
+ * Set a function called each time a handshake completes, e.g. to tell the
+ * HMI where to start. It may send messages.
+ */
+void SecLink_setSessionCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Set a function called with every received byte that is not part of the
+ * secure link (e.g. requests of a maintenance tool). It may read the bytes
+ * that follow with SecLink_receiveRaw.
+ */
+void SecLink_setRawHandler(void(*a_ptr)(uint8 data));
+
+/*
+ * Description:
+ * Read the byte following a raw byte, for the raw handler.
+ *
+ * Returns:
+ *  - TRUE, or FALSE if none is received within SECLINK_BYTE_TIMEOUT_MS.
+ */
+boolean SecLink_receiveRaw(uint8 *data);
+
+/*
+ * Description:
+ * Set a function called repeatedly while SecLink_receiveByte waits for the
+ * next message. Bytes inside a frame are not waited for this way, they
+ * follow each other on the line.
+ */
+void SecLink_setIdleCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Encrypt and send one message.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if no session is established or length is above SECLINK_MAX_PAYLOAD.
+ */
+uint8 SecLink_send(const uint8 *data,uint8 length);
+
+/*
+ * Description:
+ * Send a one byte message.
+ */
+void SecLink_sendByte(uint8 data);
+
+/*
+ * Description:
+ * Return the next byte of the received messages, waiting for a frame if
+ * none is left. Handshakes, frames failing the tag and raw bytes are
+ * handled on the way, a frame received without a session or too many
+ * rejected frames send SECLINK_RESET. A HELLO or frame cut short is
+ * dropped.
+ */
+uint8 SecLink_receiveByte(void);
+
+/*
+ * Description:
+ * Return the number of bytes of the current message not read yet: they
+ * follow without waiting.
+ */
+uint8 SecLink_getPendingCount(void);
+
+/*
+ * Description:
+ * Return TRUE if SecLink_receiveByte has something to process.
+ */
+boolean SecLink_isDataAvailable(void);
+
+/*
+ * Description:
+ * Return the number of frames sent and accepted in the current session.
+ * The sent count of one ECU matches the received count of the other one
+ * once the frame has arrived, so it identifies a message on both sides.
+ */
+uint32 SecLink_getSentCount(void);
+uint32 SecLink_getReceivedCount(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_LINK_BENCH: seal SECLINK_BENCHMARK_RUNS
+ * messages of 1 and of SECLINK_MAX_PAYLOAD bytes and send one frame holding
+ * the average cycles per message for each (uint32, uint32) and the SRAM used
+ * by the link state (uint16). Opening a message costs the same.
+ */
+void SecLink_benchmark(void);
+
+#endif /* SECLINK_H_ */
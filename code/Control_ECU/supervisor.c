@@ -0,0 +1,123 @@
+/*******************************
+ *  supervisor.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "supervisor.h"
+#include "systick.h"
+#include "breadcrumb.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+
+/* Marks a record written by Supervisor_poll, anything else is power-up garbage */
+#define SUPERVISOR_MAGIC  0x5D09
+
+typedef struct {
+	boolean active;
+	uint16 deadline;
+	uint16 last_checkin;     /* Low 16 bits of SysTick_getMillis() */
+	uint16 max_latency;
+} Supervisor_TaskType;
+
+typedef struct {
+	uint16 magic;
+	uint8 task;
+	uint8 task_check;        /* Complement of task */
+} Supervisor_MissType;
+
+static Supervisor_TaskType g_tasks[SUPERVISOR_TASK_COUNT];
+
+/* Written when a task misses its deadline, read back after the watchdog reset */
+static Supervisor_MissType g_miss __attribute__((section(".noinit")));
+
+static uint8 g_last_missed=SUPERVISOR_TASK_NONE;
+static uint8 g_period=0;
+static boolean g_failed=FALSE;
+
+/* Called from the SysTick ISR every millisecond */
+static void Supervisor_poll(void){
+	uint16 now;
+	uint8 i;
+
+	if(++g_period<SUPERVISOR_PERIOD_MS||g_failed){
+		return;
+	}
+	g_period=0;
+
+	now=(uint16)SysTick_getMillis();
+	for(i=0;i<SUPERVISOR_TASK_COUNT;i++){
+		if(g_tasks[i].active&&(uint16)(now-g_tasks[i].last_checkin)>g_tasks[i].deadline){
+			/* Leave the record and stop kicking, the watchdog resets the part */
+			g_miss.magic=SUPERVISOR_MAGIC;
+			g_miss.task=i;
+			g_miss.task_check=(uint8)~i;
+			g_failed=TRUE;
+			return;
+		}
+	}
+	wdt_reset();
+}
+
+void Supervisor_init(void){
+	if((Breadcrumb_getResetCause()&BREADCRUMB_RESET_WATCHDOG)
+			&&g_miss.magic==SUPERVISOR_MAGIC&&g_miss.task==(uint8)~g_miss.task_check){
+		g_last_missed=g_miss.task;
+	}
+	g_miss.magic=0;
+
+	Supervisor_start(SUPERVISOR_TASK_MAIN,SUPERVISOR_MAIN_DEADLINE_MS);
+	wdt_enable(SUPERVISOR_WDT_TIMEOUT);
+	SysTick_setCallBack(&Supervisor_poll);
+}
+
+void Supervisor_start(Supervisor_TaskIdType task,uint16 deadline_ms){
+	uint8 sreg=SREG;
+
+	cli();
+	g_tasks[task].deadline=deadline_ms;
+	g_tasks[task].last_checkin=(uint16)SysTick_getMillis();
+	g_tasks[task].active=TRUE;
+	SREG=sreg;
+}
+
+void Supervisor_stop(Supervisor_TaskIdType task){
+	g_tasks[task].active=FALSE;
+}
+
+void Supervisor_checkIn(Supervisor_TaskIdType task){
+	uint16 now;
+	uint16 latency;
+	uint8 sreg=SREG;
+
+	cli();
+	now=(uint16)SysTick_getMillis();
+	latency=now-g_tasks[task].last_checkin;
+	if(latency>g_tasks[task].max_latency){
+		g_tasks[task].max_latency=latency;
+	}
+	g_tasks[task].last_checkin=now;
+	SREG=sreg;
+}
+
+void Supervisor_dump(void){
+	uint8 frame[1+2*SUPERVISOR_TASK_COUNT];
+	uint16 latency;
+	uint8 sreg;
+	uint8 i;
+
+	frame[0]=g_last_missed;
+	for(i=0;i<SUPERVISOR_TASK_COUNT;i++){
+		sreg=SREG;
+		cli();
+		latency=g_tasks[i].max_latency;
+		SREG=sreg;
+		frame[1+2*i]=(uint8)latency;
+		frame[2+2*i]=(uint8)(latency>>8);
+	}
+	LINK_sendFrame(LINK_DIAG_SUPERVISOR,frame,sizeof(frame));
+}
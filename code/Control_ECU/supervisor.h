@@ -0,0 +1,72 @@
+/*******************************
+ *  supervisor.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SUPERVISOR_H_
+#define SUPERVISOR_H_
+
+#include "std_types.h"
+
+/* Supervised tasks of CONTROL_ECU */
+typedef enum {
+	SUPERVISOR_TASK_MAIN,      /* Main loop, including the waits for the HMI */
+	SUPERVISOR_TASK_MOTION,    /* Timer1 ticks of a running door cycle or alarm */
+	SUPERVISOR_TASK_COUNT
+}Supervisor_TaskIdType;
+
+/* Deadlines of the tasks, from one check-in to the next */
+#define SUPERVISOR_MAIN_DEADLINE_MS    2000   /* Longest diagnostic dump at the link baud rate */
+#define SUPERVISOR_MOTION_DEADLINE_MS  1500   /* One Timer1 period is one second */
+
+/* Period of the deadline check, the watchdog is kicked at the same rate */
+#define SUPERVISOR_PERIOD_MS           16
+
+/* Hardware watchdog timeout, the reset follows a missed deadline by this much */
+#define SUPERVISOR_WDT_TIMEOUT         WDTO_250MS
+
+/* "No task" value of the missed task field */
+#define SUPERVISOR_TASK_NONE           0xFF
+
+/*
+ * Description:
+ * Start the hardware watchdog and supervise SUPERVISOR_TASK_MAIN. If the
+ * last reset was caused by the watchdog, the task that missed its deadline
+ * before it is kept for Supervisor_dump. Must run after SysTick_init and
+ * Breadcrumb_init.
+ */
+void Supervisor_init(void);
+
+/*
+ * Description:
+ * Supervise a task with the given deadline, it counts as checked in now.
+ * Safe from an ISR.
+ */
+void Supervisor_start(Supervisor_TaskIdType task,uint16 deadline_ms);
+
+/*
+ * Description:
+ * Stop supervising a task. Safe from an ISR.
+ */
+void Supervisor_stop(Supervisor_TaskIdType task);
+
+/*
+ * Description:
+ * Tell the supervisor that a task is alive, and update its maximum
+ * latency (time since its previous check-in). Safe from an ISR.
+ */
+void Supervisor_checkIn(Supervisor_TaskIdType task);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_SUPERVISOR: send one frame holding the
+ * task that missed its deadline before the last watchdog reset (or
+ * SUPERVISOR_TASK_NONE), then the maximum latency in milliseconds of every
+ * task since boot (uint16 each).
+ */
+void Supervisor_dump(void);
+
+#endif /* SUPERVISOR_H_ */
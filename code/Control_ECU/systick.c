@@ -0,0 +1,74 @@
+/*******************************
+ *  systick.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "systick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/* Timer2 clock = F_CPU/64, one compare match every millisecond */
+#define SYSTICK_COMPARE_VALUE ((F_CPU/64UL/1000UL)-1)
+
+static volatile uint32 g_millis=0;
+static void(*volatile g_callBackPtr)(void)=NULL_PTR;
+
+/*
+ * ISR for Timer2 Compare Match
+ */
+ISR(TIMER2_COMP_vect){
+	g_millis++;
+	if(g_callBackPtr!=NULL_PTR){
+		(*g_callBackPtr)();
+	}
+}
+
+void SysTick_init(void){
+	TCNT2=0;
+	OCR2=SYSTICK_COMPARE_VALUE;
+
+	/* CTC mode WGM21=1, prescaler 64 CS22=1 */
+	TCCR2=(1<<WGM21)|(1<<CS22);
+
+	TIMSK|=(1<<OCIE2);
+}
+
+uint32 SysTick_getMillis(void){
+	uint32 millis;
+	uint8 sreg=SREG;
+
+	/* The 32-bit counter is updated by the ISR, read it with interrupts off */
+	cli();
+	millis=g_millis;
+	SREG=sreg;
+
+	return millis;
+}
+
+uint32 SysTick_elapsedSince(uint32 start){
+	return SysTick_getMillis()-start;
+}
+
+uint32 SysTick_getMicros(void){
+	uint32 millis;
+	uint8 count;
+	uint8 sreg=SREG;
+
+	cli();
+	millis=g_millis;
+	count=TCNT2;
+	/* The counter restarted but the ISR has not run yet */
+	if((TIFR&(1<<OCF2))&&count<SYSTICK_COMPARE_VALUE/2){
+		millis++;
+	}
+	SREG=sreg;
+
+	return millis*1000UL+(uint32)count*(64000000UL/F_CPU);
+}
+
+void SysTick_setCallBack(void(*a_ptr)(void)){
+	g_callBackPtr=a_ptr;
+}
@@ -0,0 +1,50 @@
+/*******************************
+ *  systick.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SYSTICK_H_
+#define SYSTICK_H_
+
+#include "std_types.h"
+
+/*
+ * Description:
+ * Start Timer2 in CTC mode as a free running 1 ms time base.
+ * Timer0 drives the motor PWM and Timer1 the door/alarm ticks, so Timer2
+ * is the only timer left for time keeping.
+ */
+void SysTick_init(void);
+
+/*
+ * Description:
+ * Return the number of milliseconds since SysTick_init().
+ */
+uint32 SysTick_getMillis(void);
+
+/*
+ * Description:
+ * Return the number of milliseconds elapsed since the given timestamp.
+ * Works across the 32-bit wrap around.
+ */
+uint32 SysTick_elapsedSince(uint32 start);
+
+/*
+ * Description:
+ * Return the number of microseconds since SysTick_init(), with the 8 us
+ * resolution of the Timer2 count. Wraps around after about 71 minutes,
+ * meant for measuring short durations.
+ */
+uint32 SysTick_getMicros(void);
+
+/*
+ * Description:
+ * Set a function called from the Timer2 ISR every millisecond. It must be
+ * short, it delays every other interrupt.
+ */
+void SysTick_setCallBack(void(*a_ptr)(void));
+
+#endif /* SYSTICK_H_ */
@@ -6,6 +6,9 @@
  *  Author: Muhannad Abdallah
  ******************************/
 #include "timer1.h"
+#include "trace.h"
+#include "metrics.h"
+#include "systick.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
@@ -15,18 +18,26 @@ volatile void(*callback_ptr)(void) = ((void*)0);  // Pointer to callback functio
  * ISR for Timer1 Compare Match A
  */
 ISR(TIMER1_COMPA_vect) {
+    uint32 start = SysTick_getMicros();
+    TRACE_ISR(TRACE_TIMER1_ENTER, 0);
     if (callback_ptr != ((void*)0)) {
         (*callback_ptr)();  // Call the callback function if it's set
     }
+    TRACE_ISR(TRACE_TIMER1_EXIT, 0);
+    METRIC_MAX(METRIC_TIMER1_ISR_MAX_US, SysTick_getMicros() - start);
 }
 
 /*
  * ISR for Timer1 Overflow
  */
 ISR(TIMER1_OVF_vect) {
+    uint32 start = SysTick_getMicros();
+    TRACE_ISR(TRACE_TIMER1_ENTER, 0);
     if (callback_ptr != ((void*)0)) {
         (*callback_ptr)();  // Call the callback function if it's set
     }
+    TRACE_ISR(TRACE_TIMER1_EXIT, 0);
+    METRIC_MAX(METRIC_TIMER1_ISR_MAX_US, SysTick_getMicros() - start);
 }
 
 /*
@@ -65,7 +76,7 @@ void Timer1_deInit(void) {
     TCCR1A = 0;      // Clear Timer/Counter Control Register A
     TCCR1B = 0;      // Clear Timer/Counter Control Register B
     OCR1A = 0;       // Clear Output Compare Register A
-    TIMSK = 0;       // Disable Timer Interrupts
+    TIMSK &= ~((1 << OCIE1A) | (1 << TOIE1));  // Disable Timer1 Interrupts only, Timer2 keeps the system tick
 }
 
 /*
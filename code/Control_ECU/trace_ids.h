@@ -0,0 +1,33 @@
+/*******************************
+ *  trace_ids.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef TRACE_IDS_H_
+#define TRACE_IDS_H_
+
+/*
+ * Trace events of both ECUs: X(id, kind, "name"), kind is B (a span
+ * begins), E (the span of the same name ends) or I (instant). tools/trace.py
+ * reads this list to name the events, keep one event per line.
+ */
+#define TRACE_ID_LIST(X) \
+	X(TRACE_STEP,           I, "step")          /* arg: step<<8 | breadcrumb phase (CONTROL) or step (HMI) */ \
+	X(TRACE_LINK_SEND,      I, "link send")     /* arg: payload length */ \
+	X(TRACE_LINK_RECEIVE,   I, "link receive")  /* arg: payload length, only frames passing the tag */ \
+	X(TRACE_TWI_BEGIN,      B, "twi")           /* arg: slave address<<8 | first register byte */ \
+	X(TRACE_TWI_END,        E, "twi")           /* arg: TWI_TransactionStatus */ \
+	X(TRACE_TIMER1_ENTER,   B, "timer1 isr")    /* arg: 0, TRACE_ISR_ENABLED builds only */ \
+	X(TRACE_TIMER1_EXIT,    E, "timer1 isr")    /* arg: 0, TRACE_ISR_ENABLED builds only */
+
+#define TRACE_ID_ENUM(ID,KIND,NAME) ID,
+
+typedef enum {
+	TRACE_ID_LIST(TRACE_ID_ENUM)
+	TRACE_ID_COUNT
+}Trace_IdType;
+
+#endif /* TRACE_IDS_H_ */
@@ -8,9 +8,36 @@
 
 #include"twi.h"
 #include<avr/io.h>
+#include<avr/interrupt.h>
+#include<util/delay.h>
 #include"common_macros.h"
+#include"gpio.h"
+#include"systick.h"
+#include"trace.h"
+#include"log.h"
+#include"metrics.h"
+
+/* Configuration kept for the re-init after a bus recovery */
+static TWI_ConfigType g_config;
+
+static TWI_ErrorCountersType g_errors;
+
+/* Transactions waiting for the bus, the head one is the running one */
+static TWI_TransactionType *volatile g_queue[TWI_QUEUE_SIZE];
+static volatile uint8 g_queue_head=0;
+static volatile uint8 g_queue_count=0;
+
+/* Progress of the running transaction */
+static uint16 g_index=0;
+static boolean g_reading=FALSE;
+static uint8 g_arbitration_retries=0;
+
+/* Time of the last TWI interrupt (or START request) of the running transaction */
+static volatile uint32 g_last_activity=0;
 
 void TWI_init(const TWI_ConfigType* Config_Ptr){
+	g_config=*Config_Ptr;
+
 	/* Bit Rate: 400.000 kbps using zero pre-scaler TWPS=00 and F_CPU=8MHZ*/
 	/* Assume prescaler of 1 */
 	TWBR=((F_CPU/Config_Ptr->bit_rate)-16)/2;
@@ -25,6 +52,24 @@ void TWI_init(const TWI_ConfigType* Config_Ptr){
 
 }
 
+/*
+ * Wait for TWINT with a deadline. A device holding SDA low or a glitch on the
+ * bus would otherwise leave the CPU spinning here forever. On timeout the bus
+ * is recovered and the caller sees an unexpected status.
+ */
+static void TWI_waitForFlag(void){
+	uint32 start=SysTick_getMillis();
+	while(BIT_IS_CLEAR(TWCR,TWINT))
+	{
+		if(SysTick_elapsedSince(start)>TWI_TIMEOUT_MS)
+		{
+			g_errors.timeouts++;
+			TWI_recoverBus();
+			return;
+		}
+	}
+}
+
 void TWI_start(void){
 	/*
 	 * Clear the TWINT flag before sending the start bit TWINT=1
@@ -35,7 +80,7 @@ void TWI_start(void){
 	TWCR=(1<<TWINT)|(1<<TWSTA)|(1<<TWEN);
 
 	/* Wait for TWINT flag to be set in TWCR register (start bit is sent successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_waitForFlag();
 }
 
 void TWI_stop(void){
@@ -57,7 +102,7 @@ void TWI_writeByte(uint8 data){
 	TWCR=(1<<TWINT)|(1<<TWEN);
 
 	/* Wait until TWINT flag is set indicating (stop bit is sent successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_waitForFlag();
 }
 
 uint8 TWI_readByteWithACK(void){
@@ -68,7 +113,7 @@ uint8 TWI_readByteWithACK(void){
 	 */
 	TWCR=(1<<TWINT)|(1<<TWEN)|(1<<TWEA);
 	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_waitForFlag();
 	/* Read Data */
 	return TWDR;
 }
@@ -81,7 +126,7 @@ uint8 TWI_readByteWithNACK(void)
 	 */
     TWCR = (1 << TWINT) | (1 << TWEN);
     /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    TWI_waitForFlag();
     /* Read Data */
     return TWDR;
 }
@@ -94,5 +139,250 @@ uint8 TWI_getStatus(void){
 	return status;
 }
 
+/*
+ * Start the transaction at the head of the queue. When a transaction is
+ * finishing, the STOP is requested together with the START so the bus goes
+ * straight on to the next one.
+ */
+static void TWI_startNext(uint8 control){
+	if(g_queue_count==0)
+	{
+		TWCR=control;
+		return;
+	}
+	g_queue[g_queue_head]->status=TWI_BUSY;
+	TRACE(TRACE_TWI_BEGIN,((uint16)g_queue[g_queue_head]->address<<8)|g_queue[g_queue_head]->reg[0]);
+	g_index=0;
+	g_reading=FALSE;
+	g_arbitration_retries=0;
+	g_last_activity=SysTick_getMillis();
+	TWCR=control|(1<<TWINT)|(1<<TWSTA)|(1<<TWEN)|(1<<TWIE);
+}
+
+/*
+ * Retire the head transaction with the given status and start the next one.
+ * control is what is written to TWCR together with the next START: a STOP for
+ * a normal end, or just TWEN after a recovery.
+ */
+static void TWI_finish(TWI_TransactionStatus status,uint8 control){
+	TWI_TransactionType *transaction=g_queue[g_queue_head];
+
+	g_queue_head=(g_queue_head+1)%TWI_QUEUE_SIZE;
+	g_queue_count--;
+
+	transaction->status=status;
+	TRACE(TRACE_TWI_END,status);
+	if(status==TWI_FAILED){
+		METRIC_INC(METRIC_TWI_FAILURES);
+		LOG_ERROR(LOG_TWI_FAILED,transaction->address,transaction->reg[0]);
+	}
+	if(transaction->callback!=NULL_PTR)
+	{
+		transaction->callback(transaction);
+	}
+
+	TWI_startNext(control);
+}
+
+/* Finish the running transaction with a STOP and move to the next one */
+static void TWI_complete(TWI_TransactionStatus status){
+	TWI_finish(status,(1<<TWINT)|(1<<TWSTO)|(1<<TWEN));
+}
+
+/* Clear TWINT to let the hardware carry on, keeping the interrupt enabled */
+#define TWI_CONTINUE(EXTRA) (TWCR=(1<<TWINT)|(1<<TWEN)|(1<<TWIE)|(EXTRA))
+
+ISR(TWI_vect){
+	TWI_TransactionType *transaction=g_queue[g_queue_head];
+
+	g_last_activity=SysTick_getMillis();
+
+	switch(TWI_getStatus())
+	{
+	case TWI_START:
+	case TWI_REP_START:
+		/* A read with no register bytes goes directly to SLA+R */
+		if(transaction->direction==TWI_READ&&transaction->reg_len==0)
+			g_reading=TRUE;
+		TWDR=(uint8)(transaction->address<<1)|(g_reading?1:0);
+		TWI_CONTINUE(0);
+		break;
+
+	case TWI_MT_SLA_W_ACK:
+	case TWI_MT_DATA_ACK:
+		if(g_index<transaction->reg_len)
+		{
+			TWDR=transaction->reg[g_index++];
+			TWI_CONTINUE(0);
+		}
+		else if(transaction->direction==TWI_READ)
+		{
+			/* Register address sent, turn the bus around with a repeated START */
+			g_reading=TRUE;
+			g_index=0;
+			TWI_CONTINUE(1<<TWSTA);
+		}
+		else if(g_index-transaction->reg_len<transaction->length)
+		{
+			TWDR=transaction->data[g_index-transaction->reg_len];
+			g_index++;
+			TWI_CONTINUE(0);
+		}
+		else
+		{
+			TWI_complete(TWI_DONE);
+		}
+		break;
+
+	case TWI_MT_SLA_W_NACK:
+		if(transaction->nack_retries>0)
+		{
+			/* Device busy (e.g. EEPROM write cycle): STOP and try again */
+			transaction->nack_retries--;
+			METRIC_INC(METRIC_EEPROM_RETRIES);
+			TWI_CONTINUE((1<<TWSTO)|(1<<TWSTA));
+		}
+		else if(transaction->probe)
+		{
+			/* The device answered the probe: still busy */
+			TWI_complete(TWI_NACKED);
+		}
+		else
+		{
+			g_errors.nacks++;
+			TWI_complete(TWI_FAILED);
+		}
+		break;
+
+	case TWI_MT_SLA_R_ACK:
+		/* ACK every byte but the last one */
+		TWI_CONTINUE(transaction->length>1?(1<<TWEA):0);
+		break;
+
+	case TWI_MR_DATA_ACK:
+		transaction->data[g_index++]=TWDR;
+		TWI_CONTINUE(g_index+1<transaction->length?(1<<TWEA):0);
+		break;
 
+	case TWI_MR_DATA_NACK:
+		transaction->data[g_index]=TWDR;
+		TWI_complete(TWI_DONE);
+		break;
 
+	case TWI_ARB_LOST:
+		/* Another master won the bus, the hardware sends our START again once it is free */
+		g_errors.arbitration_lost++;
+		if(g_arbitration_retries<TWI_ARBITRATION_RETRIES)
+		{
+			g_arbitration_retries++;
+			g_index=0;
+			g_reading=FALSE;
+			TWI_CONTINUE(1<<TWSTA);
+		}
+		else
+		{
+			TWI_finish(TWI_FAILED,(1<<TWINT)|(1<<TWEN));
+		}
+		break;
+
+	case TWI_BUS_ERROR:
+		/* Illegal START/STOP: a STOP with TWINT cleared releases the lines */
+		g_errors.bus_errors++;
+		TWI_complete(TWI_FAILED);
+		break;
+
+	default:
+		/* Data NACK or SLA+R NACK */
+		g_errors.nacks++;
+		TWI_complete(TWI_FAILED);
+		break;
+	}
+}
+
+uint8 TWI_submit(TWI_TransactionType *Transaction_Ptr){
+	uint8 sreg=SREG;
+	uint8 result=SUCCESS;
+
+	if(Transaction_Ptr->reg_len>TWI_MAX_REG_BYTES
+			||(Transaction_Ptr->direction==TWI_READ&&Transaction_Ptr->length==0))
+	{
+		Transaction_Ptr->status=TWI_FAILED;
+		return ERROR;
+	}
+
+	cli();
+	if(g_queue_count==TWI_QUEUE_SIZE)
+	{
+		result=ERROR;
+	}
+	else
+	{
+		Transaction_Ptr->status=TWI_QUEUED;
+		g_queue[(g_queue_head+g_queue_count)%TWI_QUEUE_SIZE]=Transaction_Ptr;
+		g_queue_count++;
+		METRIC_MAX(METRIC_TWI_QUEUE_MAX,g_queue_count);
+		if(g_queue_count==1)
+		{
+			TWI_startNext(0);
+		}
+	}
+	SREG=sreg;
+
+	return result;
+}
+
+boolean TWI_isIdle(void){
+	return (g_queue_count==0);
+}
+
+void TWI_recoverBus(void){
+	uint8 i;
+
+	/* Give the pins back to the port so SCL can be clocked by hand */
+	TWCR=0;
+	GPIO_writePin(TWI_SCL_PORT_ID,TWI_SCL_PIN_ID,LOGIC_LOW);
+	GPIO_writePin(TWI_SDA_PORT_ID,TWI_SDA_PIN_ID,LOGIC_LOW);
+	GPIO_setupPinDirection(TWI_SDA_PORT_ID,TWI_SDA_PIN_ID,PIN_INPUT);
+
+	/*
+	 * Up to 9 clocks let a slave that is in the middle of a byte finish it and
+	 * release SDA. The lines are driven open-drain: output low or released
+	 * input, the external pull-ups give the high level.
+	 */
+	for(i=0;i<9&&GPIO_readPin(TWI_SDA_PORT_ID,TWI_SDA_PIN_ID)==LOGIC_LOW;i++)
+	{
+		GPIO_setupPinDirection(TWI_SCL_PORT_ID,TWI_SCL_PIN_ID,PIN_OUTPUT);
+		_delay_us(5);
+		GPIO_setupPinDirection(TWI_SCL_PORT_ID,TWI_SCL_PIN_ID,PIN_INPUT);
+		_delay_us(5);
+	}
+
+	/* STOP condition: SDA rises while SCL is high */
+	GPIO_setupPinDirection(TWI_SDA_PORT_ID,TWI_SDA_PIN_ID,PIN_OUTPUT);
+	_delay_us(5);
+	GPIO_setupPinDirection(TWI_SCL_PORT_ID,TWI_SCL_PIN_ID,PIN_INPUT);
+	_delay_us(5);
+	GPIO_setupPinDirection(TWI_SDA_PORT_ID,TWI_SDA_PIN_ID,PIN_INPUT);
+	_delay_us(5);
+
+	g_errors.recoveries++;
+	TWI_init(&g_config);
+}
+
+void TWI_service(void){
+	uint8 sreg=SREG;
+
+	cli();
+	if(g_queue_count>0&&SysTick_elapsedSince(g_last_activity)>TWI_TIMEOUT_MS)
+	{
+		/* No interrupt for too long: the bus is stuck, free it and drop the transaction */
+		g_errors.timeouts++;
+		TWI_recoverBus();
+		TWI_finish(TWI_FAILED,(1<<TWEN));
+	}
+	SREG=sreg;
+}
+
+const TWI_ErrorCountersType* TWI_getErrorCounters(void){
+	return &g_errors;
+}
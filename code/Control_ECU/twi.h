@@ -18,15 +18,83 @@ typedef struct {
 	uint32 bit_rate;
 }TWI_ConfigType;
 
+/* TWI pins, clocked by hand during a bus recovery */
+#define TWI_SCL_PORT_ID PORTC_ID
+#define TWI_SCL_PIN_ID  PIN0_ID
+#define TWI_SDA_PORT_ID PORTC_ID
+#define TWI_SDA_PIN_ID  PIN1_ID
+
+/* A transaction with no bus progress for this long is considered stuck */
+#define TWI_TIMEOUT_MS 3
+
+/* Times a transaction is restarted after losing arbitration to another master */
+#define TWI_ARBITRATION_RETRIES 3
+
+/* Counters of the bus failures seen since reset */
+typedef struct {
+	uint16 timeouts;
+	uint16 arbitration_lost;
+	uint16 bus_errors;
+	uint16 nacks;
+	uint16 recoveries;
+}TWI_ErrorCountersType;
+
 /* I2C Status Bits in the TWSR Register */
 
 #define TWI_START 0x08 /* start has been sent */
 #define TWI_REP_START 0x10 /* repeated start */
 #define TWI_MT_SLA_W_ACK  0x18 /* Master transmit ( slave address + Write request ) to slave + ACK received from slave. */
+#define TWI_MT_SLA_W_NACK 0x20 /* Master transmit ( slave address + Write request ) to slave + NACK received (slave busy or absent). */
 #define TWI_MT_SLA_R_ACK  0x40 /* Master transmit ( slave address + Read request ) to slave + ACK received from slave. */
 #define TWI_MT_DATA_ACK   0x28 /* Master transmit data and ACK has been received from Slave. */
 #define TWI_MR_DATA_ACK   0x50 /* Master received data and send ACK to slave. */
 #define TWI_MR_DATA_NACK  0x58 /* Master received data but doesn't send ACK to slave. */
+#define TWI_MT_DATA_NACK  0x30 /* Master transmit data and NACK has been received from Slave. */
+#define TWI_ARB_LOST      0x38 /* Arbitration lost in SLA+R/W or data bytes. */
+#define TWI_MR_SLA_R_NACK 0x48 /* Master transmit ( slave address + Read request ) to slave + NACK received from slave. */
+#define TWI_BUS_ERROR     0x00 /* Illegal START or STOP condition on the bus. */
+
+/* Number of transactions that can wait for the bus at the same time */
+#define TWI_QUEUE_SIZE 4
+
+/* Maximum number of register (memory address) bytes sent before the data */
+#define TWI_MAX_REG_BYTES 2
+
+typedef enum {
+	TWI_WRITE,
+	TWI_READ
+}TWI_DirectionType;
+
+typedef enum {
+	TWI_IDLE,      /* Not submitted */
+	TWI_QUEUED,    /* Waiting for the bus */
+	TWI_BUSY,      /* Running on the bus */
+	TWI_DONE,      /* Finished successfully */
+	TWI_FAILED,    /* NACK or bus error, STOP has been sent */
+	TWI_NACKED     /* Probe not answered (device busy), STOP has been sent, not an error */
+}TWI_TransactionStatus;
+
+typedef struct TWI_Transaction TWI_TransactionType;
+
+/*
+ * One complete bus transaction, run by the TWI interrupt from the START to the STOP:
+ * START, SLA+W, the register bytes, then either the data bytes (TWI_WRITE) or a
+ * repeated START, SLA+R and the data bytes (TWI_READ). A read without register
+ * bytes starts directly with SLA+R. The structure is owned by the caller and must
+ * stay alive until the status leaves TWI_QUEUED/TWI_BUSY.
+ */
+struct TWI_Transaction {
+	uint8 address;                       /* 7-bit slave address */
+	uint8 reg[TWI_MAX_REG_BYTES];        /* Register or memory address bytes */
+	uint8 reg_len;
+	TWI_DirectionType direction;
+	uint8 *data;                         /* Bytes to send or buffer to fill */
+	uint16 length;
+	uint16 nack_retries;                 /* Times to restart on SLA+W NACK (ACK polling of busy devices) */
+	boolean probe;                       /* SLA+W NACK once the retries are used is an answer: TWI_NACKED */
+	volatile TWI_TransactionStatus status;
+	void (*callback)(TWI_TransactionType *Transaction_Ptr); /* Called from the ISR when done, may be NULL_PTR */
+};
 
 void TWI_init(const TWI_ConfigType* Config_Ptr);
 
@@ -38,8 +106,47 @@ void TWI_writeByte(uint8 data);
 
 uint8 TWI_readByteWithACK(void);
 
-uint8 TWI_readyByteWithNack(void);
+uint8 TWI_readByteWithNACK(void);
 
 uint8 TWI_getStatus(void);
 
+/*
+ * Description:
+ * Queue a transaction for the interrupt driven engine. The bus is started at
+ * once if it is idle, otherwise the transaction runs after the ones before it.
+ * The blocking functions above must not be used while the engine is busy.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the queue is full.
+ */
+uint8 TWI_submit(TWI_TransactionType *Transaction_Ptr);
+
+/*
+ * Description:
+ * Return TRUE when no transaction is queued or running.
+ */
+boolean TWI_isIdle(void);
+
+/*
+ * Description:
+ * Check the running transaction against TWI_TIMEOUT_MS. A stuck transaction
+ * is failed (its callback is called), the bus is recovered and the queue goes
+ * on. The blocking EEPROM calls run it while they wait, code using the async
+ * API should call it from its main loop.
+ */
+void TWI_service(void);
+
+/*
+ * Description:
+ * Free a bus held by a slave: disable the TWI, clock SCL up to 9 times until
+ * SDA is released, generate a STOP and initialize the TWI again.
+ */
+void TWI_recoverBus(void);
+
+/*
+ * Description:
+ * Return the bus failure counters.
+ */
+const TWI_ErrorCountersType* TWI_getErrorCounters(void);
+
 #endif /* TWI_H_ */
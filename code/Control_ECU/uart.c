@@ -8,7 +8,18 @@
 
 #include "uart.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "common_macros.h"
+#include "metrics.h"
+
+/*
+ * ISR for USART Receive Complete, only enabled by UART_wakeOnReceive.
+ * The byte stays in UDR for UART_receiveByte, the interrupt is disabled
+ * since RXC stays set until then.
+ */
+ISR(USART_RXC_vect) {
+    UCSRB &= ~(1 << RXCIE);
+}
 
 /*
  * Description:
@@ -91,11 +102,35 @@ void UART_sendByte(const uint8 data) {
 uint8 UART_receiveByte(void) {
     /* Wait for the data to be received (RXC flag set) */
     while (BIT_IS_CLEAR(UCSRA, RXC));
-    
+
+    /* The error flags belong to the byte in UDR, read them first */
+    if (UCSRA & ((1 << FE) | (1 << DOR) | (1 << PE))) {
+        METRIC_INC(METRIC_UART_ERRORS);
+    }
     /* Get and return the received data from the buffer */
     return UDR;
 }
 
+/*
+ * Description:
+ * Checks the RXC flag without waiting.
+ *
+ * Returns:
+ *  - TRUE if a received byte is waiting in the buffer.
+ */
+boolean UART_isByteAvailable(void) {
+    return BIT_IS_SET(UCSRA, RXC) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Enables the RX Complete interrupt until the next byte is received, so
+ * that the byte wakes the CPU from sleep.
+ */
+void UART_wakeOnReceive(void) {
+    UCSRB |= (1 << RXCIE);
+}
+
 /*
  * Description:
  * Sends a string of data through UART.
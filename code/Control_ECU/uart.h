@@ -91,6 +91,21 @@ void UART_sendByte(const uint8 data);
  */
 uint8 UART_receiveByte(void);
 
+/* 
+ * Function: UART_isByteAvailable
+ * Description: Checks whether a received byte is waiting, without blocking.
+ * Returns:
+ *   - TRUE if UART_receiveByte would return at once.
+ */
+boolean UART_isByteAvailable(void);
+
+/* 
+ * Function: UART_wakeOnReceive
+ * Description: Makes the next received byte raise an interrupt, which wakes
+ *              the CPU from sleep. The byte is left for UART_receiveByte.
+ */
+void UART_wakeOnReceive(void);
+
 /* 
  * Function: UART_sendString
  * Description: Sends a string of data through UART to another UART device.
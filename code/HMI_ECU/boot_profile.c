@@ -0,0 +1,67 @@
+/*******************************
+ *  boot_profile.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "boot_profile.h"
+#include "systick.h"
+#include "link.h"
+#include <string.h>
+
+/* Marks a buffer written by BootProfile_start, anything else is power-up garbage */
+#define BOOT_PROFILE_MAGIC  0xB007
+
+typedef struct {
+	uint8 id;
+	uint32 micros;
+} BootProfile_MarkType;
+
+typedef struct {
+	uint16 magic;
+	boolean ended;
+	uint8 aborted_mark;
+	uint8 count;
+	BootProfile_MarkType marks[BOOT_PROFILE_MAX_MARKS];
+} BootProfile_BufferType;
+
+/* Not cleared by the C startup code, so it survives a reset */
+static BootProfile_BufferType g_profile __attribute__((section(".noinit")));
+
+void BootProfile_start(void){
+	uint8 aborted=BOOT_PROFILE_NONE;
+
+	if(g_profile.magic==BOOT_PROFILE_MAGIC&&!g_profile.ended
+			&&g_profile.count!=0&&g_profile.count<=BOOT_PROFILE_MAX_MARKS){
+		aborted=g_profile.marks[g_profile.count-1].id;
+	}
+	g_profile.magic=BOOT_PROFILE_MAGIC;
+	g_profile.ended=FALSE;
+	g_profile.aborted_mark=aborted;
+	g_profile.count=0;
+	BootProfile_mark(BOOT_MARK_MAIN);
+}
+
+void BootProfile_mark(BootProfile_MarkIdType id){
+	if(g_profile.ended||g_profile.count==BOOT_PROFILE_MAX_MARKS){
+		return;
+	}
+	g_profile.marks[g_profile.count].id=id;
+	g_profile.marks[g_profile.count].micros=SysTick_getMicros();
+	g_profile.count++;
+}
+
+void BootProfile_end(BootProfile_MarkIdType id){
+	BootProfile_mark(id);
+	g_profile.ended=TRUE;
+}
+
+void BootProfile_dump(void){
+	uint8 frame[2+BOOT_PROFILE_MAX_MARKS*sizeof(BootProfile_MarkType)];
+	frame[0]=g_profile.aborted_mark;
+	frame[1]=g_profile.count;
+	memcpy(&frame[2],g_profile.marks,g_profile.count*sizeof(BootProfile_MarkType));
+	LINK_sendFrame(LINK_DIAG_BOOT_PROFILE,frame,2+g_profile.count*sizeof(BootProfile_MarkType));
+}
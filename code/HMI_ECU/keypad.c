@@ -35,6 +35,12 @@ static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
 
 #endif /* STANDARD_KEYPAD */
 
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static void(*g_idleCallBackPtr)(boolean first) = NULL_PTR;
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -42,6 +48,7 @@ static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
 uint8 KEYPAD_getPressedKey(void)
 {
 	uint8 col,row;
+	boolean first = TRUE;
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
 	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
@@ -89,9 +96,40 @@ uint8 KEYPAD_getPressedKey(void)
 			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
 			_delay_ms(5); /* Add small delay to fix CPU load issue in proteus */
 		}
+
+		/* No key in this scan */
+		if(g_idleCallBackPtr != NULL_PTR)
+		{
+			(*g_idleCallBackPtr)(first);
+		}
+		first = FALSE;
 	}	
 }
 
+void KEYPAD_setIdleCallBack(void(*a_ptr)(boolean first))
+{
+	g_idleCallBackPtr = a_ptr;
+}
+
+void KEYPAD_armWakeUp(void)
+{
+	uint8 row;
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++)
+	{
+		GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+		GPIO_writePin(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,KEYPAD_BUTTON_PRESSED);
+	}
+}
+
+void KEYPAD_disarmWakeUp(void)
+{
+	uint8 row;
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++)
+	{
+		GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
+	}
+}
+
 #ifndef STANDARD_KEYPAD
 
 #if (KEYPAD_NUM_COLS == 3)
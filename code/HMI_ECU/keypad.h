@@ -44,4 +44,25 @@
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description :
+ * Set a function called after every scan of the keypad that found no key.
+ * Its argument is TRUE for the first scan of a KEYPAD_getPressedKey call.
+ */
+void KEYPAD_setIdleCallBack(void(*a_ptr)(boolean first));
+
+/*
+ * Description :
+ * Drive all the rows to the pressed level, so that any key pulls its column
+ * down (the columns are wired to the wake-up interrupt pin through diodes).
+ * Undone by KEYPAD_disarmWakeUp.
+ */
+void KEYPAD_armWakeUp(void);
+
+/*
+ * Description :
+ * Release the rows driven by KEYPAD_armWakeUp.
+ */
+void KEYPAD_disarmWakeUp(void);
+
 #endif /* KEYPAD_H_ */
@@ -0,0 +1,62 @@
+/*******************************
+ *  latency.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "std_types.h"
+
+/*
+ * Timestamps of the stages of a password check, from the Enter key on the
+ * HMI to the motor start on CONTROL_ECU. Each ECU keeps the stages it sees
+ * in its own SysTick time. A record is tagged with the secure link frame
+ * count of the last password byte, the same on both ECUs, so that
+ * tools/latency.py can pair the records of the two dumps.
+ *
+ * The two clocks are aligned per record from the exchange over the link:
+ *   HMI     PASSWORD_SENT      t1  ->  t2  PASSWORD_RECEIVED  CONTROL
+ *   HMI     REPLY_RECEIVED     t4  <-  t3  REPLY_SENT         CONTROL
+ * Both frames have the same size, so the offset is ((t2-t1)+(t3-t4))/2.
+ */
+
+/* Password checks kept, the oldest record is overwritten */
+#define LATENCY_RECORDS     4
+
+/* Stages seen by the HMI, in order, the first one starts a new record */
+typedef enum {
+	LATENCY_KEY_ENTER,           /* Enter key read after the password */
+	LATENCY_PASSWORD_SENT,       /* Last password byte sent to CONTROL_ECU */
+	LATENCY_REPLY_RECEIVED,      /* CONTROL_ECU_READY received */
+	LATENCY_DOOR_SHOWN,          /* First door message on the LCD */
+	LATENCY_STAGES
+}Latency_StageType;
+
+/*
+ * Description:
+ * Record the current SysTick_getMicros() time for a stage. The first stage
+ * starts a new record, the others fill the current one.
+ */
+void Latency_mark(Latency_StageType stage);
+
+/*
+ * Description:
+ * Tag the current record, with the low 16 bits of the secure link frame
+ * count of the last password byte.
+ */
+void Latency_setKey(uint16 key);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_LATENCY: send a frame holding the number
+ * of stages and of records, then one frame per record, oldest first: the
+ * key (uint16) and the time of every stage in microseconds (uint32, 0 if
+ * the stage was not reached), then an end frame.
+ */
+void Latency_dump(void);
+
+#endif /* LATENCY_H_ */
@@ -14,6 +14,7 @@
 #include "common_macros.h" /* For GET_BIT Macro */
 #include "lcd.h"
 #include "gpio.h"
+#include "systick.h"
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -31,7 +32,8 @@ void LCD_init(void)
 	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
 	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
 
-	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
+	/* LCD Power ON delay always > 15ms, the time spent since reset counts */
+	while(SysTick_getMillis() < LCD_POWER_ON_DELAY_MS);
 
 #if(LCD_DATA_BITS_MODE == 4)
 	/* Configure 4 pins in the data port as output pins */
@@ -42,7 +44,9 @@ void LCD_init(void)
 
 	/* Send for 4 bit initialization of LCD  */
 	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
+	_delay_ms(LCD_INIT_DELAY_MS);
 	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+	_delay_ms(LCD_INIT_DELAY_MS);
 
 	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
 	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
@@ -67,9 +71,9 @@ void LCD_init(void)
 void LCD_sendCommand(uint8 command)
 {
 	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
+	_delay_us(1); /* delay for processing Tas = 50ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
 
 #if(LCD_DATA_BITS_MODE == 4)
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
@@ -77,27 +81,37 @@ void LCD_sendCommand(uint8 command)
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
 
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 
 #elif(LCD_DATA_BITS_MODE == 8)
 	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 #endif
+
+	/* wait for the LCD to execute the command */
+	if((command == LCD_CLEAR_COMMAND) || (command == LCD_GO_TO_HOME))
+	{
+		_delay_us(LCD_CLEAR_EXECUTION_TIME_US);
+	}
+	else
+	{
+		_delay_us(LCD_EXECUTION_TIME_US);
+	}
 }
 
 /*
@@ -107,9 +121,9 @@ void LCD_sendCommand(uint8 command)
 void LCD_displayCharacter(uint8 data)
 {
 	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
+	_delay_us(1); /* delay for processing Tas = 50ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
 
 #if(LCD_DATA_BITS_MODE == 4)
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
@@ -117,27 +131,29 @@ void LCD_displayCharacter(uint8 data)
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
 
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
 	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
 
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 
 #elif(LCD_DATA_BITS_MODE == 8)
 	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
 	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	_delay_us(1); /* delay for processing Th = 13ns */
 #endif
+
+	_delay_us(LCD_EXECUTION_TIME_US); /* wait for the LCD to write the character */
 }
 
 /*
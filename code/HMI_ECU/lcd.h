@@ -54,9 +54,16 @@
 #define LCD_TWO_LINES_FOUR_BITS_MODE_INIT1   0x33
 #define LCD_TWO_LINES_FOUR_BITS_MODE_INIT2   0x32
 #define LCD_CURSOR_OFF                       0x0C
+#define LCD_DISPLAY_OFF                      0x08
 #define LCD_CURSOR_ON                        0x0E
 #define LCD_SET_CURSOR_LOCATION              0x80
 
+/* LCD timing, the bus setup/hold times are covered by 1us waits */
+#define LCD_POWER_ON_DELAY_MS                20   /* From power on, > 15ms, counted from SysTick_init */
+#define LCD_INIT_DELAY_MS                    5    /* After each 4-bit mode init command, > 4.1ms */
+#define LCD_EXECUTION_TIME_US                50   /* Any command or character, > 37us */
+#define LCD_CLEAR_EXECUTION_TIME_US          2000 /* Clear and return home, > 1.52ms */
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
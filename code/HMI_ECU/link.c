@@ -0,0 +1,67 @@
+/*******************************
+ *  link.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "link.h"
+#include "uart.h"
+#include "seclink.h"
+#include "crc.h"
+
+typedef struct {
+	uint8 command;
+	void (*handler)(void);
+} LINK_DiagEntryType;
+
+static LINK_DiagEntryType g_diag[LINK_MAX_DIAG_COMMANDS];
+static uint8 g_diag_count=0;
+
+static void LINK_serveDiag(uint8 command){
+	uint8 i;
+	for(i=0;i<g_diag_count;i++){
+		if(g_diag[i].command==command){
+			(*g_diag[i].handler)();
+			return;
+		}
+	}
+	LINK_sendFrame(LINK_DIAG_UNKNOWN,&command,1);
+}
+
+/* Byte received outside the secure link frames */
+static void LINK_onRawByte(uint8 data){
+	if(data==LINK_DIAG_REQUEST){
+		LINK_serveDiag(UART_receiveByte());
+	}
+}
+
+void LINK_init(void){
+	SecLink_setRawHandler(&LINK_onRawByte);
+}
+
+uint8 LINK_registerDiag(uint8 command,void(*a_ptr)(void)){
+	if(g_diag_count==LINK_MAX_DIAG_COMMANDS||a_ptr==NULL_PTR){
+		return ERROR;
+	}
+	g_diag[g_diag_count].command=command;
+	g_diag[g_diag_count].handler=a_ptr;
+	g_diag_count++;
+	return SUCCESS;
+}
+
+void LINK_sendFrame(uint8 command,const uint8 *data,uint8 length){
+	uint8 i;
+	uint16 crc=CRC16_update(CRC16_update(CRC16_INIT,command),length);
+
+	UART_sendByte(LINK_FRAME_START);
+	UART_sendByte(command);
+	UART_sendByte(length);
+	for(i=0;i<length;i++){
+		UART_sendByte(data[i]);
+		crc=CRC16_update(crc,data[i]);
+	}
+	UART_sendByte((uint8)crc);
+	UART_sendByte((uint8)(crc>>8));
+}
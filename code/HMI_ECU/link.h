@@ -0,0 +1,65 @@
+/*******************************
+ *  link.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include "std_types.h"
+
+/*
+ * Diagnostic requests to the HMI, same framing as on CONTROL_ECU: a
+ * maintenance tool plugged in place of CONTROL_ECU sends LINK_DIAG_REQUEST
+ * followed by a command byte in clear, between secure link frames. The
+ * answer, also in clear, is one frame:
+ *
+ *   LINK_FRAME_START, command, length, length data bytes, CRC-16 (low byte first)
+ *
+ * The CRC covers the command, the length and the data.
+ */
+#define LINK_DIAG_REQUEST       0xD1
+#define LINK_FRAME_START        0xD2
+
+/* Maximum number of diagnostic commands that can be registered */
+#define LINK_MAX_DIAG_COMMANDS  8
+
+/* Diagnostic commands */
+#define LINK_DIAG_BOOT_PROFILE  0x05   /* Boot phase timestamps, see BootProfile_dump */
+#define LINK_DIAG_SUPERVISOR    0x07   /* Task that missed its deadline and maximum task latencies, see Supervisor_dump */
+#define LINK_DIAG_PROFILE       0x09   /* Sampling profiler histogram, profiling builds only, see Profiler_dump */
+#define LINK_DIAG_TRACE         0x0A   /* Event trace ring, tracing builds only, see Trace_dump */
+#define LINK_DIAG_LOG           0x0B   /* Deferred-format log messages, logging builds only, see Log_dump */
+#define LINK_DIAG_RAM           0x0C   /* Section sizes, stack high-water mark and free SRAM, see RamUsage_dump */
+#define LINK_DIAG_LATENCY       0x0D   /* Stage timestamps of the last password checks, see Latency_dump */
+#define LINK_DIAG_METRICS       0x0E   /* Snapshot of the counters and gauges, see Metrics_dump */
+
+/* Command byte of the frame sent back for an unknown command, its data is the command */
+#define LINK_DIAG_UNKNOWN       0xFF
+
+/*
+ * Description:
+ * Take the bytes received outside the secure link frames, to serve the
+ * diagnostic requests.
+ */
+void LINK_init(void);
+
+/*
+ * Description:
+ * Set the function called when the given diagnostic command is received.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if the table is full.
+ */
+uint8 LINK_registerDiag(uint8 command,void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Send one diagnostic frame.
+ */
+void LINK_sendFrame(uint8 command,const uint8 *data,uint8 length);
+
+#endif /* LINK_H_ */
@@ -0,0 +1,96 @@
+/*******************************
+ *  log.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "std_types.h"
+#include "log_ids.h"
+
+/*
+ * Deferred-format log: a call stores the message id, its level, the SysTick
+ * milliseconds and up to LOG_MAX_ARGS 16-bit arguments in a RAM buffer, the
+ * text is made by tools/log.py from log_ids.h. The buffer is read and
+ * cleared by diagnostic command LINK_DIAG_LOG. Safe from ISRs.
+ *
+ * Levels above LOG_LEVEL compile to nothing, arguments included. The
+ * default is LOG_LEVEL_NONE, build with e.g. -DLOG_LEVEL=LOG_LEVEL_INFO.
+ *
+ *   LOG_WARN(LOG_WRONG_PASSWORD,role,attempts);
+ */
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3
+#define LOG_LEVEL_DEBUG         4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL               LOG_LEVEL_NONE
+#endif
+
+/* Bytes of the message buffer, a message takes 4 bytes plus 2 per argument */
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE         96
+#endif
+
+#define LOG_MAX_ARGS            4
+
+/* Message bytes sent in one diagnostic frame at most */
+#define LOG_FRAME_SIZE          24
+
+#define LOG_WRITE(LEVEL,ID,...) \
+	do{ \
+		const uint16 log_args[]={0,##__VA_ARGS__}; \
+		Log_write((LEVEL),(ID),&log_args[1],(uint8)(sizeof(log_args)/sizeof(uint16)-1)); \
+	}while(0)
+
+#if LOG_LEVEL>=LOG_LEVEL_ERROR
+#define LOG_ERROR(...)          LOG_WRITE(LOG_LEVEL_ERROR,__VA_ARGS__)
+#else
+#define LOG_ERROR(...)          ((void)0)
+#endif
+
+#if LOG_LEVEL>=LOG_LEVEL_WARN
+#define LOG_WARN(...)           LOG_WRITE(LOG_LEVEL_WARN,__VA_ARGS__)
+#else
+#define LOG_WARN(...)           ((void)0)
+#endif
+
+#if LOG_LEVEL>=LOG_LEVEL_INFO
+#define LOG_INFO(...)           LOG_WRITE(LOG_LEVEL_INFO,__VA_ARGS__)
+#else
+#define LOG_INFO(...)           ((void)0)
+#endif
+
+#if LOG_LEVEL>=LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)          LOG_WRITE(LOG_LEVEL_DEBUG,__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)          ((void)0)
+#endif
+
+/*
+ * Description:
+ * Store one message, use the LOG_<level>() macros so that it disappears
+ * below LOG_LEVEL. Arguments past LOG_MAX_ARGS are dropped. A message that
+ * does not fit in the buffer is dropped and counted.
+ */
+void Log_write(uint8 level,uint8 id,const uint16 *args,uint8 count);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_LOG: send the buffered messages, oldest
+ * first, and clear the buffer. Frames:
+ *  - header: current SysTick milliseconds (uint32), messages dropped (uint16)
+ *  - messages: whole messages, up to LOG_FRAME_SIZE bytes, each one its id,
+ *    level (high nibble) and argument count (low nibble), milliseconds (low
+ *    16 bits), then the arguments (uint16)
+ *  - end: no data
+ */
+void Log_dump(void);
+
+#endif /* LOG_H_ */
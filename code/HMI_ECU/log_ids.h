@@ -0,0 +1,38 @@
+/*******************************
+ *  log_ids.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef LOG_IDS_H_
+#define LOG_IDS_H_
+
+/*
+ * Log messages of both ECUs: X(id, "format"). The format strings are only
+ * read by tools/log.py, they are not compiled into the firmware. The
+ * arguments are 16-bit: %d and %i print them signed, %u %x %X %c unsigned.
+ * Keep one message per line and add new ones at the end, the position in
+ * the list is the id sent on the wire.
+ */
+#define LOG_ID_LIST(X) \
+	X(LOG_BOOT,             "boot, reset cause 0x%02x, breadcrumb step %u phase %u") \
+	X(LOG_DOOR_RESUMED,     "door cycle resumed at segment %u, %u ticks left") \
+	X(LOG_LOCKOUT_RESUMED,  "alarm resumed, %u ticks left") \
+	X(LOG_SESSION,          "secure link session, HMI starts at step %u") \
+	X(LOG_UNLOCK,           "door opened by slot %u") \
+	X(LOG_WRONG_PASSWORD,   "wrong password for role %u, attempt %u") \
+	X(LOG_LOCKOUT,          "too many wrong passwords, alarm for %u ticks") \
+	X(LOG_TWI_FAILED,       "i2c transaction to 0x%02x register 0x%02x failed") \
+	X(LOG_HANDSHAKE_RETRY,  "no reply to HELLO, sending it again") \
+	X(LOG_STANDBY,          "standby state %u")
+
+#define LOG_ID_ENUM(ID,FORMAT) ID,
+
+typedef enum {
+	LOG_ID_LIST(LOG_ID_ENUM)
+	LOG_ID_COUNT
+}Log_IdType;
+
+#endif /* LOG_IDS_H_ */
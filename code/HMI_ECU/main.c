@@ -11,7 +11,19 @@
 #include "lcd.h"
 #include <avr/io.h>
 #include <util/delay.h>
-#include "Timer1.h"
+#include "timer1.h"
+#include "seclink.h"
+#include "systick.h"
+#include "link.h"
+#include "boot_profile.h"
+#include "standby.h"
+#include "profiler.h"
+#include "trace.h"
+#include "log.h"
+#include "ram_usage.h"
+#include "latency.h"
+#include "metrics.h"
+#include "supervisor.h"
 
 /* Define constants for password length, special keys, and communication signals */
 #define PASSWORD_LENGTH 5
@@ -19,11 +31,53 @@
 #define CONTROL_ECU_READY 0x10
 #define HMI_ECU_READY 0x11
 #define OPEN_GATE 0x15
+#define DOOR_SEGMENT 0x16
+
+/* Motor directions used in the door profile sent by CONTROL_ECU */
+#define DOOR_STOP 0
+#define DOOR_OPENING 1
+#define DOOR_CLOSING 2
+#define DOOR_MAX_SEGMENTS 6
 
 /* Global variables for tracking system steps and timing */
 uint8 step = 1;
 uint8 tick1 = 0;
-uint8 tick = 0;
+uint8 lockout_ticks = 30; /* Alarm duration, sent by CONTROL_ECU when entering step 5 */
+
+/* Door profile sent by CONTROL_ECU, the running segment follows its DOOR_SEGMENT messages */
+uint8 door_segment_count = 0;
+uint8 door_direction[DOOR_MAX_SEGMENTS];
+uint8 door_duration[DOOR_MAX_SEGMENTS];
+uint8 door_segment = 0;
+uint8 door_running = 0;
+
+/* 
+ * Description:
+ * Function to wait for CONTROL_ECU to be ready. It also returns when the session
+ * restarted meanwhile, the main loop then reads the step CONTROL_ECU sends.
+ */
+void wait_control_ready() {
+    while (SecLink_receiveByte() != CONTROL_ECU_READY && !SecLink_isRestarted());
+}
+
+/* 
+ * Description:
+ * Function called while the HMI waits for a message from CONTROL_ECU or between
+ * the HELLOs of a handshake: waiting on the link is no hang.
+ */
+void link_idle(void) {
+    Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+}
+
+/* 
+ * Description:
+ * Function to read a key. A held key returns at once, without the idle scans
+ * that check in while nobody presses one, so every read checks in as well.
+ */
+uint8 read_key(void) {
+    Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+    return KEYPAD_getPressedKey();
+}
 
 /* 
  * Description:
@@ -31,7 +85,7 @@ uint8 tick = 0;
  * The user enters the password twice, and it is sent to the CONTROL_ECU for verification.
  */
 void create_system_password() {
-    UART_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start transmission */
+    SecLink_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start transmission */
 
     LCD_clearScreen();
     uint8 i = 0;
@@ -40,13 +94,13 @@ void create_system_password() {
 
     /* User enters the password */
     while (i < PASSWORD_LENGTH) {
-        UART_sendByte(KEYPAD_getPressedKey()); /* Send each key to CONTROL_ECU */
+        SecLink_sendByte(read_key()); /* Send each key to CONTROL_ECU */
         _delay_ms(250); /* Debounce delay */
         LCD_displayString("*");
         i++;
     }
     /* Wait for the user to press the enter button */
-    while (KEYPAD_getPressedKey() != ENTER_BUTTON);
+    while (read_key() != ENTER_BUTTON);
     _delay_ms(150); /* Debounce delay */
 
     /* Prompt user to re-enter the password for confirmation */
@@ -56,16 +110,16 @@ void create_system_password() {
     LCD_moveCursor(1, 0);
     LCD_displayString("same pass:");
 
-    UART_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start transmission again */
+    SecLink_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start transmission again */
 
     /* User re-enters the password */
     while (i < PASSWORD_LENGTH) {
-        UART_sendByte(KEYPAD_getPressedKey()); /* Send each key to CONTROL_ECU */
+        SecLink_sendByte(read_key()); /* Send each key to CONTROL_ECU */
         _delay_ms(250); /* Debounce delay */
         LCD_displayString("*");
         i++;
     }
-    while (KEYPAD_getPressedKey() != ENTER_BUTTON);
+    while (read_key() != ENTER_BUTTON);
     _delay_ms(250); /* Debounce delay */
 }
 
@@ -82,37 +136,75 @@ void read_password() {
 
     /* User enters the password */
     while (i < PASSWORD_LENGTH) {
-        read_password[i] = KEYPAD_getPressedKey();
+        read_password[i] = read_key();
         _delay_ms(250); /* Debounce delay */
         LCD_displayString("*");
         i++;
     }
-    while (KEYPAD_getPressedKey() != ENTER_BUTTON);
+    while (read_key() != ENTER_BUTTON);
+    Latency_mark(LATENCY_KEY_ENTER);
     _delay_ms(250); /* Debounce delay */
 
     /* Send the entered password to CONTROL_ECU */
     for (i = 0; i < PASSWORD_LENGTH; i++) {
-        UART_sendByte(read_password[i]);
+        SecLink_sendByte(read_password[i]);
     }
+    Latency_mark(LATENCY_PASSWORD_SENT);
+    Latency_setKey((uint16)SecLink_getSentCount());
 }
 
 /* 
  * Description:
- * Function to rotate the motor and open the door when the password is correct.
- * This function is executed by the Timer1 callback.
+ * Function to receive the door profile that follows OPEN_GATE: the segment count,
+ * then the direction and duration (in seconds) of every segment.
  */
-void rotate_motor_open_door() {
-    tick++;
-    if (tick == 15) {
-        TCNT1 = 0;
-        LCD_clearScreen();
-        LCD_displayString("Locking in 3 sec");
-    } else if (tick == 18) {
-        TCNT1 = 0;
-        LCD_clearScreen();
+void receive_door_profile() {
+    uint8 i;
+    door_segment_count = SecLink_receiveByte();
+    if (door_segment_count > DOOR_MAX_SEGMENTS) {
+        door_segment_count = DOOR_MAX_SEGMENTS;
+    }
+    for (i = 0; i < door_segment_count; i++) {
+        door_direction[i] = SecLink_receiveByte();
+        door_duration[i] = SecLink_receiveByte();
+    }
+}
+
+/* 
+ * Description:
+ * Function to show the message of the current door segment on the LCD. A stop
+ * only counts down to locking when the door closes right after it.
+ */
+void display_door_segment() {
+    LCD_clearScreen();
+    if (door_direction[door_segment] == DOOR_OPENING) {
+        LCD_displayString("Door is Unlocking");
+    } else if (door_direction[door_segment] == DOOR_CLOSING) {
         LCD_displayString("Door is Locking");
-    } else if (tick == 33) {
-        Timer1_deInit();
+    } else if (door_segment + 1 < door_segment_count && door_direction[door_segment + 1] == DOOR_CLOSING) {
+        LCD_displayString("Locking in ");
+        LCD_intgerToString(door_duration[door_segment]);
+        LCD_displayString(" sec");
+    } else {
+        LCD_displayString("Door is Stopped");
+    }
+}
+
+/* 
+ * Description:
+ * Function to follow the door cycle on the LCD while CONTROL_ECU moves the motor.
+ * CONTROL_ECU sends DOOR_SEGMENT and the new segment whenever one ends, on time
+ * or early at its limit switch; the segment count means the cycle is over.
+ */
+void follow_door_segment() {
+    if (SecLink_receiveByte() != DOOR_SEGMENT) {
+        return;
+    }
+    door_segment = SecLink_receiveByte();
+    if (door_segment < door_segment_count) {
+        display_door_segment();
+    } else {
+        door_running = 0;
     }
 }
 
@@ -123,7 +215,7 @@ void rotate_motor_open_door() {
  */
 void system_locked(void) {
     tick1++;
-    if (tick1 == 30) {
+    if (tick1 == lockout_ticks) {
         Timer1_deInit();
     }
 }
@@ -140,63 +232,123 @@ int main(void) {
         COMPARE_MODE
     };
 
+    SysTick_init();
+    BootProfile_start();
     SREG |= (1 << 7); /* Enable global interrupts */
-    LCD_init();
+    Supervisor_init(); /* Watchdog on from here, the main loop and its waits check in */
     UART_init(&uart);
+    LINK_init();
+    LINK_registerDiag(LINK_DIAG_BOOT_PROFILE, &BootProfile_dump);
+    LINK_registerDiag(LINK_DIAG_SUPERVISOR, &Supervisor_dump);
+    LINK_registerDiag(LINK_DIAG_RAM, &RamUsage_dump);
+    LINK_registerDiag(LINK_DIAG_LATENCY, &Latency_dump);
+    LINK_registerDiag(LINK_DIAG_METRICS, &Metrics_dump);
+#if PROFILER_ENABLED
+    Profiler_init();
+    LINK_registerDiag(LINK_DIAG_PROFILE, &Profiler_dump);
+#endif
+#if TRACE_ENABLED
+    LINK_registerDiag(LINK_DIAG_TRACE, &Trace_dump);
+#endif
+#if LOG_LEVEL > LOG_LEVEL_NONE
+    LINK_registerDiag(LINK_DIAG_LOG, &Log_dump);
+#endif
+    SecLink_setIdleCallBack(&link_idle);
+    BootProfile_mark(BOOT_MARK_LINK);
+
+    /*
+     * The handshake goes first: CONTROL_ECU needs longer to boot, and the
+     * LCD power on delay runs from SysTick_init, so it has elapsed by now.
+     */
+    SecLink_connect(); /* Session keys with CONTROL_ECU, every message is encrypted from here on */
+    BootProfile_mark(BOOT_MARK_HANDSHAKE);
+    LCD_init();
+    Standby_init();
+    BootProfile_mark(BOOT_MARK_LCD);
+
+    uint8 choice, step;
 
-    uint8 choice, step = 1;
+    /* CONTROL_ECU starts at step 2 when a password is already stored, step 1 otherwise */
+    step = SecLink_receiveByte();
+    LOG_INFO(LOG_SESSION, step);
+    BootProfile_end(BOOT_MARK_READY);
 
     while (1) {
+        Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+
+        /*
+         * CONTROL_ECU was reset or the link was keyed again: whatever step was in
+         * progress is void, CONTROL_ECU sends the step to start from as after boot.
+         * A receive of that step returns 0 while the flag is set, no step matches it.
+         */
+        if (SecLink_isRestarted()) {
+            SecLink_clearRestarted();
+            Timer1_deInit();
+            tick1 = 0;
+            door_running = 0;
+            step = SecLink_receiveByte();
+            LOG_INFO(LOG_SESSION, step);
+            continue;
+        }
+        TRACE(TRACE_STEP, step);
         if (step == 1) {
             create_system_password();
 
             /* Wait for CONTROL_ECU to be ready */
-            while (UART_receiveByte() != CONTROL_ECU_READY);
+            wait_control_ready();
 
             /* Get the next step from CONTROL_ECU */
-            step = UART_receiveByte();
+            step = SecLink_receiveByte();
         } else if (step == 2) {
-            UART_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
+            SecLink_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
 
             LCD_clearScreen();
             LCD_displayString("+ : Open Door");
             LCD_moveCursor(1, 0);
             LCD_displayString("- : Change Pass");
-            choice = KEYPAD_getPressedKey();
+            choice = read_key();
             _delay_ms(250); /* Debounce delay */
 
             if (choice == '+') {
-                UART_sendByte(choice); /* Send choice to CONTROL_ECU */
-                while (UART_receiveByte() != CONTROL_ECU_READY);
-                step = UART_receiveByte(); /* Get the next step from CONTROL_ECU */
+                SecLink_sendByte(choice); /* Send choice to CONTROL_ECU */
+                wait_control_ready();
+                step = SecLink_receiveByte(); /* Get the next step from CONTROL_ECU */
             } else if (choice == '-') {
-                UART_sendByte(choice); /* Send choice to CONTROL_ECU */
-                while (UART_receiveByte() != CONTROL_ECU_READY);
-                step = UART_receiveByte(); /* Get the next step from CONTROL_ECU */
+                SecLink_sendByte(choice); /* Send choice to CONTROL_ECU */
+                wait_control_ready();
+                step = SecLink_receiveByte(); /* Get the next step from CONTROL_ECU */
             }
         } else if (step == 3) {
-            UART_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
+            SecLink_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
             read_password(); /* Read password from user */
 
-            while (UART_receiveByte() != CONTROL_ECU_READY);
-            uint8 receiveByte = UART_receiveByte();
+            wait_control_ready();
+            Latency_mark(LATENCY_REPLY_RECEIVED);
+            uint8 receiveByte = SecLink_receiveByte();
 
             if (receiveByte == OPEN_GATE) {
-                LCD_clearScreen();
-                Timer1_init(&timer1); /* Initialize Timer1 */
-                LCD_displayString("Door is Unlocking");
-                Timer1_setCallBack(&rotate_motor_open_door);
-                step = 6;
+                receive_door_profile();
+                if (door_segment_count == 0) {
+                    step = 2;
+                } else {
+                    door_segment = 0;
+                    door_running = 1;
+                    display_door_segment();
+                    Latency_mark(LATENCY_DOOR_SHOWN);
+                    step = 6;
+                }
             } else if (receiveByte == 5) {
                 step = 5;
             }
         } else if (step == 4) {
-            UART_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
+            SecLink_sendByte(HMI_ECU_READY); /* Signal CONTROL_ECU to start communication */
             read_password(); /* Read password from user */
 
-            while (UART_receiveByte() != CONTROL_ECU_READY);
-            step = UART_receiveByte(); /* Get the next step from CONTROL_ECU */
+            wait_control_ready();
+            Latency_mark(LATENCY_REPLY_RECEIVED);
+            step = SecLink_receiveByte(); /* Get the next step from CONTROL_ECU */
         } else if (step == 5) {
+            lockout_ticks = SecLink_receiveByte(); /* Alarm duration configured on CONTROL_ECU */
             LCD_clearScreen();
             LCD_displayString("ERROR");
             Timer1_init(&timer1); /* Initialize Timer1 */
@@ -204,14 +356,16 @@ int main(void) {
             step = 6;
         } else if (step == 6) {
             /* Return to step 2 if the system was locked */
-            if (tick1 == 30) {
+            if (tick1 == lockout_ticks) {
                 step = 2;
                 tick1 = 0;
             }
-            /* Return to step 2 after door operation */
-            if (tick == 33) {
-                step = 2;
-                tick = 0;
+            /* Follow the door cycle, return to step 2 once it is over */
+            if (door_running) {
+                follow_door_segment();
+                if (!door_running) {
+                    step = 2;
+                }
             }
         }
     }
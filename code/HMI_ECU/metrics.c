@@ -0,0 +1,26 @@
+/*******************************
+ *  metrics.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "metrics.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <string.h>
+
+uint16 g_metrics[METRIC_COUNT];
+
+void Metrics_dump(void){
+	uint8 frame[1+sizeof(g_metrics)];
+	uint8 sreg=SREG;
+
+	frame[0]=METRIC_COUNT;
+	cli();
+	memcpy(&frame[1],g_metrics,sizeof(g_metrics));
+	SREG=sreg;
+	LINK_sendFrame(LINK_DIAG_METRICS,frame,sizeof(frame));
+}
@@ -0,0 +1,46 @@
+/*******************************
+ *  metrics.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include "std_types.h"
+#include "metric_ids.h"
+
+/*
+ * Counters and gauges listed in metric_ids.h, 16 bits each, read all at
+ * once by diagnostic command LINK_DIAG_METRICS. An update is a single
+ * access to g_metrics, it is not made atomic: update a metric either from
+ * one ISR or from the main loop, not from both.
+ */
+extern uint16 g_metrics[METRIC_COUNT];
+
+/* Count one event */
+#define METRIC_INC(ID)          (g_metrics[(ID)]++)
+
+/* Set a gauge */
+#define METRIC_SET(ID,VALUE)    (g_metrics[(ID)]=(uint16)(VALUE))
+
+/* Raise a high-water mark gauge to VALUE if it is below */
+#define METRIC_MAX(ID,VALUE) \
+	do{ \
+		uint16 metric_value=(uint16)(VALUE); \
+		if(metric_value>g_metrics[(ID)]){ \
+			g_metrics[(ID)]=metric_value; \
+		} \
+	}while(0)
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_METRICS: send one frame holding the
+ * number of metrics, then every metric (uint16) in the order of
+ * metric_ids.h, all read at the same instant.
+ */
+void Metrics_dump(void);
+
+#endif /* METRICS_H_ */
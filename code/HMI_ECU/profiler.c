@@ -0,0 +1,140 @@
+/*******************************
+ *  profiler.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile uint16 g_buckets[PROFILER_BUCKETS];
+static volatile uint32 g_samples=0;
+static volatile uint32 g_outside=0;
+
+void Profiler_sample(uint16 pc) __attribute__((used));
+
+/*
+ * Called by the Timer0 overflow ISR with the interrupted program counter.
+ * The PC counts 16-bit words, the 32 KB of flash fit a 16-bit byte address.
+ */
+void Profiler_sample(uint16 pc){
+	uint16 address=pc<<1;
+	uint16 bucket=(uint16)(address-PROFILER_BASE)>>PROFILER_BUCKET_SHIFT;
+
+	g_samples++;
+	if(address<PROFILER_BASE||bucket>=PROFILER_BUCKETS){
+		g_outside++;
+	}
+	else if(g_buckets[bucket]!=0xFFFF){
+		g_buckets[bucket]++;
+	}
+}
+
+/*
+ * ISR for Timer0 Overflow. Naked, so that the return address is at a known
+ * place: only the registers a C function may change are saved, then the
+ * return address (high byte first) follows the 15 saved bytes.
+ */
+ISR(TIMER0_OVF_vect,ISR_NAKED){
+	__asm__ __volatile__(
+		"push r1\n\t"
+		"push r0\n\t"
+		"in r0,__SREG__\n\t"
+		"push r0\n\t"
+		"clr r1\n\t"
+		"push r18\n\t"
+		"push r19\n\t"
+		"push r20\n\t"
+		"push r21\n\t"
+		"push r22\n\t"
+		"push r23\n\t"
+		"push r24\n\t"
+		"push r25\n\t"
+		"push r26\n\t"
+		"push r27\n\t"
+		"push r30\n\t"
+		"push r31\n\t"
+		"in r30,__SP_L__\n\t"
+		"in r31,__SP_H__\n\t"
+		"ldd r25,Z+16\n\t"
+		"ldd r24,Z+17\n\t"
+		"call Profiler_sample\n\t"
+		"pop r31\n\t"
+		"pop r30\n\t"
+		"pop r27\n\t"
+		"pop r26\n\t"
+		"pop r25\n\t"
+		"pop r24\n\t"
+		"pop r23\n\t"
+		"pop r22\n\t"
+		"pop r21\n\t"
+		"pop r20\n\t"
+		"pop r19\n\t"
+		"pop r18\n\t"
+		"pop r0\n\t"
+		"out __SREG__,r0\n\t"
+		"pop r0\n\t"
+		"pop r1\n\t"
+		"reti\n\t"
+	);
+}
+
+static void Profiler_clear(void){
+	uint8 i;
+	for(i=0;i<PROFILER_BUCKETS;i++){
+		g_buckets[i]=0;
+	}
+	g_samples=0;
+	g_outside=0;
+}
+
+void Profiler_init(void){
+	Profiler_clear();
+	/* No clock selected yet: normal mode, prescaler 8 as the PWM uses */
+	if((TCCR0&((1<<CS02)|(1<<CS01)|(1<<CS00)))==0){
+		TCCR0=(1<<CS01);
+	}
+	TIMSK|=(1<<TOIE0);
+}
+
+void Profiler_dump(void){
+	uint8 frame[1+2*PROFILER_FRAME_BUCKETS];
+	uint16 count;
+	uint8 i;
+	uint8 j;
+
+	TIMSK&=~(1<<TOIE0);
+
+	frame[0]=(uint8)PROFILER_BASE;
+	frame[1]=(uint8)(PROFILER_BASE>>8);
+	frame[2]=PROFILER_BUCKET_SHIFT;
+	frame[3]=PROFILER_BUCKETS;
+	for(j=0;j<4;j++){
+		frame[4+j]=(uint8)(g_samples>>(8*j));
+		frame[8+j]=(uint8)(g_outside>>(8*j));
+	}
+	LINK_sendFrame(LINK_DIAG_PROFILE,frame,12);
+
+	for(i=0;i<PROFILER_BUCKETS;i+=j){
+		frame[0]=i;
+		for(j=0;j<PROFILER_FRAME_BUCKETS&&i+j<PROFILER_BUCKETS;j++){
+			count=g_buckets[i+j];
+			frame[1+2*j]=(uint8)count;
+			frame[2+2*j]=(uint8)(count>>8);
+		}
+		LINK_sendFrame(LINK_DIAG_PROFILE,frame,1+2*j);
+	}
+	LINK_sendFrame(LINK_DIAG_PROFILE,frame,0);
+
+	Profiler_clear();
+	TIMSK|=(1<<TOIE0);
+}
+
+#endif /* PROFILER_ENABLED */
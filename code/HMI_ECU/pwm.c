@@ -0,0 +1,25 @@
+/*******************************
+ *  pwm.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include"gpio.h"
+#include<avr/io.h>
+#include"pwm.h"
+
+void PWM_TIMER0_start(uint8 duty_cycle){
+		OCR0  = duty_cycle;
+
+		/* set the backlight pin as output pin*/
+		GPIO_setupPinDirection(BACKLIGHT_PORT_ID,BACKLIGHT_PIN_ID,PIN_OUTPUT);
+
+		TCCR0 = (1<<WGM00) | (1<<WGM01) | (1<<COM01) | (1<<CS01);
+}
+
+void PWM_TIMER0_stop(void){
+		TCCR0 = 0;
+		GPIO_writePin(BACKLIGHT_PORT_ID,BACKLIGHT_PIN_ID,LOGIC_LOW);
+}
@@ -0,0 +1,22 @@
+/*******************************
+ *  pwm.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef PWM_H_
+#define PWM_H_
+#include "std_types.h"
+
+/* OC0 pin, drives the transistor of the LCD backlight */
+#define BACKLIGHT_PORT_ID PORTB_ID
+#define BACKLIGHT_PIN_ID PIN3_ID
+
+void PWM_TIMER0_start(uint8 duty_cycle);
+
+/* Stop Timer0 and hold the pin low, the backlight is off */
+void PWM_TIMER0_stop(void);
+
+#endif /* PWM_H_ */
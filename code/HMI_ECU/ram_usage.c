@@ -0,0 +1,71 @@
+/*******************************
+ *  ram_usage.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "ram_usage.h"
+#include "link.h"
+#include <avr/io.h>
+
+/* Section boundaries defined by the avr-libc linker script */
+extern uint8 __data_start;
+extern uint8 __data_end;
+extern uint8 __bss_start;
+extern uint8 __bss_end;
+extern uint8 __noinit_start;
+extern uint8 __noinit_end;
+extern uint8 _end;
+
+void RamUsage_paint(void) __attribute__((naked,used,section(".init1")));
+
+/*
+ * Fill _end..RAMEND with the canary. Runs from the reset vector before the
+ * C runtime is set up: no stack, no zero register, so plain assembly.
+ */
+void RamUsage_paint(void){
+	__asm__ __volatile__(
+		"	ldi r30,lo8(_end)\n"
+		"	ldi r31,hi8(_end)\n"
+		"	ldi r24,%0\n"
+		"	ldi r25,hi8(%1)\n"
+		"	rjmp 2f\n"
+		"1:	st Z+,r24\n"
+		"2:	cpi r30,lo8(%1)\n"
+		"	cpc r31,r25\n"
+		"	brlo 1b\n"
+		"	breq 1b\n"
+		::"M"(RAM_USAGE_CANARY),"i"(RAMEND));
+}
+
+/* Lowest address the stack has written since reset */
+static const uint8 *RamUsage_findStackBottom(void){
+	const uint8 *p=&_end;
+	while(p<=(const uint8*)RAMEND&&*p==RAM_USAGE_CANARY){
+		p++;
+	}
+	return p;
+}
+
+uint16 RamUsage_getStackHighWater(void){
+	return (uint16)((const uint8*)RAMEND-RamUsage_findStackBottom()+1);
+}
+
+uint16 RamUsage_getFree(void){
+	return (uint16)((const uint8*)SP-&_end);
+}
+
+void RamUsage_dump(void){
+	uint16 frame[6];
+	const uint8 *bottom=RamUsage_findStackBottom();
+
+	frame[0]=(uint16)(&__data_end-&__data_start);
+	frame[1]=(uint16)(&__bss_end-&__bss_start);
+	frame[2]=(uint16)(&__noinit_end-&__noinit_start);
+	frame[3]=(uint16)((const uint8*)RAMEND-bottom+1);
+	frame[4]=(uint16)(bottom-&_end);
+	frame[5]=RamUsage_getFree();
+	LINK_sendFrame(LINK_DIAG_RAM,(const uint8*)frame,sizeof(frame));
+}
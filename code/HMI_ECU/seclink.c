@@ -0,0 +1,382 @@
+/*******************************
+ *  seclink.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "seclink.h"
+#include "speck.h"
+#include "uart.h"
+#include "trace.h"
+#include "metrics.h"
+#include "log.h"
+#include "systick.h"
+#include <avr/eeprom.h>
+#include <string.h>
+
+#define SECLINK_ROLE        SECLINK_ROLE_HMI
+#define SECLINK_PEER_ROLE   SECLINK_ROLE_CONTROL
+
+typedef struct {
+	Speck_KeyType enc_key;
+	Speck_KeyType mac_key;
+	uint32 tx_counter;
+	uint32 rx_counter;
+	boolean established;
+} SecLink_SessionType;
+
+static const uint8 g_pairing_key[SPECK_KEY_SIZE]=SECLINK_PAIRING_KEY;
+
+static SecLink_SessionType g_session;
+
+/* Payload of the last authenticated frame, handed out byte by byte */
+static uint8 g_rx_buffer[SECLINK_MAX_PAYLOAD];
+static uint8 g_rx_length=0;
+static uint8 g_rx_position=0;
+
+/* Handshake counter in the internal EEPROM, part of every HMI nonce */
+static uint32 EEMEM g_nonce_counter;
+
+/* Counter of the CONTROL nonce of the session, a SECLINK_RESET must carry a higher one */
+static uint32 g_peer_counter=0;
+
+/* Frames in a row failing the tag */
+static uint8 g_rejected=0;
+
+/* A new session started inside SecLink_receiveByte, cleared by SecLink_clearRestarted */
+static boolean g_restarted=FALSE;
+
+static void(*g_raw_ptr)(uint8 data)=NULL_PTR;
+static void(*g_idle_ptr)(void)=NULL_PTR;
+
+/* Block holding a message counter, the sender and one byte of context */
+static void SecLink_header(uint8 *block,uint32 counter,uint8 sender,uint8 context){
+	memcpy(block,&counter,4);
+	block[4]=sender;
+	block[5]=context;
+	block[6]=0;
+	block[7]=0;
+}
+
+/* Counter mode, keystream block i is the encrypted header with context i */
+static void SecLink_crypt(uint32 counter,uint8 sender,uint8 *data,uint8 length){
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	for(i=0;i<length;i++){
+		if((i&(SPECK_BLOCK_SIZE-1))==0){
+			SecLink_header(block,counter,sender,i/SPECK_BLOCK_SIZE);
+			Speck_encrypt(&g_session.enc_key,block);
+		}
+		data[i]^=block[i&(SPECK_BLOCK_SIZE-1)];
+	}
+}
+
+/* CBC-MAC of the header (context = length) and the zero padded ciphertext */
+static void SecLink_mac(uint32 counter,uint8 sender,const uint8 *data,uint8 length,uint8 *tag){
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	SecLink_header(block,counter,sender,length);
+	Speck_encrypt(&g_session.mac_key,block);
+	for(i=0;i<length;i++){
+		block[i&(SPECK_BLOCK_SIZE-1)]^=data[i];
+		if((i&(SPECK_BLOCK_SIZE-1))==SPECK_BLOCK_SIZE-1||i==length-1){
+			Speck_encrypt(&g_session.mac_key,block);
+		}
+	}
+	memcpy(tag,block,SECLINK_TAG_SIZE);
+}
+
+static void SecLink_deriveKeys(const uint8 *hmi_nonce,const uint8 *control_nonce){
+	uint8 key[SPECK_KEY_SIZE];
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 i;
+	uint8 j;
+
+	/* The pairing key is expanded where the MAC key goes, it is overwritten last */
+	Speck_expandKey(&g_session.mac_key,g_pairing_key);
+
+	/* Output i = CBC-MAC(i, HMI nonce, CONTROL nonce), 0-1 form the encryption key, 2-3 the MAC key */
+	for(i=0;i<4;i++){
+		memset(block,0,SPECK_BLOCK_SIZE);
+		block[0]=i;
+		Speck_encrypt(&g_session.mac_key,block);
+		for(j=0;j<SECLINK_NONCE_SIZE;j++){
+			block[j]^=hmi_nonce[j];
+		}
+		Speck_encrypt(&g_session.mac_key,block);
+		for(j=0;j<SECLINK_NONCE_SIZE;j++){
+			block[j]^=control_nonce[j];
+		}
+		Speck_encrypt(&g_session.mac_key,block);
+		memcpy(&key[(i&1)*SPECK_BLOCK_SIZE],block,SPECK_BLOCK_SIZE);
+		if(i==1){
+			Speck_expandKey(&g_session.enc_key,key);
+		}
+	}
+	Speck_expandKey(&g_session.mac_key,key);
+
+	g_session.tx_counter=0;
+	g_session.rx_counter=0;
+	g_rejected=0;
+	g_rx_length=0;
+	g_rx_position=0;
+}
+
+/*
+ * Read the next byte of a message, FALSE if none comes within timeout_ms.
+ * A byte taken for the start of a message by mistake (a REPLY or
+ * FRAME_START inside other bytes) cannot leave the HMI waiting for the rest.
+ */
+static boolean SecLink_receiveTimed(uint8 *data,uint8 timeout_ms){
+	uint32 start=SysTick_getMillis();
+	while(!UART_isByteAvailable()){
+		if(SysTick_elapsedSince(start)>=timeout_ms){
+			return FALSE;
+		}
+	}
+	*data=UART_receiveByte();
+	return TRUE;
+}
+
+/* Wait up to SECLINK_REPLY_TIMEOUT_MS for SECLINK_REPLY, other bytes are dropped */
+static boolean SecLink_waitReply(void){
+	uint32 start=SysTick_getMillis();
+	while(SysTick_elapsedSince(start)<SECLINK_REPLY_TIMEOUT_MS){
+		if(UART_isByteAvailable()&&UART_receiveByte()==SECLINK_REPLY){
+			return TRUE;
+		}
+	}
+	LOG_WARN(LOG_HANDSHAKE_RETRY);
+	return FALSE;
+}
+
+/* Read the rest of a frame, keep its payload if the tag is right. A frame cut short is dropped. */
+static boolean SecLink_receiveFrame(void){
+	uint8 length;
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint8 expected[SECLINK_TAG_SIZE];
+	uint8 diff=0;
+	uint8 i;
+
+	if(!SecLink_receiveTimed(&length,SECLINK_REPLY_TIMEOUT_MS)||length>SECLINK_MAX_PAYLOAD){
+		METRIC_INC(METRIC_LINK_REJECTED);
+		return FALSE;
+	}
+	for(i=0;i<length;i++){
+		if(!SecLink_receiveTimed(&g_rx_buffer[i],SECLINK_REPLY_TIMEOUT_MS)){
+			METRIC_INC(METRIC_LINK_REJECTED);
+			return FALSE;
+		}
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		if(!SecLink_receiveTimed(&tag[i],SECLINK_REPLY_TIMEOUT_MS)){
+			METRIC_INC(METRIC_LINK_REJECTED);
+			return FALSE;
+		}
+	}
+
+	SecLink_mac(g_session.rx_counter,SECLINK_PEER_ROLE,g_rx_buffer,length,expected);
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		diff|=(uint8)(tag[i]^expected[i]);
+	}
+	if(diff!=0){
+		METRIC_INC(METRIC_LINK_REJECTED);
+		return FALSE;
+	}
+
+	SecLink_crypt(g_session.rx_counter,SECLINK_PEER_ROLE,g_rx_buffer,length);
+	g_session.rx_counter++;
+	TRACE(TRACE_LINK_RECEIVE,length);
+	g_rx_length=length;
+	g_rx_position=0;
+	return TRUE;
+}
+
+/* Wait up to SECLINK_REPLY_TIMEOUT_MS for the first frame of the session, it must hold SECLINK_CONFIRM */
+static boolean SecLink_waitConfirm(void){
+	uint32 start=SysTick_getMillis();
+	boolean confirmed;
+	while(SysTick_elapsedSince(start)<SECLINK_REPLY_TIMEOUT_MS){
+		if(UART_isByteAvailable()&&UART_receiveByte()==SECLINK_FRAME_START){
+			confirmed=(boolean)(SecLink_receiveFrame()&&g_rx_length==1&&g_rx_buffer[0]==SECLINK_CONFIRM);
+			g_rx_length=0;
+			g_rx_position=0;
+			return confirmed;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Rest of a SECLINK_RESET: TRUE if the tag is right and the counter is
+ * newer than the session. The pairing key is expanded on the stack, the
+ * session keys stay for a RESET that is refused.
+ */
+static boolean SecLink_checkReset(void){
+	Speck_KeyType key;
+	uint8 block[SPECK_BLOCK_SIZE];
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint32 counter;
+	uint8 diff=0;
+	uint8 i;
+
+	for(i=0;i<4;i++){
+		if(!SecLink_receiveTimed(&((uint8*)&counter)[i],SECLINK_BYTE_TIMEOUT_MS)){
+			return FALSE;
+		}
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		if(!SecLink_receiveTimed(&tag[i],SECLINK_BYTE_TIMEOUT_MS)){
+			return FALSE;
+		}
+	}
+	if(counter<=g_peer_counter){
+		return FALSE;
+	}
+
+	Speck_expandKey(&key,g_pairing_key);
+	SecLink_header(block,counter,SECLINK_PEER_ROLE,SECLINK_RESET);
+	Speck_encrypt(&key,block);
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		diff|=(uint8)(tag[i]^block[i]);
+	}
+	return (boolean)(diff==0);
+}
+
+void SecLink_connect(void){
+	uint8 hmi_nonce[SECLINK_NONCE_SIZE];
+	uint8 control_nonce[SECLINK_NONCE_SIZE];
+	uint32 counter;
+	uint32 hello=0;
+	uint8 i;
+
+	/*
+	 * The nonce must never repeat for the pairing key: the counter, bumped
+	 * before use, and the number of the HELLO since. Every HELLO has its own
+	 * nonce, CONTROL_ECU ignores one it has already answered.
+	 */
+	counter=eeprom_read_dword(&g_nonce_counter)+1;
+	eeprom_update_dword(&g_nonce_counter,counter);
+	memcpy(hmi_nonce,&counter,4);
+
+	g_session.established=FALSE;
+	while(!g_session.established){
+		if(g_idle_ptr!=NULL_PTR){
+			(*g_idle_ptr)();
+		}
+		hello++;
+		memcpy(hmi_nonce+4,&hello,4);
+		UART_sendByte(SECLINK_HELLO);
+		for(i=0;i<SECLINK_NONCE_SIZE;i++){
+			UART_sendByte(hmi_nonce[i]);
+		}
+
+		/* A REPLY to an earlier HELLO fails the confirmation, the one to this HELLO may follow */
+		while(!g_session.established&&SecLink_waitReply()){
+			/* A byte of another message read as REPLY has no nonce behind it */
+			for(i=0;i<SECLINK_NONCE_SIZE&&SecLink_receiveTimed(&control_nonce[i],SECLINK_REPLY_TIMEOUT_MS);i++){
+			}
+			if(i==SECLINK_NONCE_SIZE){
+				SecLink_deriveKeys(hmi_nonce,control_nonce);
+				g_session.established=SecLink_waitConfirm();
+			}
+		}
+	}
+	memcpy(&g_peer_counter,control_nonce,4);
+	METRIC_INC(METRIC_HANDSHAKES);
+}
+
+void SecLink_setRawHandler(void(*a_ptr)(uint8 data)){
+	g_raw_ptr=a_ptr;
+}
+
+void SecLink_setIdleCallBack(void(*a_ptr)(void)){
+	g_idle_ptr=a_ptr;
+}
+
+uint8 SecLink_send(const uint8 *data,uint8 length){
+	uint8 buffer[SECLINK_MAX_PAYLOAD];
+	uint8 tag[SECLINK_TAG_SIZE];
+	uint8 i;
+
+	if(!g_session.established||length>SECLINK_MAX_PAYLOAD){
+		return ERROR;
+	}
+
+	TRACE(TRACE_LINK_SEND,length);
+	memcpy(buffer,data,length);
+	SecLink_crypt(g_session.tx_counter,SECLINK_ROLE,buffer,length);
+	SecLink_mac(g_session.tx_counter,SECLINK_ROLE,buffer,length,tag);
+	g_session.tx_counter++;
+
+	UART_sendByte(SECLINK_FRAME_START);
+	UART_sendByte(length);
+	for(i=0;i<length;i++){
+		UART_sendByte(buffer[i]);
+	}
+	for(i=0;i<SECLINK_TAG_SIZE;i++){
+		UART_sendByte(tag[i]);
+	}
+	return SUCCESS;
+}
+
+void SecLink_sendByte(uint8 data){
+	SecLink_send(&data,1);
+}
+
+uint8 SecLink_receiveByte(void){
+	uint8 data;
+	while(g_rx_position==g_rx_length){
+		if(g_restarted){
+			return 0;
+		}
+		while(g_idle_ptr!=NULL_PTR&&!UART_isByteAvailable()){
+			(*g_idle_ptr)();
+		}
+		data=UART_receiveByte();
+		if(data==SECLINK_FRAME_START){
+			if(SecLink_receiveFrame()){
+				g_rejected=0;
+			}
+			else{
+				g_rejected++;
+				if(g_rejected==SECLINK_MAX_REJECTED){
+					SecLink_connect();
+					g_restarted=TRUE;
+				}
+			}
+		}
+		else if(data==SECLINK_RESET){
+			if(SecLink_checkReset()){
+				SecLink_connect();
+				g_restarted=TRUE;
+			}
+		}
+		else if(data!=SECLINK_WAKE&&g_raw_ptr!=NULL_PTR){
+			(*g_raw_ptr)(data);
+		}
+	}
+	return g_rx_buffer[g_rx_position++];
+}
+
+boolean SecLink_isDataAvailable(void){
+	return (boolean)(g_rx_position<g_rx_length||g_restarted||UART_isByteAvailable());
+}
+
+boolean SecLink_isRestarted(void){
+	return g_restarted;
+}
+
+void SecLink_clearRestarted(void){
+	g_restarted=FALSE;
+}
+
+uint32 SecLink_getSentCount(void){
+	return g_session.tx_counter;
+}
+
+uint32 SecLink_getReceivedCount(void){
+	return g_session.rx_counter;
+}
@@ -0,0 +1,166 @@
+/*******************************
+ *  seclink.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SECLINK_H_
+#define SECLINK_H_
+
+#include "std_types.h"
+
+/*
+ * Authenticated and encrypted UART link between the two ECUs.
+ *
+ * Handshake, started by the HMI at boot:
+ *   HMI     -> CONTROL: SECLINK_HELLO, 8-byte HMI nonce
+ *   CONTROL -> HMI:     SECLINK_REPLY, 8-byte CONTROL nonce
+ * Both sides then derive an encryption key and a MAC key from the pairing
+ * key and the two nonces (Speck64/128 CBC-MAC as the derivation function).
+ * The first frame of CONTROL_ECU holds SECLINK_CONFIRM: the HMI only takes
+ * the session once it opens, so a late REPLY to an earlier HELLO cannot
+ * leave the two ECUs with different keys. Every HELLO has a new nonce, a
+ * HELLO repeating the nonce just answered is ignored.
+ *
+ * CONTROL_ECU asks for a new handshake after its reset, on a frame while it
+ * has no session and after SECLINK_MAX_REJECTED frames in a row failing the
+ * tag (the HMI starts one itself in the last case):
+ *   CONTROL -> HMI:     SECLINK_WAKE, SECLINK_WAKE_TIME_MS later
+ *                       SECLINK_RESET, 4-byte counter, tag
+ * The counter is the one of the CONTROL nonces, the tag the first bytes of
+ * the header block (counter, sender, SECLINK_RESET) encrypted with the
+ * pairing key. The HMI drops a RESET whose counter is not above the one of
+ * its session, a recorded RESET cannot force a new handshake.
+ *
+ * Every message then travels as a frame:
+ *   SECLINK_FRAME_START, length, ciphertext, tag (SECLINK_TAG_SIZE bytes)
+ * The ciphertext is Speck64/128 in counter mode, the tag a truncated
+ * CBC-MAC over a block holding the message counter, the sender and the
+ * length, followed by the ciphertext (encrypt then MAC). Each direction has
+ * its own message counter, implicit since UART delivers in order, so a
+ * replayed, reordered or reflected frame fails the tag and is dropped.
+ */
+#define SECLINK_HELLO           0xA0
+#define SECLINK_REPLY           0xA1
+#define SECLINK_RESET           0xA2   /* CONTROL_ECU asks for a new handshake */
+#define SECLINK_WAKE            0xA3   /* Sent before SECLINK_RESET for an HMI in power-down, ignored otherwise */
+#define SECLINK_FRAME_START     0xA5
+
+/* Payload of the first frame of a session, sent by CONTROL_ECU */
+#define SECLINK_CONFIRM         0xA4
+
+#define SECLINK_NONCE_SIZE      8
+#define SECLINK_TAG_SIZE        4
+#define SECLINK_MAX_PAYLOAD     16
+
+/* Frames in a row failing the tag before a new handshake */
+#define SECLINK_MAX_REJECTED    3
+
+/* Sender identifiers mixed into the keystream and the MAC */
+#define SECLINK_ROLE_HMI        'H'
+#define SECLINK_ROLE_CONTROL    'C'
+
+/* Shared by the two ECUs of one installation, change it for every installation */
+#define SECLINK_PAIRING_KEY     {0x3A,0x91,0x5C,0xE7,0x08,0xB2,0x6D,0xF4,0x1E,0x87,0xC9,0x20,0x5B,0xA6,0x73,0xDD}
+
+/*
+ * Time the HMI waits for SECLINK_REPLY, and then for the SECLINK_CONFIRM
+ * frame, before sending SECLINK_HELLO again. CONTROL_ECU answers as soon as
+ * the nonce is in: its nonce counters are reserved in the EEPROM ahead, no
+ * write comes before the REPLY. The CONFIRM follows the key derivation,
+ * which the HMI runs as well before it starts waiting. CONTROL_ECU has no
+ * receive buffer: a HELLO sent while it still loads its EEPROM is lost, so
+ * the retry period bounds how late the session starts. It is also the
+ * longest gap between two bytes of a nonce or a frame, a message cut short
+ * is dropped instead of waited for.
+ */
+#define SECLINK_REPLY_TIMEOUT_MS 40
+
+/*
+ * Longest gap between two bytes of a SECLINK_RESET, a few byte times at
+ * 9600 bps and below SECLINK_WAKE_TIME_MS. Bytes of a RESET left in the
+ * UART while the HMI waited for a key are dropped, not joined with the next.
+ */
+#define SECLINK_BYTE_TIMEOUT_MS  3
+
+/*
+ * Description:
+ * Run the handshake with CONTROL_ECU, sending SECLINK_HELLO until it answers
+ * and its SECLINK_CONFIRM frame opens with the new keys. The idle callback
+ * is called before every HELLO. Must run after UART_init.
+ */
+void SecLink_connect(void);
+
+/*
+ * Description:
+ * Set a function called with every received byte that is not part of the
+ * secure link (e.g. requests of a maintenance tool). It may read the bytes
+ * that follow with UART_receiveByte.
+ */
+void SecLink_setRawHandler(void(*a_ptr)(uint8 data));
+
+/*
+ * Description:
+ * Set a function called repeatedly while SecLink_receiveByte waits for the
+ * next message, and between the HELLOs of a handshake. Bytes inside a
+ * message are not waited for this way, their reads are bounded.
+ */
+void SecLink_setIdleCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Encrypt and send one message.
+ *
+ * Returns:
+ *  - SUCCESS, or ERROR if no session is established or length is above SECLINK_MAX_PAYLOAD.
+ */
+uint8 SecLink_send(const uint8 *data,uint8 length);
+
+/*
+ * Description:
+ * Send a one byte message.
+ */
+void SecLink_sendByte(uint8 data);
+
+/*
+ * Description:
+ * Return the next byte of the received messages, waiting for a frame if
+ * none is left. Frames failing the tag are dropped, SECLINK_MAX_REJECTED
+ * of them in a row or an authentic SECLINK_RESET start a new handshake.
+ * After a new handshake it returns 0 at once, and keeps doing so until
+ * SecLink_clearRestarted: the exchange in progress is void, the caller
+ * goes back to where it reads the step CONTROL_ECU sends.
+ */
+uint8 SecLink_receiveByte(void);
+
+/*
+ * Description:
+ * Return TRUE if a new session started inside SecLink_receiveByte since the
+ * last SecLink_clearRestarted.
+ */
+boolean SecLink_isRestarted(void);
+
+/*
+ * Description:
+ * Let SecLink_receiveByte return messages again after a new session.
+ */
+void SecLink_clearRestarted(void);
+
+/*
+ * Description:
+ * Return TRUE if SecLink_receiveByte has something to process.
+ */
+boolean SecLink_isDataAvailable(void);
+
+/*
+ * Description:
+ * Return the number of frames sent and accepted in the current session.
+ * The sent count of one ECU matches the received count of the other one
+ * once the frame has arrived, so it identifies a message on both sides.
+ */
+uint32 SecLink_getSentCount(void);
+uint32 SecLink_getReceivedCount(void);
+
+#endif /* SECLINK_H_ */
@@ -0,0 +1,80 @@
+/*******************************
+ *  speck.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "speck.h"
+#include <string.h>
+
+/*
+ * The rotation by 8 is a byte move, which costs nothing once the compiler
+ * renames the registers, and the rotation by 3 is three single-bit steps.
+ * avr-gcc would otherwise loop a 32-bit rotate one bit at a time.
+ */
+
+typedef union {
+	uint32 word;
+	uint8 bytes[4];
+} Speck_WordType;
+
+static inline uint32 Speck_rotr8(uint32 x){
+	Speck_WordType in;
+	Speck_WordType out;
+	in.word=x;
+	out.bytes[0]=in.bytes[1];
+	out.bytes[1]=in.bytes[2];
+	out.bytes[2]=in.bytes[3];
+	out.bytes[3]=in.bytes[0];
+	return out.word;
+}
+
+static inline uint32 Speck_rotl3(uint32 x){
+	return (x<<3)|(x>>29);
+}
+
+void Speck_expandKey(Speck_KeyType *Key_Ptr,const uint8 *key){
+	uint32 words[4];
+	uint32 k;
+	uint32 l[3];
+	uint8 i;
+
+	memcpy(words,key,SPECK_KEY_SIZE);
+	k=words[0];
+	l[0]=words[1];
+	l[1]=words[2];
+	l[2]=words[3];
+
+	/* The schedule is the round function applied to the key words, l kept as a ring of three */
+	for(i=0;i<SPECK_ROUNDS;i++){
+		Key_Ptr->round_keys[i]=k;
+		l[i%3]=(k+Speck_rotr8(l[i%3]))^i;
+		k=Speck_rotl3(k)^l[i%3];
+	}
+}
+
+void Speck_encrypt(const Speck_KeyType *Key_Ptr,uint8 *block){
+	uint32 x;
+	uint32 y;
+	const uint32 *round_key=Key_Ptr->round_keys;
+	uint8 i;
+
+	memcpy(&y,block,4);
+	memcpy(&x,block+4,4);
+
+	/* Three rounds per pass, so x and y stay in registers across them */
+	for(i=0;i<SPECK_ROUNDS;i+=3){
+		x=(Speck_rotr8(x)+y)^round_key[0];
+		y=Speck_rotl3(y)^x;
+		x=(Speck_rotr8(x)+y)^round_key[1];
+		y=Speck_rotl3(y)^x;
+		x=(Speck_rotr8(x)+y)^round_key[2];
+		y=Speck_rotl3(y)^x;
+		round_key+=3;
+	}
+
+	memcpy(block,&y,4);
+	memcpy(block+4,&x,4);
+}
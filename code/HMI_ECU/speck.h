@@ -0,0 +1,40 @@
+/*******************************
+ *  speck.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SPECK_H_
+#define SPECK_H_
+
+#include "std_types.h"
+
+/*
+ * Speck64/128 block cipher (NSA, "The SIMON and SPECK families of lightweight
+ * block ciphers"): 64-bit blocks, 128-bit keys, 27 rounds of 32-bit add,
+ * rotate and xor. Bytes are read little endian, as in the reference vectors.
+ */
+#define SPECK_BLOCK_SIZE    8
+#define SPECK_KEY_SIZE      16
+#define SPECK_ROUNDS        27
+
+/* Expanded key, 108 bytes */
+typedef struct {
+	uint32 round_keys[SPECK_ROUNDS];
+} Speck_KeyType;
+
+/*
+ * Description:
+ * Compute the round keys of a SPECK_KEY_SIZE byte key.
+ */
+void Speck_expandKey(Speck_KeyType *Key_Ptr,const uint8 *key);
+
+/*
+ * Description:
+ * Encrypt one SPECK_BLOCK_SIZE byte block in place.
+ */
+void Speck_encrypt(const Speck_KeyType *Key_Ptr,uint8 *block);
+
+#endif /* SPECK_H_ */
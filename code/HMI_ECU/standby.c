@@ -0,0 +1,144 @@
+/*******************************
+ *  standby.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "standby.h"
+#include "keypad.h"
+#include "lcd.h"
+#include "pwm.h"
+#include "gpio.h"
+#include "systick.h"
+#include "log.h"
+#include "metrics.h"
+#include "supervisor.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+typedef enum {
+	STANDBY_ACTIVE,
+	STANDBY_DIMMED,
+	STANDBY_BLANK
+}Standby_StateType;
+
+static Standby_StateType g_state=STANDBY_ACTIVE;
+
+/* Start of the current wait for a key */
+static uint32 g_last_activity=0;
+
+/* Last wake-up by a byte from CONTROL_ECU */
+static uint32 g_link_wake=0;
+static volatile boolean g_link_woke=FALSE;
+
+/*
+ * ISR for INT0, a start bit on RXD. The low level mode is the only INT0
+ * mode that works in power-down, the interrupt is disabled until the next
+ * sleep so it does not fire again for every low bit.
+ */
+ISR(INT0_vect){
+	GICR&=~(1<<INT0);
+	g_link_woke=TRUE;
+}
+
+/*
+ * ISR for INT2, a key pulled a keypad column down
+ */
+ISR(INT2_vect){
+	GICR&=~(1<<INT2);
+}
+
+/* Display and backlight on, the inactivity timer restarts */
+static void Standby_wake(void){
+	LCD_sendCommand(LCD_CURSOR_OFF);
+	PWM_TIMER0_start(STANDBY_BACKLIGHT_FULL);
+	g_state=STANDBY_ACTIVE;
+	g_last_activity=SysTick_getMillis();
+	LOG_DEBUG(LOG_STANDBY,STANDBY_ACTIVE);
+}
+
+/* Power-down until a key or a byte from CONTROL_ECU */
+static void Standby_powerDown(void){
+	KEYPAD_armWakeUp();
+
+	/* INT2 on a falling edge, the flag raised by the change is cleared; INT0 on low level */
+	MCUCSR&=~(1<<ISC2);
+	GIFR=(1<<INTF2);
+	MCUCR&=~((1<<ISC01)|(1<<ISC00));
+
+	/* SysTick stops in power-down, the watchdog would reset the sleeping HMI */
+	Supervisor_suspend();
+	g_link_woke=FALSE;
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	cli();
+	GICR|=(1<<INT0)|(1<<INT2);
+	sleep_enable();
+	/* The instruction after sei runs before any interrupt, the wake-up cannot be missed */
+	sei();
+	sleep_cpu();
+	sleep_disable();
+	GICR&=~((1<<INT0)|(1<<INT2));
+	Supervisor_resume();
+
+	KEYPAD_disarmWakeUp();
+}
+
+/* Keypad idle callback, called every scan without a key */
+static void Standby_service(boolean first){
+	uint32 idle;
+
+	/* Waiting for a key is no hang */
+	Supervisor_checkIn(SUPERVISOR_TASK_MAIN);
+
+	if(first){
+		if(g_state!=STANDBY_ACTIVE){
+			Standby_wake();
+		}
+		g_last_activity=SysTick_getMillis();
+		return;
+	}
+
+	idle=SysTick_elapsedSince(g_last_activity);
+	if(g_state==STANDBY_ACTIVE&&idle>=STANDBY_DIM_MS){
+		PWM_TIMER0_start(STANDBY_BACKLIGHT_DIM);
+		g_state=STANDBY_DIMMED;
+		LOG_DEBUG(LOG_STANDBY,STANDBY_DIMMED);
+	}
+	else if(g_state==STANDBY_DIMMED&&idle>=STANDBY_BLANK_MS){
+		LCD_sendCommand(LCD_DISPLAY_OFF);
+		PWM_TIMER0_stop();
+		g_state=STANDBY_BLANK;
+		LOG_DEBUG(LOG_STANDBY,STANDBY_BLANK);
+	}
+	else if(g_state==STANDBY_BLANK){
+		if(g_link_woke&&SysTick_elapsedSince(g_link_wake)<STANDBY_LINK_HOLD_MS){
+			/* Woken by the link, keep the USART running until it is quiet again */
+			set_sleep_mode(SLEEP_MODE_IDLE);
+			sleep_mode();
+		}
+		else{
+			Standby_powerDown();
+			METRIC_INC(METRIC_WAKEUPS);
+			if(g_link_woke){
+				g_link_wake=SysTick_getMillis();
+			}
+			else{
+				/* A key, it is found by the next scan while it is still held */
+				Standby_wake();
+			}
+		}
+	}
+}
+
+void Standby_init(void){
+	/* Wake-up inputs, pulled up by the keypad and RXD wiring */
+	GPIO_setupPinDirection(PORTB_ID,PIN2_ID,PIN_INPUT);
+	GPIO_setupPinDirection(PORTD_ID,PIN2_ID,PIN_INPUT);
+
+	PWM_TIMER0_start(STANDBY_BACKLIGHT_FULL);
+	g_last_activity=SysTick_getMillis();
+	KEYPAD_setIdleCallBack(&Standby_service);
+}
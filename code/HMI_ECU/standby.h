@@ -0,0 +1,46 @@
+/*******************************
+ *  standby.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef STANDBY_H_
+#define STANDBY_H_
+
+#include "std_types.h"
+
+/*
+ * Low power standby of the HMI while it waits for a key.
+ *
+ * After STANDBY_DIM_MS without a key the backlight is dimmed, after
+ * STANDBY_BLANK_MS the display and the backlight are switched off and the
+ * MCU enters power-down. It wakes on:
+ *  - a key: the four keypad columns are wired to INT2 (PB2) through
+ *    diodes, the rows are driven low while asleep.
+ *  - a byte from CONTROL_ECU: RXD (PD0) is also wired to INT0 (PD2).
+ *    The USART is stopped in power-down, the byte that wakes the HMI is
+ *    lost. The HMI then stays in idle sleep for STANDBY_LINK_HOLD_MS with
+ *    the display off, so the bytes that follow reach the USART as they
+ *    would if it was awake. CONTROL_ECU repeats SECLINK_RESET for this.
+ * A key wakes the display and is still returned by KEYPAD_getPressedKey,
+ * the row scan resumes while the key is held.
+ */
+#define STANDBY_DIM_MS            10000
+#define STANDBY_BLANK_MS          30000
+#define STANDBY_LINK_HOLD_MS      2000
+
+/* Backlight PWM duty cycles (0-255) */
+#define STANDBY_BACKLIGHT_FULL    255
+#define STANDBY_BACKLIGHT_DIM     40
+
+/*
+ * Description:
+ * Switch the backlight on and take over the keypad idle callback, which
+ * also checks SUPERVISOR_TASK_MAIN in. Must run after SysTick_init,
+ * LCD_init and Supervisor_init.
+ */
+void Standby_init(void);
+
+#endif /* STANDBY_H_ */
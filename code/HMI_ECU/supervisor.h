@@ -0,0 +1,65 @@
+/*******************************
+ *  supervisor.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef SUPERVISOR_H_
+#define SUPERVISOR_H_
+
+#include "std_types.h"
+
+/* Supervised tasks of HMI_ECU */
+typedef enum {
+	SUPERVISOR_TASK_MAIN,      /* Main loop, including the waits for a key and for CONTROL_ECU */
+	SUPERVISOR_TASK_COUNT
+}Supervisor_TaskIdType;
+
+/* Deadline of the main loop, from one check-in to the next: the debounce delays and a screen update fit easily */
+#define SUPERVISOR_MAIN_DEADLINE_MS    2000
+
+/* Period of the deadline check, the watchdog is kicked at the same rate */
+#define SUPERVISOR_PERIOD_MS           16
+
+/* Hardware watchdog timeout, the reset follows a missed deadline by this much */
+#define SUPERVISOR_WDT_TIMEOUT         WDTO_250MS
+
+/* "No task" value of the missed task field */
+#define SUPERVISOR_TASK_NONE           0xFF
+
+/*
+ * Description:
+ * Start the hardware watchdog and supervise SUPERVISOR_TASK_MAIN. If the
+ * last reset was caused by the watchdog, the task that missed its deadline
+ * before it is kept for Supervisor_dump. Must run after SysTick_init.
+ */
+void Supervisor_init(void);
+
+/*
+ * Description:
+ * Tell the supervisor that a task is alive, and update its maximum
+ * latency (time since its previous check-in). Safe from an ISR.
+ */
+void Supervisor_checkIn(Supervisor_TaskIdType task);
+
+/*
+ * Description:
+ * Stop the watchdog before power-down: SysTick stops there and could not
+ * kick it. Supervisor_resume starts it again and counts every task as
+ * checked in, the time asleep is no latency.
+ */
+void Supervisor_suspend(void);
+void Supervisor_resume(void);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_SUPERVISOR: send one frame holding the
+ * task that missed its deadline before the last watchdog reset (or
+ * SUPERVISOR_TASK_NONE), then the maximum latency in milliseconds of every
+ * task since boot (uint16 each).
+ */
+void Supervisor_dump(void);
+
+#endif /* SUPERVISOR_H_ */
@@ -7,6 +7,9 @@
  ******************************/
 
 #include "timer1.h"
+#include "trace.h"
+#include "metrics.h"
+#include "systick.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
@@ -18,9 +21,13 @@ volatile void (*callback_ptr)(void) = ((void*)0);
  * This ISR is executed when the Timer1 compare value matches the timer count.
  */
 ISR(TIMER1_COMPA_vect) {
+    uint32 start = SysTick_getMicros();
+    TRACE_ISR(TRACE_TIMER1_ENTER, 0);
     if (callback_ptr != ((void*)0)) {
         (*callback_ptr)();  /* Execute the callback function if it is set */
     }
+    TRACE_ISR(TRACE_TIMER1_EXIT, 0);
+    METRIC_MAX(METRIC_TIMER1_ISR_MAX_US, SysTick_getMicros() - start);
 }
 
 /* 
@@ -28,9 +35,13 @@ ISR(TIMER1_COMPA_vect) {
  * This ISR is executed when Timer1 overflows, meaning it reaches its maximum count value.
  */
 ISR(TIMER1_OVF_vect) {
+    uint32 start = SysTick_getMicros();
+    TRACE_ISR(TRACE_TIMER1_ENTER, 0);
     if (callback_ptr != ((void*)0)) {
         (*callback_ptr)();  /* Execute the callback function if it is set */
     }
+    TRACE_ISR(TRACE_TIMER1_EXIT, 0);
+    METRIC_MAX(METRIC_TIMER1_ISR_MAX_US, SysTick_getMicros() - start);
 }
 
 /* 
@@ -75,7 +86,7 @@ void Timer1_deInit(void) {
     TCCR1A = 0;      /* Reset Timer1 Control Register A */
     TCCR1B = 0;      /* Reset Timer1 Control Register B */
     OCR1A = 0;       /* Reset Output Compare Register A */
-    TIMSK = 0;       /* Disable all Timer1 interrupts */
+    TIMSK &= ~((1 << OCIE1A) | (1 << TOIE1)); /* Disable Timer1 interrupts, Timer2 keeps SysTick */
 }
 
 /* 
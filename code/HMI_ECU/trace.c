@@ -0,0 +1,102 @@
+/*******************************
+ *  trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#include "systick.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <string.h>
+
+typedef struct {
+	uint16 millis;
+	uint8 ticks;
+	uint8 id;
+	uint16 arg;
+} Trace_RecordType;
+
+static Trace_RecordType g_ring[TRACE_RECORDS];
+static uint8 g_head=0;          /* Oldest record */
+static uint8 g_count=0;
+static uint16 g_dropped=0;
+
+/* SysTick milliseconds and Timer2 count, interrupts must be off */
+static uint32 Trace_now(uint8 *ticks){
+	uint32 millis=SysTick_getMillis();
+	*ticks=TCNT2;
+	/* The counter restarted but the SysTick ISR has not run yet */
+	if((TIFR&(1<<OCF2))&&*ticks<OCR2/2){
+		millis++;
+	}
+	return millis;
+}
+
+void Trace_record(uint8 id,uint16 arg){
+	Trace_RecordType *record;
+	uint8 index;
+	uint8 sreg=SREG;
+
+	cli();
+	if(g_count==TRACE_RECORDS){
+		if(g_dropped!=0xFFFF){
+			g_dropped++;
+		}
+		SREG=sreg;
+		return;
+	}
+	index=g_head+g_count;
+	if(index>=TRACE_RECORDS){
+		index-=TRACE_RECORDS;
+	}
+	g_count++;
+	record=&g_ring[index];
+	record->millis=(uint16)Trace_now(&record->ticks);
+	record->id=id;
+	record->arg=arg;
+	SREG=sreg;
+}
+
+void Trace_dump(void){
+	uint8 frame[TRACE_FRAME_RECORDS*sizeof(Trace_RecordType)];
+	uint32 millis;
+	uint8 count;
+	uint8 n;
+	uint8 i;
+	uint8 sreg=SREG;
+
+	cli();
+	millis=Trace_now(&frame[4]);
+	count=g_count;
+	memcpy(&frame[6],&g_dropped,2);
+	g_dropped=0;
+	SREG=sreg;
+	memcpy(frame,&millis,4);
+	frame[5]=count;
+	LINK_sendFrame(LINK_DIAG_TRACE,frame,8);
+
+	/* Records taken one by one, the ISRs may add more meanwhile, they go to the next dump */
+	while(count!=0){
+		n=(count<TRACE_FRAME_RECORDS)?count:TRACE_FRAME_RECORDS;
+		for(i=0;i<n;i++){
+			sreg=SREG;
+			cli();
+			memcpy(&frame[i*sizeof(Trace_RecordType)],&g_ring[g_head],sizeof(Trace_RecordType));
+			g_head=(g_head+1==TRACE_RECORDS)?0:g_head+1;
+			g_count--;
+			SREG=sreg;
+		}
+		LINK_sendFrame(LINK_DIAG_TRACE,frame,n*sizeof(Trace_RecordType));
+		count-=n;
+	}
+	LINK_sendFrame(LINK_DIAG_TRACE,frame,0);
+}
+
+#endif /* TRACE_ENABLED */
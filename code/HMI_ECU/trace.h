@@ -0,0 +1,76 @@
+/*******************************
+ *  trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+#include "trace_ids.h"
+
+/*
+ * Binary event trace, for tracing builds only: build with
+ * -DTRACE_ENABLED=1, TRACE() compiles to nothing otherwise.
+ *
+ * TRACE(id, arg) stores a 6-byte record (SysTick milliseconds, Timer2
+ * count in 8 us steps, id, 16-bit arg) in a RAM ring. Once it is full new
+ * records are dropped and counted, the first events after a dump (e.g. an
+ * unlock) are kept. Safe from ISRs. The ring is read and cleared by
+ * diagnostic command LINK_DIAG_TRACE, tools/trace.py turns the dumps of
+ * both ECUs into a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * TRACE_ISR() is for the events of periodic interrupts (Timer1), which
+ * would fill the ring within a door cycle: they are only recorded when
+ * -DTRACE_ISR_ENABLED=1 is added as well.
+ */
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED           0
+#endif
+
+#ifndef TRACE_ISR_ENABLED
+#define TRACE_ISR_ENABLED       0
+#endif
+
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS           32
+#endif
+
+/* Records sent in one diagnostic frame */
+#define TRACE_FRAME_RECORDS     8
+
+#if TRACE_ENABLED
+#define TRACE(ID,ARG)           Trace_record((ID),(uint16)(ARG))
+#else
+#define TRACE(ID,ARG)           ((void)0)
+#endif
+
+#if TRACE_ENABLED && TRACE_ISR_ENABLED
+#define TRACE_ISR(ID,ARG)       Trace_record((ID),(uint16)(ARG))
+#else
+#define TRACE_ISR(ID,ARG)       ((void)0)
+#endif
+
+/*
+ * Description:
+ * Store one record, or count it as dropped if the ring is full. Use TRACE()
+ * or TRACE_ISR() so that it disappears from normal builds.
+ */
+void Trace_record(uint8 id,uint16 arg);
+
+/*
+ * Description:
+ * Diagnostic handler for LINK_DIAG_TRACE: send the ring, oldest record
+ * first, and clear it. Frames:
+ *  - header: current SysTick milliseconds (uint32) and Timer2 count
+ *    (uint8), records in the ring (uint8), records dropped (uint16)
+ *  - records: up to TRACE_FRAME_RECORDS of milliseconds (low 16 bits),
+ *    Timer2 count, id, arg (uint16)
+ *  - end: no data
+ */
+void Trace_dump(void);
+
+#endif /* TRACE_H_ */
@@ -9,6 +9,7 @@
 #include "uart.h"
 #include <avr/io.h>
 #include "common_macros.h"
+#include "metrics.h"
 
 /* 
  * Description:
@@ -40,4 +41,111 @@ void UART_init(const UART_ConfigType* Config_Ptr) {
      * UCSRC: Control and status register C
      * - URSEL = 1: Write to UCSRC (instead of UBRRH)
      * - UMSEL = 0: Asynchronous operation
-     * - U
+     * - UPM1:0: Parity mode
+     * - USBS: Number of stop bits
+     * - UCSZ1:0: Character size
+     * - UCPOL = 0: Used with synchronous operation only
+     */
+    /* URSEL bit must be one when writing the register */
+    UCSRC = (1 << URSEL);
+
+    /* Adjust UCSZ1 & UCSZ0 based on the bit data mode */
+    UCSRC = (UCSRC & 0x79) | (Config_Ptr->bit_data & 0x03);
+
+    /* Adjust USBS based on the stop bit setting */
+    UCSRC = (UCSRC & 0xF7) | ((Config_Ptr->stop_bit << 3) & 0x08);
+
+    /* Adjust UPM1:0 based on the parity setting */
+    UCSRC = (UCSRC & 0xCF) | ((Config_Ptr->parity << 4) & 0x30);
+
+    /* Calculate the UBRR register value */
+    ubrr_value = (uint16)(((F_CPU / (Config_Ptr->baud_rate * 8UL))) - 1);
+
+    /* Set the baud rate */
+    UBRRH = (uint8)(ubrr_value >> 8);
+    UBRRL = (uint8)ubrr_value;
+}
+
+/* 
+ * Description:
+ * Sends a byte of data through the UART.
+ * 
+ * Parameters:
+ * - data: The byte of data to be sent.
+ */
+void UART_sendByte(const uint8 data) {
+    /* Wait until the transmit buffer is empty (UDRE flag set) */
+    while (BIT_IS_CLEAR(UCSRA, UDRE));
+
+    /* Put the data into the buffer, which sends it */
+    UDR = data;
+}
+
+/* 
+ * Description:
+ * Receives a byte of data through the UART.
+ * 
+ * Returns:
+ * - The received byte of data.
+ */
+uint8 UART_receiveByte(void) {
+    /* Wait until a byte is received (RXC flag set) */
+    while (BIT_IS_CLEAR(UCSRA, RXC));
+
+    /* The error flags belong to the byte in UDR, read them first */
+    if (UCSRA & ((1 << FE) | (1 << DOR) | (1 << PE))) {
+        METRIC_INC(METRIC_UART_ERRORS);
+    }
+
+    /* Read the received byte from the buffer */
+    return UDR;
+}
+
+/* 
+ * Description:
+ * Checks whether a received byte is waiting, without blocking.
+ * 
+ * Returns:
+ * - TRUE if a received byte is waiting in the buffer.
+ */
+boolean UART_isByteAvailable(void) {
+    return BIT_IS_SET(UCSRA, RXC) ? TRUE : FALSE;
+}
+
+/* 
+ * Description:
+ * Sends a string of data through the UART.
+ * 
+ * Parameters:
+ * - Str: Pointer to the string to be sent.
+ */
+void UART_sendString(const uint8 *Str) {
+    uint8 i = 0;
+
+    /* Send each character until the null terminator */
+    while (Str[i] != '\0') {
+        UART_sendByte(Str[i]);
+        i++;
+    }
+}
+
+/* 
+ * Description:
+ * Receives a string of data through the UART until the '#' character is encountered.
+ * 
+ * Parameters:
+ * - Str: Pointer to the buffer where the received string will be stored.
+ */
+void UART_receiveString(uint8 *Str) {
+    uint8 i = 0;
+
+    /* Receive characters until the '#' character */
+    Str[i] = UART_receiveByte();
+    while (Str[i] != '#') {
+        i++;
+        Str[i] = UART_receiveByte();
+    }
+
+    /* Replace the '#' character with a null terminator */
+    Str[i] = '\0';
+}
@@ -77,6 +77,15 @@ void UART_sendByte(const uint8 data);
  */
 uint8 UART_receiveByte(void);
 
+/* 
+ * Description:
+ * Checks whether a received byte is waiting, without blocking.
+ * 
+ * Returns:
+ * - TRUE if UART_receiveByte would return at once.
+ */
+boolean UART_isByteAvailable(void);
+
 /* 
  * Description:
  * Sends a string of data through the UART.
@@ -0,0 +1,187 @@
+/*******************************
+ *  bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Benchmark harness: main() of an atmega32 image holding one driver routine,
+ * built by tools/cycle_bench.py with the sources of the routine's ECU and
+ * run under simavr by bench_sim.c. BENCH_ROUTINE selects the routine. Only
+ * the drivers it needs are initialised, with the settings of the ECU. The
+ * arguments are ready before BENCH_START, so a measurement is the call
+ * itself plus the interrupts the drivers take meanwhile, as on the target.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "std_types.h"
+#include "bench.h"
+
+#if (BENCH_ROUTINE == BENCH_GPIO_WRITE_PIN)
+#include "gpio.h"
+#elif (BENCH_ROUTINE == BENCH_LCD_DISPLAY_CHARACTER)
+#include "lcd.h"
+#include "systick.h"
+#elif (BENCH_ROUTINE == BENCH_KEYPAD_SCAN)
+#include "keypad.h"
+#elif (BENCH_ROUTINE == BENCH_EEPROM_READ_BYTE)
+#include "external_eeprom.h"
+#include "systick.h"
+#include "twi.h"
+#elif (BENCH_ROUTINE == BENCH_UART_SEND_BYTE) || (BENCH_ROUTINE == BENCH_UART_RECEIVE_BYTE)
+#include "uart.h"
+#elif (BENCH_ROUTINE == BENCH_PASSWORD_COMPARE)
+#include "credential_cache.h"
+#include "kv_store.h"
+#include "systick.h"
+#include "twi.h"
+#endif
+
+#define BENCH_MARKER        (*(volatile uint8*)BENCH_MARKER_ADDRESS)
+#define BENCH_START()       (BENCH_MARKER=BENCH_MARK_START)
+#define BENCH_END()         (BENCH_MARKER=BENCH_MARK_END)
+#define BENCH_FAIL()        (BENCH_MARKER=BENCH_MARK_FAILED)
+
+#if (BENCH_ROUTINE == BENCH_KEYPAD_SCAN)
+static uint8 g_scans=0;
+
+/*
+ * Idle callback, called after every scan that found no key: one measurement
+ * from a callback to the next is one scan of the whole keypad. Once
+ * BENCH_RUNS scans are in, the key is pressed and KEYPAD_getPressedKey returns.
+ */
+static void Bench_onScan(boolean first){
+	if(!first){
+		BENCH_END();
+		g_scans++;
+	}
+	if(g_scans==BENCH_RUNS){
+		BENCH_MARKER=BENCH_MARK_PRESS_KEY;
+	}
+	else{
+		BENCH_START();
+	}
+}
+#endif
+
+int main(void){
+	uint8 i;
+#if (BENCH_ROUTINE == BENCH_GPIO_WRITE_PIN)
+	uint8 value;
+#elif (BENCH_ROUTINE == BENCH_LCD_DISPLAY_CHARACTER)
+	uint8 character;
+#elif (BENCH_ROUTINE == BENCH_EEPROM_READ_BYTE)
+	TWI_ConfigType twi={10,400000};
+	uint16 address;
+	uint8 data;
+	uint8 result;
+#elif (BENCH_ROUTINE == BENCH_UART_SEND_BYTE) || (BENCH_ROUTINE == BENCH_UART_RECEIVE_BYTE)
+	UART_ConfigType uart={EIGHT_BIT_MODE,EVEN_PARITY,ONE_STOP_BIT,RATE_THREE};
+	uint8 data;
+#elif (BENCH_ROUTINE == BENCH_PASSWORD_COMPARE)
+	TWI_ConfigType twi={10,400000};
+	uint8 password[CRED_PASSWORD_LENGTH]={1,2,3,4,5};
+	uint8 attempt[CRED_PASSWORD_LENGTH]={1,2,3,4,5};
+	boolean result;
+#endif
+
+#if (BENCH_ROUTINE == BENCH_GPIO_WRITE_PIN)
+	/* The LCD enable pin, the most toggled one: last port and pin, the longest path */
+	GPIO_setupPinDirection(PORTD_ID,PIN7_ID,PIN_OUTPUT);
+#elif (BENCH_ROUTINE == BENCH_LCD_DISPLAY_CHARACTER)
+	SysTick_init();
+	sei();
+	LCD_init();
+#elif (BENCH_ROUTINE == BENCH_KEYPAD_SCAN)
+	KEYPAD_setIdleCallBack(&Bench_onScan);
+#elif (BENCH_ROUTINE == BENCH_EEPROM_READ_BYTE)
+	SysTick_init();
+	TWI_init(&twi);
+	sei();
+#elif (BENCH_ROUTINE == BENCH_UART_SEND_BYTE) || (BENCH_ROUTINE == BENCH_UART_RECEIVE_BYTE)
+	/* The simulator loops TXD back to RXD */
+	UART_init(&uart);
+#elif (BENCH_ROUTINE == BENCH_PASSWORD_COMPARE)
+	SysTick_init();
+	TWI_init(&twi);
+	sei();
+	/* The EEPROM starts erased, CredCache_init finds no password and fails */
+	if(KV_init()==ERROR){
+		BENCH_FAIL();
+	}
+	(void)CredCache_init();
+	if(CredCache_setPassword(password)==ERROR){
+		BENCH_FAIL();
+	}
+#endif
+
+#if (BENCH_ROUTINE == BENCH_KEYPAD_SCAN)
+	(void)i;
+	/* The key at the first row and column of the 4x4 keypad */
+	if(KEYPAD_getPressedKey()!=7){
+		BENCH_FAIL();
+	}
+#else
+	for(i=0;i<BENCH_RUNS;i++){
+#if (BENCH_ROUTINE == BENCH_NONE)
+		BENCH_START();
+		BENCH_END();
+#elif (BENCH_ROUTINE == BENCH_GPIO_WRITE_PIN)
+		value=(i&1)?LOGIC_HIGH:LOGIC_LOW;
+		BENCH_START();
+		GPIO_writePin(PORTD_ID,PIN7_ID,value);
+		BENCH_END();
+#elif (BENCH_ROUTINE == BENCH_LCD_DISPLAY_CHARACTER)
+		character='A'+i;
+		BENCH_START();
+		LCD_displayCharacter(character);
+		BENCH_END();
+#elif (BENCH_ROUTINE == BENCH_EEPROM_READ_BYTE)
+		/* A different block every time, the block bits travel in the device address */
+		address=(uint16)i*257;
+		BENCH_START();
+		result=EEPROM_readByte(address,&data);
+		BENCH_END();
+		if(result==ERROR){
+			BENCH_FAIL();
+		}
+#elif (BENCH_ROUTINE == BENCH_UART_SEND_BYTE)
+		data=i;
+		BENCH_START();
+		UART_sendByte(data);
+		BENCH_END();
+		/* Wait for the byte to come back, the transmitter is idle again */
+		(void)UART_receiveByte();
+#elif (BENCH_ROUTINE == BENCH_UART_RECEIVE_BYTE)
+		UART_sendByte(i);
+		/* The byte is in UDR: the read path, not the line time */
+		while(!UART_isByteAvailable());
+		BENCH_START();
+		data=UART_receiveByte();
+		BENCH_END();
+		if(data!=i){
+			BENCH_FAIL();
+		}
+#elif (BENCH_ROUTINE == BENCH_PASSWORD_COMPARE)
+		/* Right and wrong passwords in turn, the compare must not tell them apart */
+		attempt[CRED_PASSWORD_LENGTH-1]=(i&1)?9:5;
+		BENCH_START();
+		result=CredCache_verify(attempt);
+		BENCH_END();
+		if(result!=((i&1)?FALSE:TRUE)){
+			BENCH_FAIL();
+		}
+#endif
+	}
+#endif
+
+	/* Sleeping with the interrupts off ends the simulation */
+	cli();
+	sleep_cpu();
+	while(1){
+	}
+}
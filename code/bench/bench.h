@@ -0,0 +1,41 @@
+/*******************************
+ *  bench.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Shared by the benchmark harness (bench.c, built for the atmega32) and the
+ * simulator running it (bench_sim.c, built against simavr). The harness
+ * writes the marker register around every call of the routine under test:
+ * BENCH_MARK_START before, BENCH_MARK_END after. Consecutive markers always
+ * differ, simavr only reports a register write that changes the value.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/* EEDR in data space: only eeprom_write_* writes it, no benchmarked path does */
+#define BENCH_MARKER_ADDRESS    0x3D
+
+#define BENCH_MARK_END          0
+#define BENCH_MARK_START        1
+#define BENCH_MARK_PRESS_KEY    2   /* Press the keypad key at the first row and column */
+#define BENCH_MARK_FAILED       3   /* The routine returned an error, the numbers are void */
+
+/* Calls measured per routine */
+#define BENCH_RUNS              8
+
+/* Routines, the harness is built with -DBENCH_ROUTINE=one of them */
+#define BENCH_NONE                      0   /* Empty call, the marker overhead */
+#define BENCH_GPIO_WRITE_PIN            1
+#define BENCH_LCD_DISPLAY_CHARACTER     2
+#define BENCH_KEYPAD_SCAN               3
+#define BENCH_EEPROM_READ_BYTE          4
+#define BENCH_UART_SEND_BYTE            5
+#define BENCH_UART_RECEIVE_BYTE         6
+#define BENCH_PASSWORD_COMPARE          7
+
+#endif /* BENCH_H_ */
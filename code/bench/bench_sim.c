@@ -0,0 +1,263 @@
+/*******************************
+ *  bench_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Runs one benchmark harness (bench.c) on a simulated atmega32, a host
+ * program built against simavr by tools/cycle_bench.py:
+ *
+ *     bench_sim harness.elf
+ *
+ * prints "cycles_min cycles_max stack runs" for the calls framed by the
+ * harness markers. The cycles of a call are counted from the write of
+ * BENCH_MARK_START to the write of BENCH_MARK_END, its stack is how far the
+ * stack pointer went below its value at BENCH_MARK_START, sampled after
+ * every instruction. The parts the drivers talk to are simulated as well:
+ * a 24C16 on the TWI bus, TXD looped back to RXD and the keypad key at the
+ * first row and column, pressed on BENCH_MARK_PRESS_KEY.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "avr_ioport.h"
+#include "avr_uart.h"
+#include "avr_twi.h"
+#include "bench.h"
+#include "gpio.h"
+#include "keypad.h"
+
+#define BENCH_MCU               "atmega32"
+#define BENCH_FREQUENCY         8000000UL
+
+/* A harness still running after 10 s of simulated time is stuck */
+#define BENCH_CYCLE_LIMIT       (10ULL*BENCH_FREQUENCY)
+
+/* 24C16: 2 KB in 8 blocks of 256 bytes, the block bits are in the device address */
+#define EEPROM_SIZE             2048
+#define EEPROM_PAGE_SIZE        16
+#define EEPROM_SLA              0xA0    /* Address byte on the bus, 0x50 shifted */
+#define EEPROM_SLA_MASK         0x0F    /* Block bits and R/W */
+
+typedef struct{
+	uint8_t measuring;
+	avr_cycle_count_t start_cycle;
+	uint16_t start_sp;
+	uint16_t lowest_sp;
+	uint32_t runs;
+	avr_cycle_count_t min_cycles;
+	avr_cycle_count_t max_cycles;
+	uint16_t max_stack;
+	uint8_t failed;
+	uint8_t key_requested;
+}Bench_StateType;
+
+typedef struct{
+	avr_irq_t *irq;             /* TWI_IRQ_INPUT and TWI_IRQ_OUTPUT, wired to the TWI module */
+	uint8_t selected;           /* Address byte of the transaction, 0 if it is not for the EEPROM */
+	uint8_t word_address_next;  /* The next byte written is the word address */
+	uint16_t pointer;           /* Internal address counter */
+	uint8_t memory[EEPROM_SIZE];
+}Bench_EepromType;
+
+static Bench_StateType g_bench;
+static Bench_EepromType g_eeprom;
+static avr_irq_t *g_key_column_irq;
+static uint8_t g_key_level=KEYPAD_BUTTON_RELEASED;
+
+static uint16_t Bench_getSp(avr_t *avr){
+	return avr->data[R_SPL]|((uint16_t)avr->data[R_SPH]<<8);
+}
+
+static void Bench_onMarker(struct avr_irq_t *irq,uint32_t value,void *param){
+	avr_t *avr=(avr_t*)param;
+	avr_cycle_count_t cycles;
+	uint16_t stack;
+
+	(void)irq;
+	switch(value){
+	case BENCH_MARK_START:
+		g_bench.measuring=1;
+		g_bench.start_cycle=avr->cycle;
+		g_bench.start_sp=Bench_getSp(avr);
+		g_bench.lowest_sp=g_bench.start_sp;
+		break;
+	case BENCH_MARK_END:
+		if(!g_bench.measuring){
+			break;
+		}
+		g_bench.measuring=0;
+		cycles=avr->cycle-g_bench.start_cycle;
+		stack=g_bench.start_sp-g_bench.lowest_sp;
+		if(g_bench.runs==0||cycles<g_bench.min_cycles){
+			g_bench.min_cycles=cycles;
+		}
+		if(cycles>g_bench.max_cycles){
+			g_bench.max_cycles=cycles;
+		}
+		if(stack>g_bench.max_stack){
+			g_bench.max_stack=stack;
+		}
+		g_bench.runs++;
+		break;
+	case BENCH_MARK_PRESS_KEY:
+		g_bench.key_requested=1;
+		break;
+	default:
+		g_bench.failed=1;
+		break;
+	}
+}
+
+/*
+ * The 24C16 side of the bus, the messages of simavr's TWI module: ACK its
+ * address and every byte written, the first byte after SLA+W sets the
+ * address counter, reads wrap at the end of the memory, writes within the
+ * page. The write cycle takes no time, ACK polling succeeds at once.
+ */
+static void Bench_onTwi(struct avr_irq_t *irq,uint32_t value,void *param){
+	Bench_EepromType *eeprom=(Bench_EepromType*)param;
+	avr_twi_msg_irq_t message;
+
+	(void)irq;
+	message.u.v=value;
+	if(message.u.twi.msg&TWI_COND_STOP){
+		eeprom->selected=0;
+	}
+	if(message.u.twi.msg&TWI_COND_START){
+		eeprom->selected=0;
+		if((message.u.twi.addr&~EEPROM_SLA_MASK)==EEPROM_SLA){
+			eeprom->selected=message.u.twi.addr;
+			eeprom->word_address_next=!(message.u.twi.addr&1);
+			avr_raise_irq(eeprom->irq+TWI_IRQ_INPUT,avr_twi_irq_msg(TWI_COND_ACK,eeprom->selected,1));
+		}
+	}
+	if(!eeprom->selected){
+		return;
+	}
+	if(message.u.twi.msg&TWI_COND_WRITE){
+		avr_raise_irq(eeprom->irq+TWI_IRQ_INPUT,avr_twi_irq_msg(TWI_COND_ACK,eeprom->selected,1));
+		if(eeprom->word_address_next){
+			eeprom->pointer=(uint16_t)(((eeprom->selected>>1)&0x07)<<8)|message.u.twi.data;
+			eeprom->word_address_next=0;
+		}
+		else{
+			eeprom->memory[eeprom->pointer]=message.u.twi.data;
+			eeprom->pointer=(eeprom->pointer&~(EEPROM_PAGE_SIZE-1))|((eeprom->pointer+1)&(EEPROM_PAGE_SIZE-1));
+		}
+	}
+	if(message.u.twi.msg&TWI_COND_READ){
+		avr_raise_irq(eeprom->irq+TWI_IRQ_INPUT,
+				avr_twi_irq_msg(TWI_COND_READ,eeprom->selected,eeprom->memory[eeprom->pointer]));
+		eeprom->pointer=(eeprom->pointer+1)&(EEPROM_SIZE-1);
+	}
+}
+
+static void Bench_attachEeprom(avr_t *avr){
+	memset(g_eeprom.memory,0xFF,sizeof(g_eeprom.memory));
+	g_eeprom.irq=avr_alloc_irq(&avr->irq_pool,0,2,NULL);
+	avr_irq_register_notify(g_eeprom.irq+TWI_IRQ_OUTPUT,&Bench_onTwi,&g_eeprom);
+	avr_connect_irq(g_eeprom.irq+TWI_IRQ_INPUT,avr_io_getirq(avr,AVR_IOCTL_TWI_GETIRQ(0),TWI_IRQ_INPUT));
+	avr_connect_irq(avr_io_getirq(avr,AVR_IOCTL_TWI_GETIRQ(0),TWI_IRQ_OUTPUT),g_eeprom.irq+TWI_IRQ_OUTPUT);
+}
+
+/* TXD looped back to RXD, nothing echoed on the console */
+static void Bench_attachUart(avr_t *avr){
+	uint32_t flags=0;
+
+	avr_ioctl(avr,AVR_IOCTL_UART_GET_FLAGS('0'),&flags);
+	flags&=~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr,AVR_IOCTL_UART_SET_FLAGS('0'),&flags);
+	avr_connect_irq(avr_io_getirq(avr,AVR_IOCTL_UART_GETIRQ('0'),UART_IRQ_OUTPUT),
+			avr_io_getirq(avr,AVR_IOCTL_UART_GETIRQ('0'),UART_IRQ_INPUT));
+}
+
+/* Every column reads released, as through the pull-ups of the keypad */
+static void Bench_attachKeypad(avr_t *avr){
+	uint8_t col;
+
+	for(col=0;col<KEYPAD_NUM_COLS;col++){
+		avr_raise_irq(avr_io_getirq(avr,AVR_IOCTL_IOPORT_GETIRQ('A'+KEYPAD_COL_PORT_ID),
+				KEYPAD_FIRST_COL_PIN_ID+col),KEYPAD_BUTTON_RELEASED);
+	}
+	g_key_column_irq=avr_io_getirq(avr,AVR_IOCTL_IOPORT_GETIRQ('A'+KEYPAD_COL_PORT_ID),KEYPAD_FIRST_COL_PIN_ID);
+}
+
+/* The pressed key joins the first row to the first column: the column follows the row while it is driven */
+static void Bench_serveKeypad(avr_t *avr){
+	avr_ioport_state_t row;
+	uint8_t level=KEYPAD_BUTTON_RELEASED;
+
+	avr_ioctl(avr,AVR_IOCTL_IOPORT_GETSTATE('A'+KEYPAD_ROW_PORT_ID),&row);
+	if(row.ddr&(1<<KEYPAD_FIRST_ROW_PIN_ID)){
+		level=(row.port>>KEYPAD_FIRST_ROW_PIN_ID)&1;
+	}
+	if(level!=g_key_level){
+		g_key_level=level;
+		avr_raise_irq(g_key_column_irq,level);
+	}
+}
+
+int main(int argc,char *argv[]){
+	elf_firmware_t firmware;
+	avr_t *avr;
+	int state=cpu_Running;
+	uint16_t sp;
+
+	if(argc!=2){
+		fprintf(stderr,"usage: %s harness.elf\n",argv[0]);
+		return 2;
+	}
+	memset(&firmware,0,sizeof(firmware));
+	if(elf_read_firmware(argv[1],&firmware)!=0){
+		fprintf(stderr,"%s: cannot read\n",argv[1]);
+		return 2;
+	}
+	strcpy(firmware.mmcu,BENCH_MCU);
+	firmware.frequency=BENCH_FREQUENCY;
+	avr=avr_make_mcu_by_name(firmware.mmcu);
+	if(avr==NULL){
+		fprintf(stderr,"simavr has no %s\n",BENCH_MCU);
+		return 2;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr,&firmware);
+
+	avr_irq_register_notify(avr_iomem_getirq(avr,BENCH_MARKER_ADDRESS,NULL,AVR_IOMEM_IRQ_ALL),&Bench_onMarker,avr);
+	Bench_attachEeprom(avr);
+	Bench_attachUart(avr);
+	Bench_attachKeypad(avr);
+
+	while(state!=cpu_Done&&state!=cpu_Crashed&&avr->cycle<BENCH_CYCLE_LIMIT){
+		state=avr_run(avr);
+		if(g_bench.measuring){
+			sp=Bench_getSp(avr);
+			if(sp<g_bench.lowest_sp){
+				g_bench.lowest_sp=sp;
+			}
+		}
+		if(g_bench.key_requested){
+			Bench_serveKeypad(avr);
+		}
+	}
+
+	if(state!=cpu_Done){
+		fprintf(stderr,"%s: %s\n",argv[1],(state==cpu_Crashed)?"crashed":"still running at the cycle limit");
+		return 1;
+	}
+	if(g_bench.failed||g_bench.runs==0){
+		fprintf(stderr,"%s: the routine failed\n",argv[1]);
+		return 1;
+	}
+	printf("%llu %llu %u %lu\n",(unsigned long long)g_bench.min_cycles,(unsigned long long)g_bench.max_cycles,
+			g_bench.max_stack,(unsigned long)g_bench.runs);
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*******************************
+ *  avr/eeprom.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * The internal EEPROM of the host build is the HOST_EEPROM file. EEMEM
+ * variables are placed in their own section, their offset in it is their
+ * EEPROM address.
+ */
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define EEMEM  __attribute__((section("host_eeprom")))
+
+uint8_t eeprom_read_byte(const uint8_t *address);
+uint16_t eeprom_read_word(const uint16_t *address);
+uint32_t eeprom_read_dword(const uint32_t *address);
+void eeprom_read_block(void *destination, const void *source, size_t length);
+void eeprom_write_byte(uint8_t *address, uint8_t value);
+void eeprom_write_word(uint16_t *address, uint16_t value);
+void eeprom_write_dword(uint32_t *address, uint32_t value);
+void eeprom_write_block(const void *source, void *destination, size_t length);
+
+#define eeprom_update_byte   eeprom_write_byte
+#define eeprom_update_word   eeprom_write_word
+#define eeprom_update_dword  eeprom_write_dword
+#define eeprom_update_block  eeprom_write_block
+
+#endif /* HOST_AVR_EEPROM_H_ */
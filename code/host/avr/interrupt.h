@@ -0,0 +1,25 @@
+/*******************************
+ *  avr/interrupt.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * An ISR is a plain function on the host. The ones the host drivers need
+ * are called from the tick signal (host.c) while the I bit of SREG is set.
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)  void vector(void); void vector(void)
+#define ISR_NAKED
+
+#define sei()  (SREG|=(1<<7))
+#define cli()  (SREG&=(uint8_t)~(1<<7))
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,202 @@
+/*******************************
+ *  avr/io.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * ATmega32 registers for the Linux build. Every register is a byte of
+ * Host_io at its data space address, so the drivers that are not replaced
+ * in code/host (gpio.c, pwm.c, standby.c, ...) compile and run unchanged.
+ * Only SREG has a meaning: its I bit gates the host interrupts (host.h).
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t Host_io[0x60];
+
+#define _SFR_IO8(io_addr)   (Host_io[(io_addr)+0x20])
+#define _SFR_IO16(io_addr)  (*(volatile uint16_t*)&Host_io[(io_addr)+0x20])
+#define _BV(bit)            (1<<(bit))
+
+#define TWBR    _SFR_IO8(0x00)
+#define TWSR    _SFR_IO8(0x01)
+#define TWAR    _SFR_IO8(0x02)
+#define TWDR    _SFR_IO8(0x03)
+#define ADCL    _SFR_IO8(0x04)
+#define ADCH    _SFR_IO8(0x05)
+#define ADCSRA  _SFR_IO8(0x06)
+#define ADMUX   _SFR_IO8(0x07)
+#define ACSR    _SFR_IO8(0x08)
+#define UBRRL   _SFR_IO8(0x09)
+#define UCSRB   _SFR_IO8(0x0A)
+#define UCSRA   _SFR_IO8(0x0B)
+#define UDR     _SFR_IO8(0x0C)
+#define SPCR    _SFR_IO8(0x0D)
+#define SPSR    _SFR_IO8(0x0E)
+#define SPDR    _SFR_IO8(0x0F)
+#define PIND    _SFR_IO8(0x10)
+#define DDRD    _SFR_IO8(0x11)
+#define PORTD   _SFR_IO8(0x12)
+#define PINC    _SFR_IO8(0x13)
+#define DDRC    _SFR_IO8(0x14)
+#define PORTC   _SFR_IO8(0x15)
+#define PINB    _SFR_IO8(0x16)
+#define DDRB    _SFR_IO8(0x17)
+#define PORTB   _SFR_IO8(0x18)
+#define PINA    _SFR_IO8(0x19)
+#define DDRA    _SFR_IO8(0x1A)
+#define PORTA   _SFR_IO8(0x1B)
+#define EECR    _SFR_IO8(0x1C)
+#define EEDR    _SFR_IO8(0x1D)
+#define EEARL   _SFR_IO8(0x1E)
+#define EEARH   _SFR_IO8(0x1F)
+#define UBRRH   _SFR_IO8(0x20)
+#define UCSRC   _SFR_IO8(0x20)
+#define WDTCR   _SFR_IO8(0x21)
+#define ASSR    _SFR_IO8(0x22)
+#define OCR2    _SFR_IO8(0x23)
+#define TCNT2   _SFR_IO8(0x24)
+#define TCCR2   _SFR_IO8(0x25)
+#define ICR1    _SFR_IO16(0x26)
+#define OCR1B   _SFR_IO16(0x28)
+#define OCR1A   _SFR_IO16(0x2A)
+#define TCNT1   _SFR_IO16(0x2C)
+#define TCCR1B  _SFR_IO8(0x2E)
+#define TCCR1A  _SFR_IO8(0x2F)
+#define SFIOR   _SFR_IO8(0x30)
+#define OSCCAL  _SFR_IO8(0x31)
+#define TCNT0   _SFR_IO8(0x32)
+#define TCCR0   _SFR_IO8(0x33)
+#define MCUCSR  _SFR_IO8(0x34)
+#define MCUCR   _SFR_IO8(0x35)
+#define TWCR    _SFR_IO8(0x36)
+#define SPMCR   _SFR_IO8(0x37)
+#define TIFR    _SFR_IO8(0x38)
+#define TIMSK   _SFR_IO8(0x39)
+#define GIFR    _SFR_IO8(0x3A)
+#define GICR    _SFR_IO8(0x3B)
+#define OCR0    _SFR_IO8(0x3C)
+#define SP      _SFR_IO16(0x3D)
+#define SPL     _SFR_IO8(0x3D)
+#define SPH     _SFR_IO8(0x3E)
+#define SREG    _SFR_IO8(0x3F)
+
+/* TWCR */
+#define TWINT   7
+#define TWEA    6
+#define TWSTA   5
+#define TWSTO   4
+#define TWWC    3
+#define TWEN    2
+#define TWIE    0
+
+/* UCSRA, UCSRB, UCSRC */
+#define RXC     7
+#define TXC     6
+#define UDRE    5
+#define FE      4
+#define DOR     3
+#define PE      2
+#define U2X     1
+#define RXCIE   7
+#define TXCIE   6
+#define UDRIE   5
+#define RXEN    4
+#define TXEN    3
+#define UCSZ2   2
+#define URSEL   7
+#define UMSEL   6
+#define UPM1    5
+#define UPM0    4
+#define USBS    3
+#define UCSZ1   2
+#define UCSZ0   1
+
+/* TCCR0, TCCR1A, TCCR1B, TCCR2, ASSR */
+#define FOC0    7
+#define WGM00   6
+#define COM01   5
+#define COM00   4
+#define WGM01   3
+#define CS02    2
+#define CS01    1
+#define CS00    0
+#define COM1A1  7
+#define COM1A0  6
+#define COM1B1  5
+#define COM1B0  4
+#define FOC1A   3
+#define FOC1B   2
+#define WGM11   1
+#define WGM10   0
+#define WGM13   4
+#define WGM12   3
+#define CS12    2
+#define CS11    1
+#define CS10    0
+#define FOC2    7
+#define WGM20   6
+#define COM21   5
+#define COM20   4
+#define WGM21   3
+#define CS22    2
+#define CS21    1
+#define CS20    0
+#define AS2     3
+
+/* TIMSK, TIFR */
+#define OCIE2   7
+#define TOIE2   6
+#define TICIE1  5
+#define OCIE1A  4
+#define OCIE1B  3
+#define TOIE1   2
+#define OCIE0   1
+#define TOIE0   0
+#define OCF2    7
+#define TOV2    6
+#define ICF1    5
+#define OCF1A   4
+#define OCF1B   3
+#define TOV1    2
+#define OCF0    1
+#define TOV0    0
+
+/* GICR, GIFR, MCUCR, MCUCSR */
+#define INT1    7
+#define INT0    6
+#define INT2    5
+#define INTF1   7
+#define INTF0   6
+#define INTF2   5
+#define SE      7
+#define SM2     6
+#define SM1     5
+#define SM0     4
+#define ISC11   3
+#define ISC10   2
+#define ISC01   1
+#define ISC00   0
+#define ISC2    6
+#define JTRF    4
+#define WDRF    3
+#define BORF    2
+#define EXTRF   1
+#define PORF    0
+
+/* ACSR, WDTCR */
+#define ACD     7
+#define WDTOE   4
+#define WDE     3
+
+#define RAMSTART 0x60
+#define RAMEND   0x85F
+#define E2END    0x3FF
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,27 @@
+/*******************************
+ *  avr/pgmspace.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/* One address space on the host, flash data is plain const data */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)  (s)
+
+#define pgm_read_byte(address)   (*(const uint8_t*)(address))
+#define pgm_read_word(address)   (*(const uint16_t*)(address))
+#define pgm_read_dword(address)  (*(const uint32_t*)(address))
+#define pgm_read_ptr(address)    (*(void *const*)(address))
+
+#define memcpy_P(destination, source, length)  memcpy((destination), (source), (length))
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
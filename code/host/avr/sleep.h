@@ -0,0 +1,26 @@
+/*******************************
+ *  avr/sleep.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include "host.h"
+
+#define SLEEP_MODE_IDLE         0
+#define SLEEP_MODE_ADC          1
+#define SLEEP_MODE_PWR_DOWN     2
+#define SLEEP_MODE_PWR_SAVE     3
+#define SLEEP_MODE_STANDBY      6
+
+#define set_sleep_mode(mode)  Host_setSleepMode(mode)
+#define sleep_enable()        ((void)0)
+#define sleep_disable()       ((void)0)
+#define sleep_cpu()           Host_sleep()
+#define sleep_mode()          Host_sleep()
+
+#endif /* HOST_AVR_SLEEP_H_ */
@@ -0,0 +1,28 @@
+/*******************************
+ *  avr/wdt.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef HOST_AVR_WDT_H_
+#define HOST_AVR_WDT_H_
+
+#include "host.h"
+
+#define WDTO_15MS   0
+#define WDTO_30MS   1
+#define WDTO_60MS   2
+#define WDTO_120MS  3
+#define WDTO_250MS  4
+#define WDTO_500MS  5
+#define WDTO_1S     6
+#define WDTO_2S     7
+
+/* The timeouts are 16 ms << WDTO_x, an expired watchdog ends the process */
+#define wdt_enable(timeout)  Host_watchdogEnable(16UL<<(timeout))
+#define wdt_disable()        Host_watchdogEnable(0)
+#define wdt_reset()          Host_watchdogReset()
+
+#endif /* HOST_AVR_WDT_H_ */
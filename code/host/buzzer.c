@@ -0,0 +1,32 @@
+/*******************************
+ *  buzzer.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/* Host backend of buzzer.h, every change of the buzzer is printed */
+
+#include"buzzer.h"
+#include"host.h"
+
+static boolean g_on=FALSE;
+
+void Buzzer_init(){
+	g_on=FALSE;
+}
+
+void Buzzer_on(void){
+	if(!g_on){
+		g_on=TRUE;
+		Host_print("BUZZER on");
+	}
+}
+
+void Buzzer_off(void){
+	if(g_on){
+		g_on=FALSE;
+		Host_print("BUZZER off");
+	}
+}
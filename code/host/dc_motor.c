@@ -0,0 +1,39 @@
+/*******************************
+ *  dc_motor.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/* Host backend of dc_motor.h, every change of the motor is printed */
+
+#include"dc_motor.h"
+#include"host.h"
+
+static DcMotor_State g_state=STOP;
+static uint8 g_speed=0;
+
+void DcMotor_init(void){
+	g_state=STOP;
+	g_speed=0;
+}
+
+void DcMotor_Rotate(DcMotor_State state,uint8 speed){
+	static const char *const names[]={"STOP","CW","A_CW"};
+
+	if(speed>100){
+		speed=100;
+	}
+	if(state==g_state&&speed==g_speed){
+		return;
+	}
+	g_state=state;
+	g_speed=speed;
+	if(state==STOP){
+		Host_print("MOTOR STOP");
+	}
+	else{
+		Host_print("MOTOR %s %u%%",names[state],speed);
+	}
+}
@@ -0,0 +1,627 @@
+/*******************************
+ *  host.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Built without the ECU flags (-fpack-struct and -fshort-enums would change
+ * the libc structures), so the firmware headers are not included here.
+ */
+
+#define _GNU_SOURCE
+#include "host.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_MAX_INTERRUPTS  8
+
+/* Registers at their data space address, see avr/io.h */
+#define HOST_SREG    (Host_io[0x5F])
+#define HOST_GICR    (Host_io[0x5B])
+#define HOST_MCUCSR  (Host_io[0x54])
+#define HOST_I_BIT   7
+#define HOST_INT0    6
+#define HOST_INT2    5
+#define HOST_PORF    0
+
+/* avr/sleep.h */
+#define HOST_SLEEP_MODE_PWR_DOWN  2
+
+/* Internal EEPROM of the ATmega32, E2END+1 */
+#define HOST_INTERNAL_EEPROM_SIZE  1024
+
+/* Fastest tick signal, faster time scales deliver several ticks per signal */
+#define HOST_MIN_SIGNAL_US  100
+
+#define HOST_KEY_ENTER  13
+
+volatile uint8_t Host_io[0x60] __attribute__((aligned(2)));
+
+/* Interrupt handlers of the firmware, called on wake-up from power-down */
+extern void INT0_vect(void) __attribute__((weak));
+extern void INT2_vect(void) __attribute__((weak));
+
+/* Start of the EEMEM variables, defined by the linker when there are some */
+extern char __start_host_eeprom[] __attribute__((weak));
+
+static const char *g_name;
+static double g_scale=1.0;
+static struct timespec g_start;
+
+static void (*g_isrs[HOST_MAX_INTERRUPTS])(void);
+static volatile uint8_t g_isr_count=0;
+static volatile uint64_t g_ticks=0;
+static volatile uint64_t g_frozen_us=0;
+static volatile sig_atomic_t g_powered_down=0;
+static volatile sig_atomic_t g_in_tick=0;
+static uint8_t g_sleep_mode=0;
+
+static volatile uint32_t g_wdt_timeout_ms=0;
+static volatile uint64_t g_wdt_kick_us=0;
+
+static void (*volatile g_render)(uint8_t force)=NULL;
+
+static int g_uart=-1;
+
+static uint8_t *g_eeprom=NULL;
+static uint16_t g_eeprom_size=0;
+
+/* Keypad script, see Host_keyReady */
+static int g_keys=-1;
+static char g_key_buffer[256];
+static size_t g_key_length=0;
+static uint8_t g_key_eof=0;
+static int g_key=-1;
+static char g_key_name[8];
+static uint64_t g_key_due_us=0;
+static uint64_t g_last_key_us=0;
+
+/* Microseconds of real time since start, times the scale */
+static uint64_t Host_wallMicros(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return (uint64_t)((((double)(now.tv_sec-g_start.tv_sec))*1e6
+			+(double)(now.tv_nsec-g_start.tv_nsec)/1e3)*g_scale);
+}
+
+static uint64_t Host_ecuMicros(void){
+	return Host_wallMicros()-g_frozen_us;
+}
+
+static void Host_write(const char *text,size_t length){
+	while(length>0){
+		ssize_t written=write(STDOUT_FILENO,text,length);
+		if(written<0&&errno==EINTR){
+			continue;
+		}
+		if(written<=0){
+			return;
+		}
+		text+=written;
+		length-=(size_t)written;
+	}
+}
+
+static void Host_vprint(const char *format,va_list args){
+	char line[256];
+	uint64_t us=Host_ecuMicros();
+	int length=snprintf(line,sizeof(line),"%-8s %6lu.%03lu  ",g_name,
+			(unsigned long)(us/1000000),(unsigned long)(us/1000%1000));
+	length+=vsnprintf(line+length,sizeof(line)-(size_t)length-1,format,args);
+	if(length>(int)sizeof(line)-2){
+		length=(int)sizeof(line)-2;
+	}
+	line[length++]='\n';
+	Host_write(line,(size_t)length);
+}
+
+void Host_print(const char *format,...){
+	va_list args;
+	va_start(args,format);
+	Host_vprint(format,args);
+	va_end(args);
+}
+
+void Host_exit(int status,const char *reason){
+	sigset_t block;
+	sigemptyset(&block);
+	sigaddset(&block,SIGALRM);
+	sigprocmask(SIG_BLOCK,&block,NULL);
+	if(g_render!=NULL&&!g_in_tick){
+		g_render(1);
+	}
+	Host_print("exit: %s",reason);
+	_exit(status);
+}
+
+/*
+ * Tick signal: deliver the ticks the ECU clock owes, each one calls every
+ * ISR with the I bit cleared as the hardware does. With the I bit clear
+ * the ticks stay pending for the next signal.
+ */
+static void Host_tick(int signal_number){
+	int saved_errno=errno;
+	uint8_t i;
+	(void)signal_number;
+
+	if(g_in_tick||g_powered_down||!(HOST_SREG&(1<<HOST_I_BIT))){
+		errno=saved_errno;
+		return;
+	}
+	g_in_tick=1;
+	while(g_ticks<Host_ecuMicros()/1000&&(HOST_SREG&(1<<HOST_I_BIT))){
+		g_ticks++;
+		HOST_SREG&=(uint8_t)~(1<<HOST_I_BIT);
+		for(i=0;i<g_isr_count;i++){
+			g_isrs[i]();
+		}
+		HOST_SREG|=(1<<HOST_I_BIT);
+		if(g_wdt_timeout_ms!=0&&g_ticks*1000-g_wdt_kick_us>(uint64_t)g_wdt_timeout_ms*1000){
+			Host_exit(2,"watchdog reset");
+		}
+	}
+	if(g_render!=NULL){
+		g_render(0);
+	}
+	g_in_tick=0;
+	errno=saved_errno;
+}
+
+__attribute__((constructor)) static void Host_init(void){
+	struct sigaction action;
+	struct itimerval timer;
+	const char *text;
+	long period_us;
+
+	g_name=getenv("HOST_NAME");
+	if(g_name==NULL||g_name[0]=='\0'){
+		g_name=program_invocation_short_name;
+	}
+	text=getenv("HOST_TIME_SCALE");
+	if(text!=NULL&&(g_scale=atof(text))<=0){
+		fprintf(stderr,"%s: bad HOST_TIME_SCALE %s\n",g_name,text);
+		exit(1);
+	}
+	clock_gettime(CLOCK_MONOTONIC,&g_start);
+
+	/* A power-on reset */
+	HOST_MCUCSR=(1<<HOST_PORF);
+
+	signal(SIGPIPE,SIG_IGN);
+	memset(&action,0,sizeof(action));
+	action.sa_handler=&Host_tick;
+	action.sa_flags=SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGALRM,&action,NULL);
+
+	period_us=(long)(1000.0/g_scale);
+	if(period_us<HOST_MIN_SIGNAL_US){
+		period_us=HOST_MIN_SIGNAL_US;
+	}
+	timer.it_interval.tv_sec=period_us/1000000;
+	timer.it_interval.tv_usec=period_us%1000000;
+	timer.it_value=timer.it_interval;
+	setitimer(ITIMER_REAL,&timer,NULL);
+}
+
+void Host_attachInterrupt(void (*isr)(void)){
+	uint8_t i;
+	for(i=0;i<g_isr_count;i++){
+		if(g_isrs[i]==isr){
+			return;
+		}
+	}
+	if(g_isr_count==HOST_MAX_INTERRUPTS){
+		Host_exit(1,"too many interrupts attached");
+	}
+	g_isrs[g_isr_count]=isr;
+	g_isr_count++;
+}
+
+uint32_t Host_micros(void){
+	return (uint32_t)Host_ecuMicros();
+}
+
+uint32_t Host_sinceTick(void){
+	uint64_t since=Host_ecuMicros()-g_ticks*1000;
+	return (since>999)?999:(uint32_t)since;
+}
+
+/* Real time sleep of up to us microseconds of the ECU clock, a signal ends it early */
+static void Host_nap(uint64_t us){
+	struct timespec duration;
+	double real_us=(double)us/g_scale;
+	duration.tv_sec=(time_t)(real_us/1e6);
+	duration.tv_nsec=(long)((real_us-(double)duration.tv_sec*1e6)*1e3);
+	nanosleep(&duration,NULL);
+}
+
+void Host_delay(uint32_t us){
+	uint64_t end=Host_ecuMicros()+us;
+	uint64_t now;
+	while((now=Host_ecuMicros())<end){
+		Host_nap(end-now);
+	}
+}
+
+void Host_setSleepMode(uint8_t mode){
+	g_sleep_mode=mode;
+}
+
+static int Host_pollUart(int timeout_ms){
+	struct pollfd link;
+	link.fd=g_uart;
+	link.events=POLLIN;
+	link.revents=0;
+	if(g_uart<0||poll(&link,1,timeout_ms)<=0){
+		return 0;
+	}
+	return (link.revents&(POLLIN|POLLHUP|POLLERR))!=0;
+}
+
+/* Power-down: no ticks, wait for a byte or a key with its wake-up interrupt enabled */
+static void Host_powerDown(void){
+	uint64_t start=Host_wallMicros();
+	uint64_t wait_us;
+	uint8_t link,key;
+
+	g_powered_down=1;
+	while(1){
+		link=(HOST_GICR&(1<<HOST_INT0))&&Host_pollUart(0);
+		key=(HOST_GICR&(1<<HOST_INT2))&&Host_keyReady();
+		if(link||key){
+			break;
+		}
+		wait_us=(g_key>=0&&g_key_due_us>Host_wallMicros())?g_key_due_us-Host_wallMicros():1000;
+		if(wait_us>100000){
+			wait_us=100000;
+		}
+		if(g_uart>=0&&(HOST_GICR&(1<<HOST_INT0))){
+			Host_pollUart((int)(wait_us/g_scale/1000)+1);
+		}
+		else{
+			Host_nap(wait_us);
+		}
+	}
+	g_frozen_us+=Host_wallMicros()-start;
+	g_powered_down=0;
+
+	/* The wake-up interrupt runs before the instruction after sleep */
+	HOST_SREG&=(uint8_t)~(1<<HOST_I_BIT);
+	if(link&&INT0_vect!=NULL){
+		INT0_vect();
+	}
+	if(key&&INT2_vect!=NULL){
+		INT2_vect();
+	}
+	HOST_SREG|=(1<<HOST_I_BIT);
+}
+
+void Host_sleep(void){
+	if(g_sleep_mode==HOST_SLEEP_MODE_PWR_DOWN){
+		Host_powerDown();
+	}
+	else if(g_uart>=0){
+		/* Idle mode: any interrupt wakes, the signal or the receiver */
+		Host_pollUart(-1);
+	}
+	else{
+		pause();
+	}
+}
+
+void Host_watchdogEnable(uint32_t timeout_ms){
+	g_wdt_kick_us=g_ticks*1000;
+	g_wdt_timeout_ms=timeout_ms;
+}
+
+void Host_watchdogReset(void){
+	g_wdt_kick_us=g_ticks*1000;
+}
+
+static void Host_makeRaw(int fd){
+	struct termios settings;
+	if(tcgetattr(fd,&settings)==0){
+		cfmakeraw(&settings);
+		tcsetattr(fd,TCSANOW,&settings);
+	}
+}
+
+void Host_uartOpen(void){
+	const char *spec=getenv("HOST_UART");
+	uint8_t data;
+	int slave;
+
+	if(g_uart>=0){
+		return;
+	}
+	if(spec==NULL||strcmp(spec,"pty")==0){
+		/* The slave stays open here too, so the link survives the tools closing it */
+		g_uart=posix_openpt(O_RDWR|O_NOCTTY);
+		if(g_uart<0||grantpt(g_uart)!=0||unlockpt(g_uart)!=0
+				||(slave=open(ptsname(g_uart),O_RDWR|O_NOCTTY))<0){
+			Host_exit(1,"cannot create the pty");
+		}
+		Host_makeRaw(slave);
+		fprintf(stderr,"%s: UART on %s\n",g_name,ptsname(g_uart));
+	}
+	else if(strncmp(spec,"fd:",3)==0){
+		g_uart=atoi(spec+3);
+	}
+	else{
+		g_uart=open(spec,O_RDWR|O_NOCTTY);
+		if(g_uart<0){
+			Host_exit(1,"cannot open HOST_UART");
+		}
+		Host_makeRaw(g_uart);
+	}
+
+	/* The receiver was off until now, what the other side sent before is lost */
+	while(Host_pollUart(0)&&read(g_uart,&data,1)==1){
+	}
+}
+
+uint8_t Host_uartAvailable(void){
+	Host_uartOpen();
+	return (uint8_t)Host_pollUart(0);
+}
+
+uint8_t Host_uartRead(void){
+	uint8_t data;
+	ssize_t count;
+
+	Host_uartOpen();
+	while((count=read(g_uart,&data,1))<0&&errno==EINTR){
+	}
+	if(count!=1){
+		Host_exit(0,"link closed");
+	}
+	return data;
+}
+
+void Host_uartWrite(uint8_t data){
+	ssize_t count;
+
+	Host_uartOpen();
+	while((count=write(g_uart,&data,1))<0&&errno==EINTR){
+	}
+	if(count!=1){
+		Host_exit(0,"link closed");
+	}
+}
+
+/*
+ * Parse the next key of the script, TRUE when one is pending. The script
+ * is a list of words separated by blanks: every character of a word is a
+ * key (0-9 + - * % =), "enter" is the Enter key, "wait=MS" delays the next
+ * key by MS milliseconds after the previous one, # starts a comment.
+ */
+static uint8_t Host_parseKey(void){
+	struct pollfd keys;
+	size_t start,end;
+	ssize_t count;
+	const char *text;
+
+	while(g_key<0){
+		if(g_keys<0){
+			text=getenv("HOST_KEYS");
+			g_keys=(text==NULL)?STDIN_FILENO:open(text,O_RDONLY);
+			if(g_keys<0){
+				Host_exit(1,"cannot open HOST_KEYS");
+			}
+		}
+
+		/* Skip blanks and comments */
+		start=0;
+		while(start<g_key_length){
+			if(g_key_buffer[start]=='#'){
+				end=start;
+				while(end<g_key_length&&g_key_buffer[end]!='\n'){
+					end++;
+				}
+				if(end==g_key_length&&!g_key_eof){
+					break;
+				}
+				start=end;
+			}
+			else if(g_key_buffer[start]==' '||g_key_buffer[start]=='\t'
+					||g_key_buffer[start]=='\n'||g_key_buffer[start]=='\r'){
+				start++;
+			}
+			else{
+				break;
+			}
+		}
+		memmove(g_key_buffer,g_key_buffer+start,g_key_length-start);
+		g_key_length-=start;
+
+		end=0;
+		while(end<g_key_length&&strchr(" \t\r\n#",g_key_buffer[end])==NULL){
+			end++;
+		}
+		if(!g_key_eof&&(end==g_key_length||g_key_buffer[0]=='#')){
+			/* No complete word or comment yet, read more without blocking */
+			keys.fd=g_keys;
+			keys.events=POLLIN;
+			if(g_key_length==sizeof(g_key_buffer)||poll(&keys,1,0)<=0){
+				return 0;
+			}
+			count=read(g_keys,g_key_buffer+g_key_length,sizeof(g_key_buffer)-g_key_length);
+			if(count<0&&errno==EINTR){
+				continue;
+			}
+			if(count<=0){
+				g_key_eof=1;
+			}
+			else{
+				g_key_length+=(size_t)count;
+			}
+			continue;
+		}
+		if(end==0){
+			/* End of the script */
+			return 0;
+		}
+
+		if(end==5&&strncmp(g_key_buffer,"enter",5)==0){
+			g_key=HOST_KEY_ENTER;
+			strcpy(g_key_name,"enter");
+		}
+		else if(end>5&&strncmp(g_key_buffer,"wait=",5)==0){
+			g_key_due_us+=(uint64_t)strtoul(g_key_buffer+5,NULL,10)*1000;
+		}
+		else if(g_key_buffer[0]>='0'&&g_key_buffer[0]<='9'){
+			g_key=g_key_buffer[0]-'0';
+			end=1;
+		}
+		else if(strchr("+-*%=",g_key_buffer[0])!=NULL){
+			g_key=(uint8_t)g_key_buffer[0];
+			end=1;
+		}
+		else{
+			Host_exit(1,"bad key in the keypad script");
+		}
+		if(g_key>=0&&g_key!=HOST_KEY_ENTER){
+			g_key_name[0]=g_key_buffer[0];
+			g_key_name[1]='\0';
+		}
+		memmove(g_key_buffer,g_key_buffer+end,g_key_length-end);
+		g_key_length-=end;
+	}
+	return 1;
+}
+
+uint8_t Host_keyReady(void){
+	if(!Host_parseKey()){
+		if(g_key_eof&&g_key_length==0){
+			Host_exit(0,"keypad script finished");
+		}
+		return 0;
+	}
+	return Host_wallMicros()>=g_last_key_us+g_key_due_us;
+}
+
+uint8_t Host_nextKey(void){
+	uint8_t key;
+
+	while(!Host_keyReady()){
+		Host_nap(1000);
+	}
+	if(g_render!=NULL){
+		g_render(1);
+	}
+	key=(uint8_t)g_key;
+	Host_print("KEY %s",g_key_name);
+	g_key=-1;
+	g_key_due_us=0;
+	g_last_key_us=Host_wallMicros();
+	return key;
+}
+
+uint8_t *Host_eeprom(uint16_t size){
+	char default_path[256];
+	const char *path;
+	struct stat info;
+	uint8_t erased[64];
+	off_t offset;
+	int fd;
+
+	if(g_eeprom!=NULL){
+		if(size!=g_eeprom_size){
+			Host_exit(1,"one EEPROM size per process");
+		}
+		return g_eeprom;
+	}
+	path=getenv("HOST_EEPROM");
+	if(path==NULL){
+		snprintf(default_path,sizeof(default_path),"%s.eeprom",g_name);
+		path=default_path;
+	}
+	fd=open(path,O_RDWR|O_CREAT,0644);
+	if(fd<0||fstat(fd,&info)!=0){
+		Host_exit(1,"cannot open HOST_EEPROM");
+	}
+	/* A new or short file is erased */
+	memset(erased,0xFF,sizeof(erased));
+	for(offset=info.st_size;offset<size;offset+=(off_t)sizeof(erased)){
+		size_t length=((off_t)size-offset<(off_t)sizeof(erased))?(size_t)(size-offset):sizeof(erased);
+		if(pwrite(fd,erased,length,offset)!=(ssize_t)length){
+			Host_exit(1,"cannot write HOST_EEPROM");
+		}
+	}
+	g_eeprom=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	if(g_eeprom==MAP_FAILED){
+		Host_exit(1,"cannot map HOST_EEPROM");
+	}
+	close(fd);
+	g_eeprom_size=size;
+	return g_eeprom;
+}
+
+void Host_setDisplay(void (*render)(uint8_t force)){
+	g_render=render;
+}
+
+/* Internal EEPROM, avr/eeprom.h */
+static uint8_t *Host_eepromAt(const void *address,size_t length){
+	size_t offset;
+	if(__start_host_eeprom==NULL){
+		Host_exit(1,"no EEMEM variables");
+	}
+	offset=(size_t)((const char*)address-__start_host_eeprom);
+	if(offset+length>HOST_INTERNAL_EEPROM_SIZE){
+		Host_exit(1,"EEPROM address out of range");
+	}
+	return Host_eeprom(HOST_INTERNAL_EEPROM_SIZE)+offset;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address){
+	return *Host_eepromAt(address,1);
+}
+
+uint16_t eeprom_read_word(const uint16_t *address){
+	uint16_t value;
+	memcpy(&value,Host_eepromAt(address,sizeof(value)),sizeof(value));
+	return value;
+}
+
+uint32_t eeprom_read_dword(const uint32_t *address){
+	uint32_t value;
+	memcpy(&value,Host_eepromAt(address,sizeof(value)),sizeof(value));
+	return value;
+}
+
+void eeprom_read_block(void *destination,const void *source,size_t length){
+	memcpy(destination,Host_eepromAt(source,length),length);
+}
+
+void eeprom_write_byte(uint8_t *address,uint8_t value){
+	*Host_eepromAt(address,1)=value;
+}
+
+void eeprom_write_word(uint16_t *address,uint16_t value){
+	memcpy(Host_eepromAt(address,sizeof(value)),&value,sizeof(value));
+}
+
+void eeprom_write_dword(uint32_t *address,uint32_t value){
+	memcpy(Host_eepromAt(address,sizeof(value)),&value,sizeof(value));
+}
+
+void eeprom_write_block(const void *source,void *destination,size_t length){
+	memcpy(Host_eepromAt(destination,length),source,length);
+}
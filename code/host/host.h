@@ -0,0 +1,87 @@
+/*******************************
+ *  host.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Process services of the Linux build, used by the host drivers of this
+ * directory in place of the ATmega32 peripherals.
+ *
+ * Interrupts: a POSIX timer signal delivers one tick per millisecond of
+ * the ECU clock. Each tick calls the attached ISRs in order, unless the I
+ * bit of SREG is clear: the tick then waits, like a pending interrupt,
+ * and is delivered with the next signal. The ECU clock runs HOST_TIME_SCALE
+ * times faster than the real time and stops in power-down.
+ *
+ * Environment:
+ *  - HOST_NAME:       prefix of the messages, the program name by default.
+ *  - HOST_UART:       "fd:N" for an open descriptor (the socketpair of
+ *                     tools/host_run.py), "pty" for a new pseudo terminal
+ *                     (the default, its name is printed) or a device path.
+ *  - HOST_EEPROM:     EEPROM file, HOST_NAME.eeprom by default. A new file
+ *                     is erased (0xFF).
+ *  - HOST_KEYS:       keypad script, standard input by default (keypad.c).
+ *  - HOST_TIME_SCALE: speed of the ECU clock, 1 by default.
+ *
+ * The messages (LCD, motor, keys...) go to standard output, one line each,
+ * with the ECU time in seconds.
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+
+/* Call isr from every tick, in the order of attachment */
+void Host_attachInterrupt(void (*isr)(void));
+
+/* Microseconds of the ECU clock since the process started */
+uint32_t Host_micros(void);
+
+/* Microseconds since the last delivered tick, 0 to 999 */
+uint32_t Host_sinceTick(void);
+
+/* Wait, the ticks go on */
+void Host_delay(uint32_t us);
+
+/*
+ * Sleep until the next tick. In SLEEP_MODE_PWR_DOWN the ticks stop and the
+ * sleep lasts until a byte or a key arrives: the INT0 or INT2 handler of
+ * the firmware is called for it when enabled in GICR.
+ */
+void Host_setSleepMode(uint8_t mode);
+void Host_sleep(void);
+
+/* Watchdog in milliseconds of the ECU clock, 0 disables it */
+void Host_watchdogEnable(uint32_t timeout_ms);
+void Host_watchdogReset(void);
+
+/* Link byte stream, the process ends when the other side closes it */
+void Host_uartOpen(void);
+uint8_t Host_uartAvailable(void);
+uint8_t Host_uartRead(void);
+void Host_uartWrite(uint8_t data);
+
+/* Keypad script: TRUE once the next key is due, the key code then */
+uint8_t Host_keyReady(void);
+uint8_t Host_nextKey(void);
+
+/* The EEPROM file mapped in memory, size bytes */
+uint8_t *Host_eeprom(uint16_t size);
+
+/*
+ * Display printer, called after the ticks of every signal with force FALSE,
+ * and with force TRUE before a key is taken and at exit.
+ */
+void Host_setDisplay(void (*render)(uint8_t force));
+
+/* One line on standard output, printf format, the ECU time in front */
+void Host_print(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/* Print the reason and end the process */
+void Host_exit(int status, const char *reason);
+
+#endif /* HOST_H_ */
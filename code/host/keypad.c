@@ -0,0 +1,66 @@
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.c
+ *
+ * Description: Host backend of the Keypad driver, the keys come from the
+ *              HOST_KEYS script (host.c) already mapped like
+ *              KEYPAD_4x4_adjustKeyNumber: digits 0-9, '+', '-', '*', '%',
+ *              '=' and 13 for Enter
+ *
+ * Author: Muhannad Abdallah
+ *
+ *******************************************************************************/
+
+#include "keypad.h"
+#include "host.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* A scan of the four rows takes 4 x 5 ms on the ECU */
+#define KEYPAD_SCAN_TIME_US 20000
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static void(*g_idleCallBackPtr)(boolean first) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 KEYPAD_getPressedKey(void)
+{
+	boolean first = TRUE;
+
+	while(!Host_keyReady())
+	{
+		Host_delay(KEYPAD_SCAN_TIME_US);
+
+		/* No key in this scan */
+		if(g_idleCallBackPtr != NULL_PTR)
+		{
+			(*g_idleCallBackPtr)(first);
+		}
+		first = FALSE;
+	}
+	return Host_nextKey();
+}
+
+void KEYPAD_setIdleCallBack(void(*a_ptr)(boolean first))
+{
+	g_idleCallBackPtr = a_ptr;
+}
+
+/* A due key wakes the host from power-down through INT2, see Host_sleep */
+void KEYPAD_armWakeUp(void)
+{
+}
+
+void KEYPAD_disarmWakeUp(void)
+{
+}
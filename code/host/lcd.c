@@ -0,0 +1,248 @@
+ /******************************************************************************
+ *
+ * Module: LCD
+ *
+ * File Name: lcd.c
+ *
+ * Description: Host backend of the LCD driver, a text model of the display
+ *
+ * Author: Muhannad Abdallah
+ *
+ *******************************************************************************/
+
+#include "lcd.h"
+#include "systick.h"
+#include "host.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Two lines of 40 characters of DDRAM, the first 16 columns are visible */
+#define LCD_ROWS            2
+#define LCD_DDRAM_COLUMNS   40
+#define LCD_VISIBLE_COLUMNS 16
+
+/* The screen is printed once it has not changed for this long */
+#define LCD_SETTLE_MS       20
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static char g_ddram[LCD_ROWS][LCD_DDRAM_COLUMNS];
+static uint8 g_address = 0;
+static boolean g_display_on = FALSE;
+
+/* What was printed last, a screen is only printed when it differs */
+static char g_printed[LCD_ROWS][LCD_VISIBLE_COLUMNS + 1];
+static boolean g_printed_on = FALSE;
+
+static volatile boolean g_dirty = FALSE;
+static volatile boolean g_busy = FALSE;
+static volatile uint32 g_changed_ms = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions(Private)                         *
+ *******************************************************************************/
+
+static void LCD_changed(void)
+{
+	g_changed_ms = SysTick_getMillis();
+	g_dirty = TRUE;
+}
+
+/*
+ * Description :
+ * Print the screen when it changed. Called from the host tick, where a
+ * screen still being written is skipped, and from the main loop with force.
+ */
+static void LCD_render(uint8_t force)
+{
+	uint8 row, col;
+	boolean same;
+
+	if(!g_dirty || g_busy || (!force && SysTick_elapsedSince(g_changed_ms) < LCD_SETTLE_MS))
+	{
+		return;
+	}
+	g_dirty = FALSE;
+
+	same = (g_display_on == g_printed_on);
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		for(col = 0 ; col < LCD_VISIBLE_COLUMNS ; col++)
+		{
+			if(g_printed[row][col] != g_ddram[row][col])
+			{
+				g_printed[row][col] = g_ddram[row][col];
+				same = FALSE;
+			}
+		}
+	}
+	if(same)
+	{
+		return;
+	}
+	g_printed_on = g_display_on;
+	if(!g_display_on)
+	{
+		Host_print("LCD  (display off)");
+		return;
+	}
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		Host_print("LCD  |%s|", g_printed[row]);
+	}
+}
+
+static void LCD_clearDdram(void)
+{
+	uint8 row, col;
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		for(col = 0 ; col < LCD_DDRAM_COLUMNS ; col++)
+		{
+			g_ddram[row][col] = ' ';
+		}
+	}
+	g_address = 0;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void LCD_init(void)
+{
+	uint8 row;
+
+	/* LCD Power ON delay always > 15ms, the time spent since reset counts */
+	while(SysTick_getMillis() < LCD_POWER_ON_DELAY_MS);
+
+	g_busy = TRUE;
+	LCD_clearDdram();
+	for(row = 0 ; row < LCD_ROWS ; row++)
+	{
+		g_printed[row][LCD_VISIBLE_COLUMNS] = '\0';
+	}
+	g_display_on = TRUE;
+	g_busy = FALSE;
+	LCD_changed();
+	Host_setDisplay(&LCD_render);
+}
+
+/*
+ * Description :
+ * Only the commands the firmware uses change the model: clear, home,
+ * display on/off and set DDRAM address.
+ */
+void LCD_sendCommand(uint8 command)
+{
+	g_busy = TRUE;
+	if(command == LCD_CLEAR_COMMAND)
+	{
+		LCD_clearDdram();
+	}
+	else if((command & 0xFE) == LCD_GO_TO_HOME)
+	{
+		g_address = 0;
+	}
+	else if(command & LCD_SET_CURSOR_LOCATION)
+	{
+		g_address = command & 0x7F;
+	}
+	else if((command & 0xF8) == LCD_DISPLAY_OFF)
+	{
+		g_display_on = (command & 0x04) ? TRUE : FALSE;
+	}
+	g_busy = FALSE;
+	LCD_changed();
+}
+
+void LCD_displayCharacter(uint8 data)
+{
+	uint8 col = g_address & 0x3F;
+
+	g_busy = TRUE;
+	if(col < LCD_DDRAM_COLUMNS)
+	{
+		g_ddram[(g_address & 0x40) ? 1 : 0][col] = (data >= ' ' && data < 0x7F) ? (char)data : '?';
+	}
+	/* The address counter runs from the end of a line to the start of the other */
+	if(col + 1 < LCD_DDRAM_COLUMNS)
+	{
+		g_address++;
+	}
+	else
+	{
+		g_address = (g_address & 0x40) ? 0x00 : 0x40;
+	}
+	g_busy = FALSE;
+	LCD_changed();
+}
+
+void LCD_displayString(const char *Str)
+{
+	uint8 i = 0;
+	while(Str[i] != '\0')
+	{
+		LCD_displayCharacter(Str[i]);
+		i++;
+	}
+}
+
+void LCD_moveCursor(uint8 row,uint8 col)
+{
+	uint8 lcd_memory_address = col;
+
+	/* Calculate the required address in the LCD DDRAM */
+	switch(row)
+	{
+		case 1:
+			lcd_memory_address=col+0x40;
+				break;
+		case 2:
+			lcd_memory_address=col+0x10;
+				break;
+		case 3:
+			lcd_memory_address=col+0x50;
+				break;
+	}
+	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
+}
+
+void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
+{
+	LCD_moveCursor(row,col);
+	LCD_displayString(Str);
+}
+
+/*
+ * Description :
+ * Display the required decimal value on the screen, itoa is not in the
+ * host C library
+ */
+void LCD_intgerToString(int data)
+{
+	char buff[16];
+	uint8 i = sizeof(buff) - 1;
+	unsigned int value = (data < 0) ? 0u - (unsigned int)data : (unsigned int)data;
+
+	buff[i] = '\0';
+	do
+	{
+		buff[--i] = (char)('0' + value % 10);
+		value /= 10;
+	} while(value != 0);
+	if(data < 0)
+	{
+		buff[--i] = '-';
+	}
+	LCD_displayString(&buff[i]);
+}
+
+void LCD_clearScreen(void)
+{
+	LCD_sendCommand(LCD_CLEAR_COMMAND);
+}
@@ -0,0 +1,29 @@
+/*******************************
+ *  ram_usage.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Host backend of ram_usage.h. The host process has no 2 KB SRAM layout to
+ * measure: every size reads 0 and LINK_DIAG_RAM answers a frame of zeros,
+ * so the tools can tell a host build apart.
+ */
+
+#include "ram_usage.h"
+#include "link.h"
+
+uint16 RamUsage_getStackHighWater(void){
+	return 0;
+}
+
+uint16 RamUsage_getFree(void){
+	return 0;
+}
+
+void RamUsage_dump(void){
+	uint16 frame[6]={0,0,0,0,0,0};
+	LINK_sendFrame(LINK_DIAG_RAM,(const uint8*)frame,sizeof(frame));
+}
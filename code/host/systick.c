@@ -0,0 +1,54 @@
+/*******************************
+ *  systick.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/* Host backend of systick.h: the host tick replaces the Timer2 compare match */
+
+#include "systick.h"
+#include "host.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile uint32 g_millis=0;
+static void(*volatile g_callBackPtr)(void)=NULL_PTR;
+
+static void SysTick_tick(void){
+	g_millis++;
+	if(g_callBackPtr!=NULL_PTR){
+		(*g_callBackPtr)();
+	}
+}
+
+void SysTick_init(void){
+	Host_attachInterrupt(&SysTick_tick);
+}
+
+uint32 SysTick_getMillis(void){
+	uint32 millis;
+	uint8 sreg=SREG;
+	cli();
+	millis=g_millis;
+	SREG=sreg;
+	return millis;
+}
+
+uint32 SysTick_elapsedSince(uint32 start){
+	return SysTick_getMillis()-start;
+}
+
+uint32 SysTick_getMicros(void){
+	uint32 micros;
+	uint8 sreg=SREG;
+	cli();
+	micros=g_millis*1000UL+Host_sinceTick();
+	SREG=sreg;
+	return micros;
+}
+
+void SysTick_setCallBack(void(*a_ptr)(void)){
+	g_callBackPtr=a_ptr;
+}
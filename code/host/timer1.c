@@ -0,0 +1,69 @@
+/*******************************
+ *  timer1.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Host backend of timer1.h: the period is counted in host ticks, so it is
+ * rounded to the millisecond (the 1 s tick of both ECUs is exact).
+ */
+
+#include "timer1.h"
+#include "trace.h"
+#include "metrics.h"
+#include "systick.h"
+#include "host.h"
+
+static void(*volatile g_callBackPtr)(void)=NULL_PTR;
+static volatile uint32 g_period_ms=0;
+static volatile uint32 g_elapsed_ms=0;
+
+/* Timer clock divider of each Timer1_Prescaler */
+static const uint16 g_dividers[]={0,1,8,64,256,1024};
+
+/* Compare match or overflow, once every period */
+static void Timer1_tick(void){
+	uint32 start;
+	if(g_period_ms==0||++g_elapsed_ms<g_period_ms){
+		return;
+	}
+	g_elapsed_ms=0;
+	start=SysTick_getMicros();
+	TRACE_ISR(TRACE_TIMER1_ENTER,0);
+	if(g_callBackPtr!=NULL_PTR){
+		(*g_callBackPtr)();
+	}
+	TRACE_ISR(TRACE_TIMER1_EXIT,0);
+	METRIC_MAX(METRIC_TIMER1_ISR_MAX_US,SysTick_getMicros()-start);
+}
+
+void Timer1_init(const Timer1_ConfigType* Config_Ptr){
+	uint32 counts;
+	uint16 divider=(Config_Ptr->prescaler<sizeof(g_dividers)/sizeof(g_dividers[0]))
+			?g_dividers[Config_Ptr->prescaler]:0;
+
+	if(Config_Ptr->mode==COMPARE_MODE){
+		/* CTC, the counter goes from 0 to compare_value */
+		counts=(uint32)Config_Ptr->compare_value+1;
+	}
+	else{
+		counts=65536UL-Config_Ptr->initial_value;
+	}
+	Host_attachInterrupt(&Timer1_tick);
+	g_elapsed_ms=0;
+	g_period_ms=(divider==0)?0:(counts*divider+F_CPU/2000)/(F_CPU/1000);
+	if(divider!=0&&g_period_ms==0){
+		g_period_ms=1;
+	}
+}
+
+void Timer1_deInit(void){
+	g_period_ms=0;
+}
+
+void Timer1_setCallBack(void(*a_ptr)(void)){
+	g_callBackPtr=a_ptr;
+}
@@ -0,0 +1,162 @@
+/*******************************
+ *  twi.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Host backend of twi.h at transaction level, with a 24C16 on the bus: the
+ * HOST_EEPROM file. It answers the addresses 0x50-0x57, the low address
+ * bits select the 256-byte block and reg[0] is the word address. Writes
+ * wrap in their 16-byte page as on the device, the write cycle takes no
+ * time so ACK polling succeeds at once. The transaction at the head of the
+ * queue completes on the next host tick, where the TWI interrupt would
+ * have finished it; the callback runs from there.
+ */
+
+#include"twi.h"
+#include"trace.h"
+#include"log.h"
+#include"metrics.h"
+#include"host.h"
+#include<avr/interrupt.h>
+
+#define TWI_EEPROM_ADDRESS    0x50
+#define TWI_EEPROM_SIZE       2048
+#define TWI_EEPROM_PAGE_SIZE  16
+
+static TWI_ErrorCountersType g_errors;
+
+/* Transactions waiting for the bus, the head one is the running one */
+static TWI_TransactionType *volatile g_queue[TWI_QUEUE_SIZE];
+static volatile uint8 g_queue_head=0;
+static volatile uint8 g_queue_count=0;
+
+/* Run a whole transaction on the EEPROM model */
+static TWI_TransactionStatus TWI_execute(TWI_TransactionType *Transaction_Ptr){
+	uint8 *memory;
+	uint16 address;
+	uint16 i;
+
+	if((Transaction_Ptr->address&0xF8)!=TWI_EEPROM_ADDRESS){
+		/* Nobody answers SLA+W */
+		g_errors.nacks++;
+		return TWI_FAILED;
+	}
+	memory=Host_eeprom(TWI_EEPROM_SIZE);
+	address=(uint16)(Transaction_Ptr->address&0x07)<<8;
+	if(Transaction_Ptr->reg_len>0){
+		address|=Transaction_Ptr->reg[0];
+	}
+	for(i=0;i<Transaction_Ptr->length;i++){
+		if(Transaction_Ptr->direction==TWI_READ){
+			Transaction_Ptr->data[i]=memory[(address+i)%TWI_EEPROM_SIZE];
+		}
+		else{
+			memory[(address&~(TWI_EEPROM_PAGE_SIZE-1))|((address+i)&(TWI_EEPROM_PAGE_SIZE-1))]=
+					Transaction_Ptr->data[i];
+		}
+	}
+	return TWI_DONE;
+}
+
+/* Bus interrupt, one transaction per tick */
+static void TWI_tick(void){
+	TWI_TransactionType *transaction;
+	TWI_TransactionStatus status;
+
+	if(g_queue_count==0){
+		return;
+	}
+	transaction=g_queue[g_queue_head];
+	transaction->status=TWI_BUSY;
+	TRACE(TRACE_TWI_BEGIN,((uint16)transaction->address<<8)|transaction->reg[0]);
+	status=TWI_execute(transaction);
+
+	g_queue_head=(g_queue_head+1)%TWI_QUEUE_SIZE;
+	g_queue_count--;
+	transaction->status=status;
+	TRACE(TRACE_TWI_END,status);
+	if(status==TWI_FAILED){
+		METRIC_INC(METRIC_TWI_FAILURES);
+		LOG_ERROR(LOG_TWI_FAILED,transaction->address,transaction->reg[0]);
+	}
+	if(transaction->callback!=NULL_PTR)
+	{
+		transaction->callback(transaction);
+	}
+}
+
+void TWI_init(const TWI_ConfigType* Config_Ptr){
+	(void)Config_Ptr;
+	Host_attachInterrupt(&TWI_tick);
+}
+
+/* The byte level calls are not modelled, the bus reports an error */
+void TWI_start(void){
+}
+
+void TWI_stop(void){
+}
+
+void TWI_writeByte(uint8 data){
+	(void)data;
+}
+
+uint8 TWI_readByteWithACK(void){
+	return 0xFF;
+}
+
+uint8 TWI_readByteWithNACK(void){
+	return 0xFF;
+}
+
+uint8 TWI_getStatus(void){
+	return TWI_BUS_ERROR;
+}
+
+uint8 TWI_submit(TWI_TransactionType *Transaction_Ptr){
+	uint8 sreg=SREG;
+	uint8 result=SUCCESS;
+
+	if(Transaction_Ptr->reg_len>TWI_MAX_REG_BYTES
+			||(Transaction_Ptr->direction==TWI_READ&&Transaction_Ptr->length==0))
+	{
+		Transaction_Ptr->status=TWI_FAILED;
+		return ERROR;
+	}
+
+	cli();
+	if(g_queue_count==TWI_QUEUE_SIZE)
+	{
+		result=ERROR;
+	}
+	else
+	{
+		Transaction_Ptr->status=TWI_QUEUED;
+		g_queue[(g_queue_head+g_queue_count)%TWI_QUEUE_SIZE]=Transaction_Ptr;
+		g_queue_count++;
+		METRIC_MAX(METRIC_TWI_QUEUE_MAX,g_queue_count);
+	}
+	SREG=sreg;
+
+	return result;
+}
+
+boolean TWI_isIdle(void){
+	return (g_queue_count==0);
+}
+
+void TWI_recoverBus(void){
+	g_errors.recoveries++;
+}
+
+/* The model never holds the bus, there is no timeout to check */
+void TWI_service(void){
+}
+
+const TWI_ErrorCountersType* TWI_getErrorCounters(void){
+	return &g_errors;
+}
@@ -0,0 +1,57 @@
+/*******************************
+ *  uart.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+/*
+ * Host backend of uart.h: the link is the HOST_UART byte stream (host.h).
+ * The frame format and the baud rate do not apply, bytes go through at
+ * once and without line errors.
+ */
+
+#include "uart.h"
+#include "host.h"
+
+void UART_init(const UART_ConfigType* Config_Ptr) {
+    (void)Config_Ptr;
+    Host_uartOpen();
+}
+
+void UART_sendByte(const uint8 data) {
+    Host_uartWrite(data);
+}
+
+uint8 UART_receiveByte(void) {
+    return Host_uartRead();
+}
+
+boolean UART_isByteAvailable(void) {
+    return Host_uartAvailable() ? TRUE : FALSE;
+}
+
+/* A byte always ends the idle sleep on the host */
+void UART_wakeOnReceive(void) {
+}
+
+void UART_sendString(const uint8 *Str) {
+    uint8 i = 0;
+
+    while (Str[i] != '\0') {
+        UART_sendByte(Str[i]);
+        i++;
+    }
+}
+
+void UART_receiveString(uint8 *Str) {
+    uint8 i = 0;
+
+    Str[i] = UART_receiveByte();
+    while (Str[i] != '#') {
+        i++;
+        Str[i] = UART_receiveByte();
+    }
+    Str[i] = '\0';
+}
@@ -0,0 +1,18 @@
+/*******************************
+ *  util/delay.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  Author: Muhannad Abdallah
+ ******************************/
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include "host.h"
+
+/* The interrupts keep running, as they do during the busy loops on the ECU */
+#define _delay_ms(ms)  Host_delay((uint32_t)((ms)*1000UL))
+#define _delay_us(us)  Host_delay((uint32_t)(us))
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""Cycles, stack and flash of the driver hot paths, measured under simavr.
+
+Every routine is built into the harness code/bench/bench.c for the
+atmega32, with the other sources of its ECU and the flags of the Eclipse
+build, and run by code/bench/bench_sim.c, a simavr program that counts the
+cycles of each call and watches the stack pointer. It also plays the parts
+the drivers talk to: a 24C16 on the TWI bus, the UART looped back and one
+key of the keypad.
+
+    cycle_bench.py                               # table of every routine
+    cycle_bench.py --json > bench.json           # machine-readable, keep it
+    cycle_bench.py --baseline bench.json         # compare, exit 1 on regressions
+    cycle_bench.py --config release --routine GPIO_writePin --csv
+
+cycles is the fastest of BENCH_RUNS calls and cycles_max the slowest, the
+marker overhead (the empty harness) taken off; the interrupts a driver takes
+during the call are counted, as on the target. stack is how deep the call
+went below its caller, return address and interrupt frames included. flash
+is the size of the routine's own function, flash_total what the image grows
+by over the empty harness: the routine, all it calls and the initialisation
+the benchmark needs. Needs avr-gcc, avr-ar, avr-size, avr-nm and simavr
+(headers and libsimavr, under --simavr).
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+CODE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "code")
+BENCH = os.path.join(CODE, "bench")
+
+F_CPU = 8000000
+
+# Flags of the Eclipse projects, the optimisation level comes from the configuration
+CFLAGS = ["-mmcu=atmega32", "-DF_CPU=%dUL" % F_CPU, "-std=gnu99", "-funsigned-char", "-funsigned-bitfields",
+          "-fpack-struct", "-fshort-enums", "-ffunction-sections", "-fdata-sections"]
+OPTIMIZE = {"debug": "-O0", "release": "-Os"}
+
+# The file holding main() of each ECU, left out of the benchmark images
+MAIN = {"Control_ECU": "control_ecu.c", "HMI_ECU": "main.c"}
+
+# name, ECU, BENCH_ROUTINE of code/bench/bench.h, function of the flash column
+ROUTINES = [
+    ("GPIO_writePin", "HMI_ECU", "BENCH_GPIO_WRITE_PIN", "GPIO_writePin"),
+    ("LCD_displayCharacter", "HMI_ECU", "BENCH_LCD_DISPLAY_CHARACTER", "LCD_displayCharacter"),
+    ("KEYPAD_scan", "HMI_ECU", "BENCH_KEYPAD_SCAN", "KEYPAD_getPressedKey"),
+    ("EEPROM_readByte", "Control_ECU", "BENCH_EEPROM_READ_BYTE", "EEPROM_readByte"),
+    ("UART_sendByte", "HMI_ECU", "BENCH_UART_SEND_BYTE", "UART_sendByte"),
+    ("UART_receiveByte", "HMI_ECU", "BENCH_UART_RECEIVE_BYTE", "UART_receiveByte"),
+    ("CredCache_verify", "Control_ECU", "BENCH_PASSWORD_COMPARE", "CredCache_verify"),
+]
+
+COLUMNS = ["routine", "ecu", "cycles", "cycles_max", "us", "stack", "flash", "flash_total"]
+
+
+def run(command):
+    result = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True)
+    if result.returncode != 0:
+        sys.exit("%s failed" % " ".join(command))
+    return result.stdout
+
+
+def build_library(ecu, args, flags, workdir):
+    """Archive of every source of the ECU but main(), the linker takes what a harness calls."""
+    source_dir = os.path.join(CODE, ecu)
+    objects = []
+    for source in sorted(glob.glob(os.path.join(source_dir, "*.c"))):
+        if os.path.basename(source) == MAIN[ecu]:
+            continue
+        target = os.path.join(workdir, ecu + "_" + os.path.basename(source)[:-2] + ".o")
+        run([args.cc] + CFLAGS + flags + ["-I", source_dir, "-c", source, "-o", target])
+        objects.append(target)
+    library = os.path.join(workdir, ecu + ".a")
+    run([args.ar, "rcs", library] + objects)
+    return library
+
+
+def build_harness(ecu, routine, library, args, flags, workdir):
+    source_dir = os.path.join(CODE, ecu)
+    name = os.path.join(workdir, "%s_%s" % (ecu, routine))
+    run([args.cc] + CFLAGS + flags + ["-DBENCH_ROUTINE=" + routine, "-I", source_dir, "-I", BENCH,
+                                      "-c", os.path.join(BENCH, "bench.c"), "-o", name + ".o"])
+    run([args.cc, "-mmcu=atmega32", "-Wl,--gc-sections", name + ".o", library, "-o", name + ".elf"])
+    return name + ".elf"
+
+
+def build_simulator(args, workdir):
+    simulator = os.path.join(workdir, "bench_sim")
+    run([args.host_cc, "-O2", "-I", os.path.join(args.simavr, "include", "simavr"), "-I", BENCH,
+         "-I", os.path.join(CODE, "HMI_ECU"), os.path.join(BENCH, "bench_sim.c"),
+         "-L", os.path.join(args.simavr, "lib"), "-lsimavr", "-lelf", "-o", simulator])
+    return simulator
+
+
+def flash_size(elf, args):
+    """.text plus .data, the bytes the image takes in flash."""
+    fields = run([args.size, "--format=berkeley", elf]).splitlines()[1].split()
+    return int(fields[0]) + int(fields[1])
+
+
+def symbol_size(elf, symbol, args):
+    for line in run([args.nm, "--size-sort", "-S", elf]).splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[3] == symbol:
+            return int(fields[1], 16)
+    return 0
+
+
+def simulate(simulator, elf):
+    """(cycles_min, cycles_max, stack) of the calls measured in the harness."""
+    cycles_min, cycles_max, stack, _ = run([simulator, elf]).split()
+    return int(cycles_min), int(cycles_max), int(stack)
+
+
+def measure(args):
+    flags = [OPTIMIZE[args.config]] + ["-D" + define for define in args.defines]
+    selected = [entry for entry in ROUTINES if not args.routine or entry[0] in args.routine]
+    rows = []
+    with tempfile.TemporaryDirectory() as workdir:
+        simulator = build_simulator(args, workdir)
+        for ecu in sorted({entry[1] for entry in selected}):
+            library = build_library(ecu, args, flags, workdir)
+            empty = build_harness(ecu, "BENCH_NONE", library, args, flags, workdir)
+            overhead = simulate(simulator, empty)[0]
+            empty_flash = flash_size(empty, args)
+            for name, _, routine, symbol in [entry for entry in selected if entry[1] == ecu]:
+                elf = build_harness(ecu, routine, library, args, flags, workdir)
+                cycles_min, cycles_max, stack = simulate(simulator, elf)
+                rows.append({
+                    "routine": name,
+                    "ecu": ecu,
+                    "cycles": cycles_min - overhead,
+                    "cycles_max": cycles_max - overhead,
+                    "us": round((cycles_min - overhead) * 1e6 / F_CPU, 1),
+                    "stack": stack,
+                    "flash": symbol_size(elf, symbol, args),
+                    "flash_total": flash_size(elf, args) - empty_flash,
+                })
+    order = [entry[0] for entry in ROUTINES]
+    rows.sort(key=lambda row: order.index(row["routine"]))
+    return rows
+
+
+def compare(rows, baseline, tolerance):
+    """Regressions against an earlier --json output: more cycles than the tolerance, more stack or flash."""
+    previous = {row["routine"]: row for row in baseline}
+    regressions = []
+    for row in rows:
+        old = previous.get(row["routine"])
+        if old is None:
+            continue
+        if row["cycles"] > old["cycles"] * (1 + tolerance / 100.0):
+            regressions.append("%s: cycles %d -> %d" % (row["routine"], old["cycles"], row["cycles"]))
+        for column in ("stack", "flash", "flash_total"):
+            if row[column] > old[column]:
+                regressions.append("%s: %s %d -> %d" % (row["routine"], column, old[column], row[column]))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--routine", action="append", choices=[entry[0] for entry in ROUTINES],
+                        help="routine to measure, all if omitted")
+    parser.add_argument("--config", choices=sorted(OPTIMIZE), default="debug",
+                        help="Eclipse configuration whose optimisation level is used")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        help="extra define, e.g. -D TRACE_ENABLED=1 for a tracing build")
+    output = parser.add_mutually_exclusive_group()
+    output.add_argument("--json", action="store_true", help="print the table as a JSON list")
+    output.add_argument("--csv", action="store_true", help="print the table as CSV")
+    parser.add_argument("--baseline", help="--json output of an earlier run to compare with")
+    parser.add_argument("--tolerance", type=float, default=1.0, help="cycle increase in %% not reported")
+    parser.add_argument("--cc", default=os.environ.get("CC", "avr-gcc"), help="compiler, avr-gcc by default")
+    parser.add_argument("--ar", default="avr-ar")
+    parser.add_argument("--size", default="avr-size")
+    parser.add_argument("--nm", default="avr-nm")
+    parser.add_argument("--host-cc", default="cc", help="compiler of the simulator")
+    parser.add_argument("--simavr", default="/usr", help="prefix simavr is installed under")
+    args = parser.parse_args()
+
+    rows = measure(args)
+    if args.json:
+        print(json.dumps(rows, indent=1))
+    elif args.csv:
+        writer = csv.DictWriter(sys.stdout, fieldnames=COLUMNS)
+        writer.writeheader()
+        writer.writerows(rows)
+    else:
+        print("%-22s %-12s %9s %10s %9s %6s %6s %11s" % tuple(COLUMNS))
+        for row in rows:
+            print("%-22s %-12s %9d %10d %9.1f %6d %6d %11d" % tuple(row[column] for column in COLUMNS))
+
+    if args.baseline:
+        with open(args.baseline) as baseline:
+            regressions = compare(rows, json.load(baseline), args.tolerance)
+        for regression in regressions:
+            print("regression: " + regression, file=sys.stderr)
+        if regressions:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Run both ECUs as Linux processes, their UARTs joined by a socketpair.
+
+Build them first with make -C code/host. The HMI takes its keys from a
+script (format in code/host/host.c, Host_parseKey): digits and + - * % =
+are keys, "enter" is Enter, "wait=MS" delays the next key. Both ECUs print
+their LCD, motor, buzzer and keys, one line each with the ECU time:
+
+    host_run.py --keys unlock.keys
+    host_run.py --keys unlock.keys --scale 4 --eeprom-dir state
+
+--eeprom-dir keeps the EEPROM files, the next run starts with the stored
+password; without it every run starts from erased EEPROMs. The run ends
+when the HMI has used up the script, the CONTROL_ECU then sees the link
+closed. The exit status is not zero when an ECU failed (watchdog reset,
+bad script) or --timeout expired.
+
+--restart-control SECONDS kills the CONTROL_ECU that many seconds of real
+time into the run and starts it again on the same link, as a reset of the
+target would; --restart-control can be given several times.
+
+--scale shortens the link timeouts in real time too: the 40 ms the HMI
+waits for the answer to SECLINK_HELLO are 4 ms at --scale 10, less than a
+busy host may take to switch processes, and the HMI keeps sending HELLO.
+Keep it at a few times real time.
+"""
+
+import argparse
+import os
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+BUILD = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "code", "host", "build")
+
+
+def start(name, program, uart, args, eeprom_dir, stdin):
+    env = dict(os.environ, HOST_NAME=name, HOST_UART="fd:%d" % uart.fileno(),
+               HOST_EEPROM=os.path.join(eeprom_dir, name + ".eeprom"),
+               HOST_TIME_SCALE=str(args.scale))
+    if name == "hmi" and args.keys:
+        env["HOST_KEYS"] = args.keys
+    return subprocess.Popen([program], env=env, pass_fds=[uart.fileno()], stdin=stdin)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--keys", help="keypad script of the HMI, standard input if omitted")
+    parser.add_argument("--scale", type=float, default=1.0, help="speed of the ECU clocks, 1 is real time")
+    parser.add_argument("--eeprom-dir", help="directory keeping the EEPROM files between runs")
+    parser.add_argument("--timeout", type=float, help="seconds of real time before both ECUs are stopped")
+    parser.add_argument("--restart-control", type=float, action="append", default=[], metavar="SECONDS",
+                        help="restart the CONTROL_ECU after SECONDS of real time")
+    parser.add_argument("--build", default=BUILD, help="directory of control_ecu and hmi_ecu")
+    args = parser.parse_args()
+
+    programs = [os.path.join(args.build, name) for name in ("control_ecu", "hmi_ecu")]
+    for program in programs:
+        if not os.access(program, os.X_OK):
+            sys.exit("%s missing, run make -C code/host" % program)
+
+    with tempfile.TemporaryDirectory() as scratch:
+        eeprom_dir = args.eeprom_dir or scratch
+        os.makedirs(eeprom_dir, exist_ok=True)
+        control_uart, hmi_uart = socket.socketpair()
+        control = start("control", programs[0], control_uart, args, eeprom_dir, subprocess.DEVNULL)
+        hmi = start("hmi", programs[1], hmi_uart, args, eeprom_dir,
+                    subprocess.DEVNULL if args.keys else None)
+        started = time.monotonic()
+        # Only the ECUs hold the link now, it closes when one of them ends. The end of
+        # the CONTROL_ECU is kept for its restarts, the HMI sees it close all the same.
+        hmi_uart.close()
+
+        try:
+            for restart in sorted(args.restart_control):
+                try:
+                    hmi.wait(timeout=max(0, started + restart - time.monotonic()))
+                    break
+                except subprocess.TimeoutExpired:
+                    control.kill()
+                    control.wait()
+                    print("control restarted", file=sys.stderr)
+                    control = start("control", programs[0], control_uart, args, eeprom_dir, subprocess.DEVNULL)
+            control_uart.close()
+            hmi.wait(timeout=args.timeout and max(0, started + args.timeout - time.monotonic()))
+            control.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            print("timeout, stopping the ECUs", file=sys.stderr)
+            for process in (hmi, control):
+                process.kill()
+                process.wait()
+            sys.exit(1)
+
+    failed = [name for name, process in (("hmi", hmi), ("control", control)) if process.returncode != 0]
+    if failed:
+        sys.exit("failed: %s" % ", ".join(failed))
+
+
+if __name__ == "__main__":
+    main()
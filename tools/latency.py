@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Unlock latency per stage, from the Enter key on the HMI to the motor start.
+
+Both ECUs keep the stage timestamps of their last password checks in
+their own clock (diagnostic command 0x0D, see code/Control_ECU/latency.h).
+The records are paired by their secure link frame count and the clocks
+aligned per record from the password and CONTROL_ECU_READY frames:
+
+    latency.py --hmi-port /dev/ttyUSB1 --control-port /dev/ttyUSB0
+    latency.py --hmi-input hmi.bin --control-input control.bin --history v1.4.jsonl
+    latency.py --history v1.5.jsonl --baseline v1.4.jsonl
+
+--history keeps every measurement in a file (records already in it are
+not added again) and reports on the whole file; --baseline compares the
+medians with the history of another release.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+from types import SimpleNamespace
+
+from link_frames import parse_frames, read_stream
+
+LINK_DIAG_LATENCY = 0x0D
+
+HMI_STAGES = ("key_enter", "password_sent", "reply_received", "door_shown")
+CONTROL_STAGES = ("password_received", "password_checked", "reply_sent", "motor_started")
+
+# Interval name, start stage and end stage, the stages of both ECUs are aligned
+INTERVALS = (
+    ("debounce and send", "key_enter", "password_sent"),
+    ("link to control", "password_sent", "password_received"),
+    ("password check", "password_received", "password_checked"),
+    ("reply", "password_checked", "reply_sent"),
+    ("door start", "reply_sent", "motor_started"),
+    ("enter to motor", "key_enter", "motor_started"),
+    ("enter to display", "key_enter", "door_shown"),
+)
+
+# Histogram bucket upper bounds in milliseconds
+BUCKETS = (1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000)
+
+
+def signed32(value):
+    value &= 0xFFFFFFFF
+    return value - 0x100000000 if value & 0x80000000 else value
+
+
+def load_records(stream, stages):
+    """Records of one dump, oldest first, as (key, {stage: microseconds})."""
+    frames = [data for _, data in parse_frames(stream, LINK_DIAG_LATENCY)]
+    if not frames or len(frames[0]) != 2 or frames[0][0] != len(stages):
+        sys.exit("no latency header frame for %d stages" % len(stages))
+    records = []
+    for data in frames[1:1 + frames[0][1]]:
+        key, *micros = struct.unpack("<H%dI" % len(stages), data)
+        records.append((key, {stage: value for stage, value in zip(stages, micros) if value}))
+    return records
+
+
+def pair(hmi_records, control_records):
+    """HMI and CONTROL records of the same password, the newest HMI record with the key wins."""
+    pairs = []
+    used = set()
+    for key, control in control_records:
+        for index in range(len(hmi_records) - 1, -1, -1):
+            if index not in used and hmi_records[index][0] == key:
+                used.add(index)
+                pairs.append((hmi_records[index][1], control))
+                break
+    return pairs
+
+
+def measure(hmi, control):
+    """Intervals in microseconds on the HMI timeline, None if the clocks cannot be aligned."""
+    sync = ("password_sent", "reply_received")
+    if not all(stage in hmi for stage in sync) or not all(stage in control for stage in
+                                                          ("password_received", "reply_sent")):
+        return None
+    # Offset of the CONTROL clock, the two frames take the same time on the line
+    offset = (signed32(control["password_received"] - hmi["password_sent"])
+              + signed32(control["reply_sent"] - hmi["reply_received"])) // 2
+    times = {}
+    base = hmi["password_sent"]
+    for stage, value in hmi.items():
+        times[stage] = signed32(value - base)
+    for stage, value in control.items():
+        times[stage] = signed32(value - base) - offset
+    result = {"offset_us": offset,
+              "round_trip_us": signed32(hmi["reply_received"] - hmi["password_sent"])
+              - signed32(control["reply_sent"] - control["password_received"])}
+    for name, start, end in INTERVALS:
+        if start in times and end in times:
+            result[name] = times[end] - times[start]
+    return result
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def histogram(values):
+    counts = [0] * (len(BUCKETS) + 1)
+    for value in values:
+        index = 0
+        while index < len(BUCKETS) and value / 1000.0 > BUCKETS[index]:
+            index += 1
+        counts[index] += 1
+    lines = []
+    for index, count in enumerate(counts):
+        if count == 0:
+            continue
+        label = "<= %d ms" % BUCKETS[index] if index < len(BUCKETS) else "> %d ms" % BUCKETS[-1]
+        lines.append("      %-10s %4d %s" % (label, count, "#" * max(1, 40 * count // len(values))))
+    return lines
+
+
+def report(measurements, baseline):
+    print("%d password checks" % len(measurements))
+    for name, _, _ in INTERVALS:
+        values = [entry[name] for entry in measurements if name in entry]
+        if not values:
+            continue
+        median = percentile(values, 0.5)
+        line = "  %-18s n=%-4d min %8.2f  median %8.2f  p90 %8.2f  max %8.2f ms" % (
+            name, len(values), min(values) / 1000.0, median / 1000.0,
+            percentile(values, 0.9) / 1000.0, max(values) / 1000.0)
+        old = [entry[name] for entry in baseline if name in entry]
+        if old:
+            line += "  (%+.2f ms vs baseline)" % ((median - percentile(old, 0.5)) / 1000.0)
+        print(line)
+        for histogram_line in histogram(values):
+            print(histogram_line)
+    round_trips = [entry["round_trip_us"] for entry in measurements]
+    if round_trips:
+        print("  link round trip median %.2f ms" % (percentile(round_trips, 0.5) / 1000.0))
+
+
+def read_history(path):
+    if not path or not os.path.exists(path):
+        return []
+    with open(path) as history:
+        return [json.loads(line) for line in history if line.strip()]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    for ecu in ("hmi", "control"):
+        source = parser.add_mutually_exclusive_group()
+        source.add_argument("--%s-port" % ecu, help="serial port wired to the link of the %s" % ecu.upper())
+        source.add_argument("--%s-input" % ecu, help="raw capture of its answer to request 0xD1 0x0D")
+    parser.add_argument("--history", help="file keeping the measurements, one JSON object per line")
+    parser.add_argument("--baseline", help="history file of an earlier release to compare with")
+    args = parser.parse_args()
+
+    measurements = read_history(args.history)
+    if args.hmi_port or args.hmi_input or args.control_port or args.control_input:
+        hmi_source = SimpleNamespace(input=args.hmi_input, port=args.hmi_port)
+        control_source = SimpleNamespace(input=args.control_input, port=args.control_port)
+        if not (hmi_source.input or hmi_source.port) or not (control_source.input or control_source.port):
+            parser.error("both ECUs are needed")
+        hmi_records = load_records(read_stream(hmi_source, LINK_DIAG_LATENCY), HMI_STAGES)
+        control_records = load_records(read_stream(control_source, LINK_DIAG_LATENCY), CONTROL_STAGES)
+        new = []
+        for hmi, control in pair(hmi_records, control_records):
+            entry = measure(hmi, control)
+            if entry is None:
+                continue
+            # The raw times identify a record read twice
+            entry["raw"] = [hmi.get(stage, 0) for stage in HMI_STAGES] + \
+                           [control.get(stage, 0) for stage in CONTROL_STAGES]
+            if all(entry["raw"] != old.get("raw") for old in measurements):
+                new.append(entry)
+        measurements += new
+        if args.history:
+            with open(args.history, "a") as history:
+                for entry in new:
+                    history.write(json.dumps(entry) + "\n")
+    elif not args.history:
+        parser.error("give the ports or captures of both ECUs, or a --history file")
+
+    report(measurements, read_history(args.baseline))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+"""Diagnostic link framing shared by the host tools.
+
+A maintenance tool plugged in place of the HMI_ECU (or of the Control_ECU,
+for the HMI_ECU) sends LINK_DIAG_REQUEST and a command byte; the ECU answers
+with frames:
+
+    LINK_FRAME_START, command, length, data, CRC-16/CCITT-FALSE (low byte first)
+
+See code/Control_ECU/link.h.
+"""
+
+import struct
+
+LINK_DIAG_REQUEST = 0xD1
+LINK_FRAME_START = 0xD2
+
+# Link settings of both ECUs: 9600 baud, 8 data bits, even parity, 1 stop bit
+BAUD_RATE = 9600
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def parse_frames(stream, command=None):
+    """Yield (command, data) for every frame with a good CRC in a byte string.
+
+    Bytes outside frames (secure link traffic) are skipped.
+    """
+    i = 0
+    while i + 5 <= len(stream):
+        if stream[i] != LINK_FRAME_START:
+            i += 1
+            continue
+        cmd, length = stream[i + 1], stream[i + 2]
+        end = i + 3 + length
+        if end + 2 > len(stream):
+            break
+        data = bytes(stream[i + 3:end])
+        (crc,) = struct.unpack_from("<H", stream, end)
+        if crc != crc16(bytes([cmd, length]) + data):
+            i += 1
+            continue
+        if command is None or cmd == command:
+            yield cmd, data
+        i = end + 2
+
+
+def open_port(name):
+    import serial  # pyserial, only needed to talk to a live ECU
+
+    return serial.Serial(name, BAUD_RATE, parity=serial.PARITY_EVEN, timeout=2)
+
+
+def request(port, command, arguments=b""):
+    """Send one diagnostic request and return the raw bytes until the line is quiet."""
+    port.reset_input_buffer()
+    port.write(bytes([LINK_DIAG_REQUEST, command]) + bytes(arguments))
+    received = bytearray()
+    while True:
+        chunk = port.read(256)
+        if not chunk:
+            return bytes(received)
+        received += chunk
+
+
+def read_stream(args, command):
+    """Bytes answering a request, from --port or from a capture file (--input)."""
+    if args.input:
+        with open(args.input, "rb") as capture:
+            return capture.read()
+    return request(open_port(args.port), command)
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Read the deferred-format log of an ECU and print it as text.
+
+The firmware must be a logging build (-DLOG_LEVEL=LOG_LEVEL_INFO or
+another level, see code/Control_ECU/log.h). It only stores a message id
+and the raw arguments; the format strings are taken from log_ids.h.
+
+    log.py --port /dev/ttyUSB0
+    log.py --input capture.bin --ids code/HMI_ECU/log_ids.h
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from link_frames import parse_frames, read_stream
+
+LINK_DIAG_LOG = 0x0B
+
+LOG_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                       "..", "code", "Control_ECU", "log_ids.h")
+
+LEVELS = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+
+# One printf conversion, length modifiers are dropped since every argument is 16-bit
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|l|ll)?([diuxXc%])")
+
+
+def load_formats(path):
+    formats = []
+    with open(path) as header:
+        for line in header:
+            match = re.match(r'^\s*X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', line)
+            if match:
+                formats.append(match.group(2))
+    if not formats:
+        sys.exit("no messages in %s" % path)
+    return formats
+
+
+def render(text, args):
+    """printf-style formatting of 16-bit arguments, %d and %i signed."""
+    args = list(args)
+
+    def convert(match):
+        flags, kind = match.groups()
+        if kind == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        if kind in "di":
+            value = value - 0x10000 if value & 0x8000 else value
+            kind = "d"
+        elif kind == "u":
+            kind = "d"
+        return ("%" + flags + kind) % value
+
+    line = CONVERSION.sub(convert, text)
+    if args:
+        line += " " + " ".join("0x%04x" % value for value in args)
+    return line
+
+
+def load_messages(stream):
+    """Messages of one dump as (milliseconds, level, id, args), and the dropped count."""
+    frames = [data for _, data in parse_frames(stream, LINK_DIAG_LOG)]
+    if not frames or len(frames[0]) != 6:
+        sys.exit("no log header frame, is the firmware a logging build?")
+    now, dropped = struct.unpack("<IH", frames[0])
+    messages = []
+    for data in frames[1:]:
+        if not data:
+            break
+        i = 0
+        while i + 4 <= len(data):
+            message, info, millis = struct.unpack_from("<BBH", data, i)
+            count = info & 0x0F
+            args = struct.unpack_from("<%dH" % count, data, i + 4)
+            i += 4 + 2 * count
+            # Only the low 16 bits are stored, go back from the time of the dump
+            delta = (now - millis) & 0xFFFF
+            if delta >= 0x8000:
+                delta -= 0x10000
+            messages.append((now - delta, info >> 4, message, args))
+    return messages, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port wired to the ECU link")
+    source.add_argument("--input", help="raw capture of the answer to request 0xD1 0x0B")
+    parser.add_argument("--ids", default=LOG_IDS, help="log_ids.h of the running build")
+    args = parser.parse_args()
+
+    formats = load_formats(args.ids)
+    messages, dropped = load_messages(read_stream(args, LINK_DIAG_LOG))
+    for millis, level, message, values in messages:
+        if message < len(formats):
+            text = render(formats[message], values)
+        else:
+            text = "unknown message %d: %s" % (message, " ".join("0x%04x" % value for value in values))
+        print("%10.3f  %-5s  %s" % (millis / 1000.0, LEVELS.get(level, "L%d" % level), text))
+    if dropped:
+        print("%d messages dropped, the log buffer was full" % dropped)
+
+
+if __name__ == "__main__":
+    main()
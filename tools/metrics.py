@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Read the counters and gauges of an ECU.
+
+One request (diagnostic command 0x0E) returns every metric listed in
+code/Control_ECU/metric_ids.h in a single frame:
+
+    metrics.py --port /dev/ttyUSB0
+    metrics.py --port /dev/ttyUSB0 --json            # one JSON object, for monitoring
+    metrics.py --port /dev/ttyUSB0 --interval 10     # poll, counters as increments
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+import time
+
+from link_frames import open_port, parse_frames, read_stream, request
+
+LINK_DIAG_METRICS = 0x0E
+
+METRIC_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                          "..", "code", "Control_ECU", "metric_ids.h")
+
+
+def load_ids(path):
+    """(name, kind) per metric, in the order of METRIC_ID_LIST."""
+    metrics = []
+    with open(path) as header:
+        for line in header:
+            match = re.match(r'^\s*X\(\s*(\w+)\s*,\s*(COUNTER|GAUGE)\s*,\s*"([^"]*)"\s*\)', line)
+            if match:
+                metrics.append((match.group(3), match.group(2).lower()))
+    if not metrics:
+        sys.exit("no metrics in %s" % path)
+    return metrics
+
+
+def load_snapshot(stream, metrics):
+    frames = [data for _, data in parse_frames(stream, LINK_DIAG_METRICS)]
+    if not frames or not frames[0] or len(frames[0]) != 1 + 2 * frames[0][0]:
+        sys.exit("no metrics frame")
+    values = struct.unpack("<%dH" % frames[0][0], frames[0][1:])
+    snapshot = {}
+    for index, value in enumerate(values):
+        name = metrics[index][0] if index < len(metrics) else "metric %d" % index
+        snapshot[name] = value
+    return snapshot
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port wired to the ECU link")
+    source.add_argument("--input", help="raw capture of the answer to request 0xD1 0x0E")
+    parser.add_argument("--ids", default=METRIC_IDS, help="metric_ids.h of the running build")
+    parser.add_argument("--json", action="store_true", help="print one JSON object per snapshot")
+    parser.add_argument("--interval", type=float, help="poll every INTERVAL seconds (--port only)")
+    args = parser.parse_args()
+
+    metrics = load_ids(args.ids)
+    kinds = dict(metrics)
+    if args.interval is None or args.input:
+        snapshots = [load_snapshot(read_stream(args, LINK_DIAG_METRICS), metrics)]
+    else:
+        port = open_port(args.port)
+        snapshots = None
+
+    previous = None
+    while True:
+        snapshot = snapshots.pop(0) if snapshots is not None else \
+            load_snapshot(request(port, LINK_DIAG_METRICS), metrics)
+        if args.json:
+            print(json.dumps(dict(snapshot, time=time.time())), flush=True)
+        else:
+            for name, value in snapshot.items():
+                line = "%-24s %-7s %6d" % (name, kinds.get(name, "?"), value)
+                if previous is not None and kinds.get(name) == "counter":
+                    line += "  %+d" % ((value - previous[name]) & 0xFFFF)
+                print(line)
+            print(flush=True)
+        previous = snapshot
+        if snapshots is not None:
+            return
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Read the sampling profiler histogram of an ECU and map it to functions.
+
+The firmware must be a profiling build (-DPROFILER_ENABLED=1, see
+code/Control_ECU/profiler.h). Symbols come from the .elf (through avr-nm)
+or from the .map of the same build, e.g. code/HMI_ECU/Debug/HMI_ECU.map.
+
+    profile.py --port /dev/ttyUSB0 --symbols code/HMI_ECU/Debug/HMI_ECU.elf
+    profile.py --input capture.bin --symbols code/Control_ECU/Debug/Control_ECU.map
+
+A bucket holding several functions shares its samples between them in
+proportion to the bytes of each in the bucket. Rebuild with a smaller
+PROFILER_BUCKET_SHIFT and a PROFILER_BASE near a hot spot to zoom in.
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+
+from link_frames import parse_frames, read_stream
+
+LINK_DIAG_PROFILE = 0x09
+
+# Data addresses in AVR .map/.elf files are offset by 0x800000
+FLASH_LIMIT = 0x800000
+
+
+def load_histogram(stream):
+    frames = [data for _, data in parse_frames(stream, LINK_DIAG_PROFILE)]
+    if not frames or len(frames[0]) != 12:
+        sys.exit("no profiler header frame, is the firmware a profiling build?")
+    base, shift, count, samples, outside = struct.unpack("<HBBII", frames[0])
+    buckets = [0] * count
+    for data in frames[1:]:
+        if not data:
+            break
+        first = data[0]
+        for j, (value,) in enumerate(struct.iter_unpack("<H", data[1:])):
+            buckets[first + j] = value
+    return base, 1 << shift, buckets, samples, outside
+
+
+def symbols_from_elf(path):
+    nm = os.environ.get("NM", "avr-nm")
+    output = subprocess.run([nm, "--numeric-sort", "--print-size", path],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in "tTwW":
+            symbols.append((int(fields[0], 16), int(fields[1], 16), fields[3]))
+    return symbols
+
+
+def symbols_from_map(path):
+    """Function start addresses of the .text output section, sizes inferred from the next one."""
+    starts = {}
+    in_text = False
+    with open(path) as mapfile:
+        for line in mapfile:
+            if line.startswith(".text"):
+                in_text = True
+            elif in_text and re.match(r"^\.\w", line):
+                in_text = False
+            if not in_text:
+                continue
+            match = re.match(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$", line)
+            if match:
+                address = int(match.group(1), 16)
+                if address < FLASH_LIMIT:
+                    starts.setdefault(address, match.group(2))
+    ordered = sorted(starts.items())
+    symbols = []
+    for i, (address, name) in enumerate(ordered):
+        end = ordered[i + 1][0] if i + 1 < len(ordered) else address + 2
+        symbols.append((address, end - address, name))
+    return symbols
+
+
+def attribute(base, bucket_size, buckets, symbols):
+    totals = {}
+    for index, count in enumerate(buckets):
+        if count == 0:
+            continue
+        low = base + index * bucket_size
+        high = low + bucket_size
+        overlaps = []
+        for address, size, name in symbols:
+            overlap = min(high, address + size) - max(low, address)
+            if overlap > 0:
+                overlaps.append((name, overlap))
+        covered = sum(overlap for _, overlap in overlaps)
+        if covered == 0:
+            totals["<0x%04x-0x%04x>" % (low, high)] = totals.get("<0x%04x-0x%04x>" % (low, high), 0) + count
+            continue
+        for name, overlap in overlaps:
+            totals[name] = totals.get(name, 0) + count * overlap / covered
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port wired to the ECU link")
+    source.add_argument("--input", help="raw capture of the answer to request 0xD1 0x09")
+    parser.add_argument("--symbols", required=True, help=".elf or .map of the running build")
+    parser.add_argument("--top", type=int, default=25, help="number of functions listed")
+    args = parser.parse_args()
+
+    base, bucket_size, buckets, samples, outside = load_histogram(read_stream(args, LINK_DIAG_PROFILE))
+    if args.symbols.endswith(".elf"):
+        symbols = symbols_from_elf(args.symbols)
+    else:
+        symbols = symbols_from_map(args.symbols)
+
+    totals = attribute(base, bucket_size, buckets, symbols)
+    print("%d samples, %d outside 0x%04x-0x%04x, %d-byte buckets"
+          % (samples, outside, base, base + bucket_size * len(buckets), bucket_size))
+    print("%8s %7s  %s" % ("samples", "share", "function"))
+    for name, count in sorted(totals.items(), key=lambda item: -item[1])[:args.top]:
+        print("%8.1f %6.2f%%  %s" % (count, 100.0 * count / max(samples, 1), name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Provision the Control_ECU from a maintenance tool plugged in place of the HMI_ECU.
+
+The tool runs the secure link handshake in place of the HMI_ECU, with the
+pairing key of the installation (SECLINK_PAIRING_KEY of seclink.h unless
+--pairing-key is given), so the password and PINs never travel in clear.
+Every command starts with the system password, checked by the Control_ECU
+before anything is stored; a refused request is recorded in the audit log,
+and after as many wrong passwords as the keypad allows the Control_ECU
+refuses provisioning until it is reset.
+
+    provision.py --port /dev/ttyUSB0 --password 12345 user-add 24680 --role user
+    provision.py --port /dev/ttyUSB0 --password 12345 user-revoke 17
+    provision.py --port /dev/ttyUSB0 --password 12345 profile-save 1 \
+        --segment cw:100:20:C7=0 --segment stop:0:5 --segment acw:100:20:C6=0
+    provision.py --port /dev/ttyUSB0 --password 12345 profile-select 1
+
+user-add prints the table slot of the new user, the slot user-revoke takes
+and the audit log reports. A door profile segment is direction:duty:ticks,
+optionally followed by :PORTPIN=LEVEL, the limit switch input that ends it
+early (pins of the UART, TWI bus, motor and buzzer are refused). See
+code/Control_ECU/link.h for the requests.
+"""
+
+import argparse
+import sys
+
+from link_frames import open_port
+from seclink import Session, pairing_key
+
+LINK_PROVISION_REQUEST = 0xD3
+LINK_PROVISION_USER_ADD = 0x0F
+LINK_PROVISION_USER_REVOKE = 0x10
+LINK_PROVISION_PROFILE_SAVE = 0x11
+LINK_PROVISION_PROFILE_SELECT = 0x12
+
+# std_types.h
+SUCCESS = 1
+
+# CredStore_RoleType of credential_store.h
+ROLES = {"user": 1, "admin": 2}
+
+PIN_LENGTH = 5
+
+# DcMotor_State of dc_motor.h
+DIRECTIONS = {"stop": 0, "cw": 1, "acw": 2}
+
+# door_sequencer.h
+DOOR_MAX_SEGMENTS = 6
+DOOR_END_NONE = 0xFF
+
+
+def digits(text):
+    """Keypad digits of a PIN or password, as the HMI_ECU sends them."""
+    if len(text) != PIN_LENGTH or not text.isdigit():
+        raise argparse.ArgumentTypeError("%d digits expected" % PIN_LENGTH)
+    return bytes(int(digit) for digit in text)
+
+
+def segment(text):
+    """direction:duty:ticks[:PORTPIN=LEVEL] as the 4 bytes of a DoorSeq_SegmentType."""
+    fields = text.split(":")
+    try:
+        if len(fields) not in (3, 4) or fields[0] not in DIRECTIONS:
+            raise ValueError
+        duty, ticks = int(fields[1]), int(fields[2])
+        if not 0 <= duty <= 100 or not 1 <= ticks <= 255:
+            raise ValueError
+        end = DOOR_END_NONE
+        if len(fields) == 4:
+            pin, level = fields[3].upper().split("=")
+            if len(pin) != 2 or pin[0] not in "ABCD" or pin[1] not in "01234567" or level not in ("0", "1"):
+                raise ValueError
+            # DOOR_END_ON_PIN()
+            end = (int(level) << 6) | ("ABCD".index(pin[0]) << 3) | int(pin[1])
+    except ValueError:
+        raise argparse.ArgumentTypeError("direction:duty:ticks[:PORTPIN=LEVEL] expected, e.g. cw:100:15:C7=0")
+    return bytes([DIRECTIONS[fields[0]], duty, ticks, end])
+
+
+def answer(session, command, arguments):
+    """Data of the answer message, after its SUCCESS/ERROR byte; exit on ERROR."""
+    session.send(bytes([LINK_PROVISION_REQUEST, command]) + arguments)
+    try:
+        # Step messages meant for the HMI_ECU may come first
+        while True:
+            message = session.receive()
+            if message[:2] == bytes([LINK_PROVISION_REQUEST, command]) and len(message) >= 3:
+                break
+    except TimeoutError:
+        sys.exit("no answer (the Control_ECU only serves requests while it waits for the HMI_ECU)")
+    if message[2] != SUCCESS:
+        sys.exit("refused (wrong password, provisioning locked, or the request is invalid)")
+    return message[3:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", required=True, help="serial port wired to the Control_ECU link")
+    parser.add_argument("--password", required=True, type=digits, help="system password")
+    parser.add_argument("--pairing-key", help="pairing key of the installation, 32 hex digits")
+    commands = parser.add_subparsers(dest="command", required=True)
+    add = commands.add_parser("user-add", help="add a user with its own PIN")
+    add.add_argument("pin", type=digits)
+    add.add_argument("--role", choices=sorted(ROLES), default="user")
+    revoke = commands.add_parser("user-revoke", help="revoke the user of a table slot")
+    revoke.add_argument("slot", type=int)
+    save = commands.add_parser("profile-save", help="store a door profile in a profile slot")
+    save.add_argument("slot", type=int)
+    save.add_argument("--segment", type=segment, action="append", required=True,
+                      help="one segment of the door cycle, in order")
+    select = commands.add_parser("profile-select", help="run the door profile of a slot from the next cycle on")
+    select.add_argument("slot", type=int)
+    args = parser.parse_args()
+    if args.command == "profile-save" and len(args.segment) > DOOR_MAX_SEGMENTS:
+        parser.error("at most %d segments" % DOOR_MAX_SEGMENTS)
+
+    session = Session(open_port(args.port), pairing_key(args.pairing_key))
+    if args.command == "user-add":
+        data = answer(session, LINK_PROVISION_USER_ADD, args.password + args.pin + bytes([ROLES[args.role]]))
+        print("slot %d" % data[0])
+    elif args.command == "user-revoke":
+        answer(session, LINK_PROVISION_USER_REVOKE, args.password + bytes([args.slot]))
+        print("revoked")
+    elif args.command == "profile-save":
+        answer(session, LINK_PROVISION_PROFILE_SAVE, args.password + bytes([args.slot, len(args.segment)]) + b"".join(args.segment))
+        print("saved")
+    elif args.command == "profile-select":
+        answer(session, LINK_PROVISION_PROFILE_SELECT, args.password + bytes([args.slot]))
+        print("selected")
+
+
+if __name__ == "__main__":
+    main()
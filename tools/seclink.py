@@ -0,0 +1,161 @@
+"""Secure link client shared by the host tools that act as the HMI_ECU.
+
+A maintenance tool plugged in place of the HMI_ECU runs the handshake of
+code/Control_ECU/seclink.h with the pairing key of the installation, then
+exchanges encrypted and authenticated messages with the Control_ECU:
+
+    HMI     -> CONTROL: SECLINK_HELLO, 8-byte nonce
+    CONTROL -> HMI:     SECLINK_REPLY, 8-byte nonce
+    CONTROL -> HMI:     frame holding SECLINK_CONFIRM
+    then frames:        SECLINK_FRAME_START, length, ciphertext, tag
+
+Speck64/128 runs in counter mode for the ciphertext and as a CBC-MAC for the
+tag and the key derivation, exactly as speck.c and seclink.c do it.
+"""
+
+import os
+import re
+import struct
+
+SECLINK_HELLO = 0xA0
+SECLINK_REPLY = 0xA1
+SECLINK_CONFIRM = 0xA4
+SECLINK_FRAME_START = 0xA5
+
+SECLINK_NONCE_SIZE = 8
+SECLINK_TAG_SIZE = 4
+
+SECLINK_ROLE_HMI = ord("H")
+SECLINK_ROLE_CONTROL = ord("C")
+
+SPECK_ROUNDS = 27
+BLOCK_SIZE = 8
+
+# Handshakes tried before giving up, the HMI_ECU also sends HELLO again when no REPLY comes
+HANDSHAKE_ATTEMPTS = 3
+
+SECLINK_HEADER = os.path.join(os.path.dirname(__file__), "..", "code", "Control_ECU", "seclink.h")
+
+MASK = 0xFFFFFFFF
+
+
+def _rotr8(x):
+    return ((x >> 8) | (x << 24)) & MASK
+
+
+def _rotl3(x):
+    return ((x << 3) | (x >> 29)) & MASK
+
+
+class Speck:
+    """Speck64/128 encryption, little-endian words as on the ECUs."""
+
+    def __init__(self, key):
+        k, *l = struct.unpack("<4I", key)
+        self.round_keys = []
+        for i in range(SPECK_ROUNDS):
+            self.round_keys.append(k)
+            l[i % 3] = ((k + _rotr8(l[i % 3])) & MASK) ^ i
+            k = _rotl3(k) ^ l[i % 3]
+
+    def encrypt(self, block):
+        y, x = struct.unpack("<2I", block)
+        for round_key in self.round_keys:
+            x = ((_rotr8(x) + y) & MASK) ^ round_key
+            y = _rotl3(y) ^ x
+        return struct.pack("<2I", y, x)
+
+
+def _header(counter, sender, context):
+    return struct.pack("<IBBxx", counter, sender, context)
+
+
+def pairing_key(text=None):
+    """The pairing key as hex text, or SECLINK_PAIRING_KEY of seclink.h."""
+    if text:
+        return bytes.fromhex(text)
+    with open(SECLINK_HEADER) as header:
+        match = re.search(r"#define\s+SECLINK_PAIRING_KEY\s+\{([^}]*)\}", header.read())
+    return bytes(int(byte, 16) for byte in match.group(1).split(","))
+
+
+class Session:
+    """One secure link session with the Control_ECU, the tool taking the HMI role."""
+
+    def __init__(self, port, key):
+        self.port = port
+        self.key = key
+        self.tx_counter = 0
+        self.rx_counter = 0
+        for _ in range(HANDSHAKE_ATTEMPTS):
+            if self._handshake():
+                return
+        raise IOError("no secure link session (Control_ECU not answering or wrong pairing key)")
+
+    def _read(self):
+        byte = self.port.read(1)
+        if not byte:
+            raise TimeoutError
+        return byte[0]
+
+    def _handshake(self):
+        hmi_nonce = os.urandom(SECLINK_NONCE_SIZE)
+        self.port.reset_input_buffer()
+        self.port.write(bytes([SECLINK_HELLO]) + hmi_nonce)
+        try:
+            while self._read() != SECLINK_REPLY:
+                pass
+            control_nonce = bytes(self._read() for _ in range(SECLINK_NONCE_SIZE))
+        except TimeoutError:
+            return False
+        self._derive_keys(hmi_nonce, control_nonce)
+        try:
+            return self.receive() == bytes([SECLINK_CONFIRM])
+        except TimeoutError:
+            return False
+
+    def _derive_keys(self, hmi_nonce, control_nonce):
+        cipher = Speck(self.key)
+        outputs = []
+        for i in range(4):
+            block = cipher.encrypt(bytes([i]) + bytes(BLOCK_SIZE - 1))
+            block = cipher.encrypt(bytes(a ^ b for a, b in zip(block, hmi_nonce)))
+            block = cipher.encrypt(bytes(a ^ b for a, b in zip(block, control_nonce)))
+            outputs.append(block)
+        self.enc = Speck(outputs[0] + outputs[1])
+        self.mac = Speck(outputs[2] + outputs[3])
+        self.tx_counter = 0
+        self.rx_counter = 0
+
+    def _crypt(self, counter, sender, data):
+        out = bytearray()
+        for i in range(0, len(data), BLOCK_SIZE):
+            stream = self.enc.encrypt(_header(counter, sender, i // BLOCK_SIZE))
+            out += bytes(a ^ b for a, b in zip(data[i:i + BLOCK_SIZE], stream))
+        return bytes(out)
+
+    def _tag(self, counter, sender, data):
+        block = self.mac.encrypt(_header(counter, sender, len(data)))
+        for i in range(0, len(data), BLOCK_SIZE):
+            chunk = data[i:i + BLOCK_SIZE].ljust(BLOCK_SIZE, b"\0")
+            block = self.mac.encrypt(bytes(a ^ b for a, b in zip(block, chunk)))
+        return block[:SECLINK_TAG_SIZE]
+
+    def send(self, message):
+        ciphertext = self._crypt(self.tx_counter, SECLINK_ROLE_HMI, message)
+        tag = self._tag(self.tx_counter, SECLINK_ROLE_HMI, ciphertext)
+        self.tx_counter += 1
+        self.port.write(bytes([SECLINK_FRAME_START, len(message)]) + ciphertext + tag)
+
+    def receive(self):
+        """Next message of the Control_ECU; bytes outside frames are skipped, a bad tag raises."""
+        while self._read() != SECLINK_FRAME_START:
+            pass
+        length = self._read()
+        ciphertext = bytes(self._read() for _ in range(length))
+        tag = bytes(self._read() for _ in range(SECLINK_TAG_SIZE))
+        if tag != self._tag(self.rx_counter, SECLINK_ROLE_CONTROL, ciphertext):
+            raise IOError("secure link frame failing the tag")
+        message = self._crypt(self.rx_counter, SECLINK_ROLE_CONTROL, ciphertext)
+        self.rx_counter += 1
+        return message
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Static stack usage per function of both ECU targets.
+
+Every .c file of an ECU is compiled with the flags of the Eclipse build
+(Debug configuration by default, -O0) plus -fstack-usage, and the .su
+files are listed, largest frame first:
+
+    stack_usage.py                       # both ECUs, avr-gcc from PATH
+    stack_usage.py --ecu HMI_ECU --config release --top 15
+    stack_usage.py --su-dir code/Control_ECU/Debug
+
+--su-dir reads the .su files of an existing build instead (add
+-fstack-usage to the compiler flags of the Eclipse project to get them).
+The frames do not include the calls below them: the worst case of a path
+is the sum of its frames, plus the largest interrupt frame since the ISRs
+run on the same stack. Compare with the high-water mark of a running ECU
+(diagnostic command 0x0C, see code/Control_ECU/ram_usage.h).
+"""
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+
+CODE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "code")
+
+ECUS = ("Control_ECU", "HMI_ECU")
+
+# Flags of the Eclipse projects, the optimisation level comes from the configuration
+CFLAGS = ["-mmcu=atmega32", "-DF_CPU=8000000UL", "-std=gnu99", "-funsigned-char", "-funsigned-bitfields",
+          "-fpack-struct", "-fshort-enums", "-ffunction-sections", "-fdata-sections"]
+OPTIMIZE = {"debug": "-O0", "release": "-Os"}
+
+
+def compile_ecu(ecu, cc, flags, workdir):
+    """Compile the sources of one ECU into workdir, return the .su files."""
+    source_dir = os.path.join(CODE, ecu)
+    for source in sorted(glob.glob(os.path.join(source_dir, "*.c"))):
+        target = os.path.join(workdir, os.path.basename(source)[:-2] + ".o")
+        command = [cc] + CFLAGS + flags + ["-fstack-usage", "-I", source_dir, "-c", source, "-o", target]
+        if subprocess.run(command).returncode != 0:
+            sys.exit("%s failed" % " ".join(command))
+    return sorted(glob.glob(os.path.join(workdir, "*.su")))
+
+
+def read_su(paths):
+    """(function, file, bytes, qualifier) for every line of the .su files."""
+    entries = []
+    for path in paths:
+        with open(path) as su:
+            for line in su:
+                fields = line.rstrip("\n").split("\t")
+                if len(fields) != 3:
+                    continue
+                location, size, qualifier = fields
+                parts = location.split(":")
+                entries.append((parts[-1], os.path.basename(parts[0]), int(size), qualifier))
+    return entries
+
+
+def report(ecu, entries, top):
+    entries.sort(key=lambda entry: -entry[2])
+    isrs = [entry for entry in entries if entry[0].startswith("__vector_")]
+    print("%s: %d functions" % (ecu, len(entries)))
+    print("%6s  %-9s  %-28s %s" % ("bytes", "kind", "function", "file"))
+    for function, filename, size, qualifier in entries[:top]:
+        print("%6d  %-9s  %-28s %s" % (size, qualifier, function, filename))
+    if isrs:
+        print("largest interrupt frame: %d bytes (%s)" % (isrs[0][2], isrs[0][0]))
+    dynamic = [entry[0] for entry in entries if entry[3] != "static"]
+    if dynamic:
+        print("not fixed at compile time: %s" % ", ".join(dynamic))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--ecu", choices=ECUS, action="append", help="ECU to report, both if omitted")
+    parser.add_argument("--cc", default=os.environ.get("CC", "avr-gcc"), help="compiler, avr-gcc by default")
+    parser.add_argument("--config", choices=sorted(OPTIMIZE), default="debug",
+                        help="Eclipse configuration whose optimisation level is used")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        help="extra define, e.g. -D TRACE_ENABLED=1 for a tracing build")
+    parser.add_argument("--su-dir", help="read the .su files of this directory instead of compiling")
+    parser.add_argument("--top", type=int, default=25, help="number of functions listed")
+    args = parser.parse_args()
+
+    flags = [OPTIMIZE[args.config]] + ["-D" + define for define in args.defines]
+    if args.su_dir:
+        report(os.path.basename(os.path.normpath(args.su_dir)),
+               read_su(sorted(glob.glob(os.path.join(args.su_dir, "*.su")))), args.top)
+        return
+    for ecu in args.ecu or ECUS:
+        with tempfile.TemporaryDirectory() as workdir:
+            report(ecu, read_su(compile_ecu(ecu, args.cc, flags, workdir)), args.top)
+
+
+if __name__ == "__main__":
+    main()
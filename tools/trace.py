@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Turn the event trace rings of the ECUs into a Chrome trace.
+
+The firmware must be a tracing build (-DTRACE_ENABLED=1, see
+code/Control_ECU/trace.h). Each ECU is read with its own request, either
+live or from a raw capture, and becomes one process of the trace:
+
+    trace.py --port control=/dev/ttyUSB0 --port hmi=/dev/ttyUSB1 -o trace.json
+    trace.py --input control=control.bin --input hmi=hmi.bin -o trace.json \
+        --latency-input control=control_lat.bin --latency-input hmi=hmi_lat.bin
+
+Open the result in chrome://tracing or https://ui.perfetto.dev. Times are
+microseconds since the boot of the HMI. When both ECUs are named hmi and
+control, the CONTROL clock is moved onto the HMI clock with the offset
+latency.py finds for their last password check (diagnostic command 0x0D,
+read from the ports or from --latency-input captures). Without a password
+check since boot each ECU keeps its own clock. Event names come from
+code/Control_ECU/trace_ids.h.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+from types import SimpleNamespace
+
+import latency
+from link_frames import parse_frames, read_stream
+
+LINK_DIAG_TRACE = 0x0A
+
+# Timer2 counts in 8 us steps at 8 MHz (prescaler 64)
+MICROS_PER_TICK = 8
+
+TRACE_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         "..", "code", "Control_ECU", "trace_ids.h")
+
+PHASES = {"B": "B", "E": "E", "I": "i"}
+
+
+def load_ids(path):
+    """(name, phase) per id, in the order of TRACE_ID_LIST."""
+    events = []
+    with open(path) as header:
+        for line in header:
+            match = re.match(r'^\s*X\(\s*(\w+)\s*,\s*([BEI])\s*,\s*"([^"]*)"\s*\)', line)
+            if match:
+                events.append((match.group(3), PHASES[match.group(2)]))
+    if not events:
+        sys.exit("no events in %s" % path)
+    return events
+
+
+def load_records(stream):
+    """Records of one dump as (microseconds, id, arg), and the dropped count."""
+    frames = [data for _, data in parse_frames(stream, LINK_DIAG_TRACE)]
+    if not frames or len(frames[0]) != 8:
+        sys.exit("no trace header frame, is the firmware a tracing build?")
+    now, now_ticks, count, dropped = struct.unpack("<IBBH", frames[0])
+    records = []
+    for data in frames[1:]:
+        if not data:
+            break
+        for millis, ticks, event, arg in struct.iter_unpack("<HBBH", data):
+            # Only the low 16 bits are stored, go back from the time of the dump.
+            # Records added while the dump runs are slightly after it.
+            delta = (now - millis) & 0xFFFF
+            if delta >= 0x8000:
+                delta -= 0x10000
+            micros = (now - delta) * 1000 + ticks * MICROS_PER_TICK
+            records.append((micros, event, arg))
+    if len(records) != count:
+        print("warning: %d records announced, %d received" % (count, len(records)), file=sys.stderr)
+    return records, dropped
+
+
+def clock_offset(hmi_stream, control_stream):
+    """Microseconds to take off the CONTROL times, from the last password check of both latency dumps."""
+    hmi_records = latency.load_records(hmi_stream, latency.HMI_STAGES)
+    control_records = latency.load_records(control_stream, latency.CONTROL_STAGES)
+    for hmi, control in reversed(latency.pair(hmi_records, control_records)):
+        entry = latency.measure(hmi, control)
+        if entry is not None:
+            return entry["offset_us"]
+    return None
+
+
+def to_events(pid, label, records, ids):
+    events = [{"ph": "M", "name": "process_name", "pid": pid, "tid": 0, "args": {"name": label}}]
+    for micros, event, arg in records:
+        if event < len(ids):
+            name, phase = ids[event]
+        else:
+            name, phase = "id %d" % event, "i"
+        entry = {"name": name, "ph": phase, "ts": micros, "pid": pid, "tid": 0, "args": {"arg": arg}}
+        if phase == "i":
+            entry["s"] = "p"
+        events.append(entry)
+    return events
+
+
+def parse_source(text):
+    label, sep, source = text.partition("=")
+    if not sep or not label or not source:
+        raise argparse.ArgumentTypeError("expected NAME=SOURCE, got %r" % text)
+    return label, source
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=parse_source, action="append", default=[],
+                        help="NAME=serial port wired to the link of one ECU")
+    parser.add_argument("--input", type=parse_source, action="append", default=[],
+                        help="NAME=raw capture of the answer to request 0xD1 0x0A")
+    parser.add_argument("--latency-input", type=parse_source, action="append", default=[],
+                        help="NAME=raw capture of the answer to request 0xD1 0x0D, to align the clocks")
+    parser.add_argument("--ids", default=TRACE_IDS, help="trace_ids.h of the running builds")
+    parser.add_argument("-o", "--output", help="trace file, standard output if omitted")
+    args = parser.parse_args()
+
+    sources = [(label, SimpleNamespace(input=None, port=port)) for label, port in args.port]
+    sources += [(label, SimpleNamespace(input=path, port=None)) for label, path in args.input]
+    if not sources:
+        parser.error("give at least one --port or --input")
+
+    ids = load_ids(args.ids)
+    dumps = []
+    for label, source in sources:
+        records, dropped = load_records(read_stream(source, LINK_DIAG_TRACE))
+        if dropped:
+            print("%s: the ring was full, %d later records were dropped" % (label, dropped), file=sys.stderr)
+        dumps.append((label, records))
+
+    # The latency records come from the same sources, or from their own captures
+    latency_sources = dict((label, SimpleNamespace(input=None, port=port)) for label, port in args.port)
+    latency_sources.update((label, SimpleNamespace(input=path, port=None)) for label, path in args.latency_input)
+    if "hmi" in latency_sources and "control" in latency_sources and \
+            {"hmi", "control"} <= {label for label, _ in dumps}:
+        offset = clock_offset(read_stream(latency_sources["hmi"], latency.LINK_DIAG_LATENCY),
+                              read_stream(latency_sources["control"], latency.LINK_DIAG_LATENCY))
+        if offset is None:
+            print("no password check in both latency dumps, the clocks are not aligned", file=sys.stderr)
+        else:
+            print("control clock %+.3f ms from the hmi clock" % (offset / 1000.0), file=sys.stderr)
+            dumps = [(label, [(micros - offset, event, arg) for micros, event, arg in records]
+                      if label == "control" else records) for label, records in dumps]
+
+    events = []
+    for pid, (label, records) in enumerate(dumps, 1):
+        events += to_events(pid, label, records, ids)
+
+    trace = json.dumps({"traceEvents": events, "displayTimeUnit": "ms"}, indent=1)
+    if args.output:
+        with open(args.output, "w") as output:
+            output.write(trace + "\n")
+    else:
+        print(trace)
+
+
+if __name__ == "__main__":
+    main()